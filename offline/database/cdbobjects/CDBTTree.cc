@@ -19,6 +19,7 @@
 #include <limits>   // for numeric_limits, numeric_limits<>::max_digits10
 #include <set>      // for set
 #include <utility>  // for pair, make_pair
+#include <vector>
 
 CDBTTree::CDBTTree(const std::string &fname)
   : m_Filename(fname)
@@ -706,6 +707,40 @@ float CDBTTree::GetFloatValue(int channel, const std::string &name, int verbose)
   return calibiter->second;
 }
 
+std::vector<float> CDBTTree::GetFloatValues(const std::vector<int> &channels, const std::string &name, int verbose)
+{
+  if (m_FloatEntryMap.empty())
+  {
+    LoadCalibrations();
+  }
+  std::string fieldname = "F" + name;
+  std::vector<float> values(channels.size(), std::numeric_limits<float>::quiet_NaN());
+  for (size_t i = 0; i < channels.size(); i++)
+  {
+    auto channelmapiter = m_FloatEntryMap.find(channels[i]);
+    if (channelmapiter == m_FloatEntryMap.end())
+    {
+      if (verbose > 0)
+      {
+        std::cout << PHWHERE << " Could not find channel " << channels[i]
+                  << " for " << name << " in float calibrations" << std::endl;
+      }
+      continue;
+    }
+    auto calibiter = channelmapiter->second.find(fieldname);
+    if (calibiter == channelmapiter->second.end())
+    {
+      if (verbose > 0)
+      {
+        std::cout << "Could not find " << name << " among float calibrations of channel " << channels[i] << std::endl;
+      }
+      continue;
+    }
+    values[i] = calibiter->second;
+  }
+  return values;
+}
+
 double CDBTTree::GetSingleDoubleValue(const std::string &name, int verbose)
 {
   if (m_SingleDoubleEntryMap.empty())
@@ -818,6 +853,40 @@ int CDBTTree::GetIntValue(int channel, const std::string &name, int verbose)
   return calibiter->second;
 }
 
+std::vector<int> CDBTTree::GetIntValues(const std::vector<int> &channels, const std::string &name, int verbose)
+{
+  if (m_IntEntryMap.empty())
+  {
+    LoadCalibrations();
+  }
+  std::string fieldname = "I" + name;
+  std::vector<int> values(channels.size(), std::numeric_limits<int>::min());
+  for (size_t i = 0; i < channels.size(); i++)
+  {
+    auto channelmapiter = m_IntEntryMap.find(channels[i]);
+    if (channelmapiter == m_IntEntryMap.end())
+    {
+      if (verbose > 0)
+      {
+        std::cout << PHWHERE << " Could not find channel " << channels[i]
+                  << " for " << name << " in int calibrations" << std::endl;
+      }
+      continue;
+    }
+    auto calibiter = channelmapiter->second.find(fieldname);
+    if (calibiter == channelmapiter->second.end())
+    {
+      if (verbose > 0)
+      {
+        std::cout << "Could not find " << name << " among int calibrations for channel " << channels[i] << std::endl;
+      }
+      continue;
+    }
+    values[i] = calibiter->second;
+  }
+  return values;
+}
+
 uint64_t CDBTTree::GetSingleUInt64Value(const std::string &name, int verbose)
 {
   if (m_SingleUInt64EntryMap.empty())
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 class TTree;
 
@@ -37,6 +38,11 @@ class CDBTTree
   int GetIntValue(int channel, const std::string &name, int verbose = 1);
   uint64_t GetSingleUInt64Value(const std::string &name, int verbose = 1);
   uint64_t GetUInt64Value(int channel, const std::string &name, int verbose = 1);
+  // one field for a list of channels, values[i] belongs to channels[i]. Meant to be
+  // resolved once per run so the per event loops read a dense array. Missing
+  // channels get the same value as from GetFloatValue / GetIntValue
+  std::vector<float> GetFloatValues(const std::vector<int> &channels, const std::string &name, int verbose = 1);
+  std::vector<int> GetIntValues(const std::vector<int> &channels, const std::string &name, int verbose = 1);
 
  private:
   enum
@@ -62,6 +62,7 @@ CaloTowerBuilder::~CaloTowerBuilder()
 int CaloTowerBuilder::InitRun(PHCompositeNode *topNode)
 {
   WaveformProcessing->set_processing_type(_processingtype);
+  WaveformProcessing->set_nthreads(m_nthreads);
   WaveformProcessing->set_softwarezerosuppression(m_bdosoftwarezerosuppression, m_nsoftwarezerosuppression);
   if (m_setTimeLim)
   {
@@ -193,6 +194,20 @@ int CaloTowerBuilder::process_sim()
 
 int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::vector<float>> &waveforms)
 {
+  int ret = process_data(topNode, m_batch);
+  int n_channels = m_batch.get_nchannels();
+  for (int i = 0; i < n_channels; i++)
+  {
+    std::vector<float> waveform(m_batch.get_nsamples(i));
+    m_batch.get_waveform(i, waveform.data());
+    waveforms.push_back(waveform);
+  }
+  return ret;
+}
+
+int CaloTowerBuilder::process_data(PHCompositeNode *topNode, CaloWaveformBatch &batch)
+{
+  batch.reset(m_nsamples, (m_packet_high - m_packet_low + 1) * m_nchannels);
   std::variant<CaloPacketContainer*, Event*> event;
   if (m_UseOfflinePacketFlag)
   {
@@ -253,36 +268,28 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
             {
               for (int iskip = 0; iskip < 64; iskip++)
               {
-                std::vector<float> waveform;
-                waveform.reserve(m_nsamples);
-
-                for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-                {
-                  waveform.push_back(0);
-                }
-                waveforms.push_back(waveform);
-                waveform.clear();
+                batch.add_channel(m_nzerosuppsamples);
               }
             }
           }
         }
 
-        std::vector<float> waveform;
-        waveform.reserve(m_nsamples);
         if (packet->iValue(channel, "SUPPRESSED"))
         {
-          waveform.push_back(packet->iValue(channel, "PRE"));
-          waveform.push_back(packet->iValue(channel, "POST"));
+          int ich = batch.add_channel(2);
+          batch.set_sample(ich, 0, packet->iValue(channel, "PRE"));
+          batch.set_sample(ich, 1, packet->iValue(channel, "POST"));
         }
         else
         {
-          for (int samp = 0; samp < m_nsamples; samp++)
+          int ich = batch.add_channel(m_nsamples);
+          // the batch keeps at most CaloWaveformBatch::max_samples
+          int nsamples = batch.get_nsamples(ich);
+          for (int samp = 0; samp < nsamples; samp++)
           {
-            waveform.push_back(packet->iValue(samp, channel));
+            batch.set_sample(ich, samp, packet->iValue(samp, channel));
           }
         }
-        waveforms.push_back(waveform);
-        waveform.clear();
       }
 
       if (nchannels < m_nchannels && !(m_dettype == CaloTowerDefs::CEMC && adc_skip_mask < 4))
@@ -293,15 +300,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
           {
             continue;
           }
-          std::vector<float> waveform;
-          waveform.reserve(m_nsamples);
-
-          for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-          {
-            waveform.push_back(0);
-          }
-          waveforms.push_back(waveform);
-          waveform.clear();
+          batch.add_channel(m_nzerosuppsamples);
         }
       }
     }
@@ -313,14 +312,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
         {
           continue;
         }
-        std::vector<float> waveform;
-        waveform.reserve(2);
-        for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-        {
-          waveform.push_back(0);
-        }
-        waveforms.push_back(waveform);
-        waveform.clear();
+        batch.add_channel(m_nzerosuppsamples);
       }
     }
     return Fun4AllReturnCodes::EVENT_OK;
@@ -363,44 +355,55 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
   {
     return process_sim();
   }
-  std::vector<std::vector<float>> waveforms;
-  if(process_data(topNode, waveforms) == Fun4AllReturnCodes::ABORTEVENT)
+  if (process_batch(topNode) == Fun4AllReturnCodes::ABORTEVENT)
   {
     return Fun4AllReturnCodes::ABORTEVENT;
   }
-  // waveform vector is filled here, now fill our output. methods from the base class make sure
-  // we only fill what the chosen container version supports
-  std::vector<std::vector<float>> processed_waveforms = WaveformProcessing->process_waveform(waveforms);
-  int n_channels = processed_waveforms.size();
+  int n_channels = m_batch.get_nchannels();
   for (int i = 0; i < n_channels; i++)
   {
-    TowerInfo *towerinfo = m_CaloInfoContainer->get_tower_at_channel(i);
-    towerinfo->set_time(processed_waveforms.at(i).at(1));
-    towerinfo->set_energy(processed_waveforms.at(i).at(0));
-    towerinfo->set_time_float(processed_waveforms.at(i).at(1));
-    towerinfo->set_pedestal(processed_waveforms.at(i).at(2));
-    towerinfo->set_chi2(processed_waveforms.at(i).at(3));
-    int n_samples = waveforms.at(i).size();
-    if (n_samples == m_nzerosuppsamples)
+    fill_tower(i, m_CaloInfoContainer->get_tower_at_channel(i));
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int CaloTowerBuilder::process_batch(PHCompositeNode *topNode)
+{
+  if (process_data(topNode, m_batch) == Fun4AllReturnCodes::ABORTEVENT)
+  {
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+  // the batch holds all waveforms, fit them in place
+  WaveformProcessing->process_waveform(m_batch);
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void CaloTowerBuilder::fill_tower(int channel, TowerInfo *towerinfo) const
+{
+  // methods from the base class make sure we only fill what the chosen container version supports
+  towerinfo->set_time(m_batch.get_time(channel));
+  towerinfo->set_energy(m_batch.get_amplitude(channel));
+  towerinfo->set_time_float(m_batch.get_time(channel));
+  towerinfo->set_pedestal(m_batch.get_pedestal(channel));
+  towerinfo->set_chi2(m_batch.get_chi2(channel));
+  int n_samples = m_batch.get_nsamples(channel);
+  if (n_samples == m_nzerosuppsamples)
+  {
+    if (m_batch.get_sample(channel, 0) == 0)
     {
-      if(waveforms.at(i).at(0) == 0)
-      {
-        towerinfo->set_isNotInstr(true);
-      }
-      else
-      {
-        towerinfo->set_isZS(true);
-      }
+      towerinfo->set_isNotInstr(true);
     }
-    
-    for (int j = 0; j < n_samples; j++)
+    else
     {
-      towerinfo->set_waveform_value(j, waveforms.at(i).at(j));
+      towerinfo->set_isZS(true);
     }
   }
-  waveforms.clear();
 
-  return Fun4AllReturnCodes::EVENT_OK;
+  for (int j = 0; j < n_samples; j++)
+  {
+    towerinfo->set_waveform_value(j, m_batch.get_sample(channel, j));
+  }
 }
 
 bool CaloTowerBuilder::skipChannel(int ich, int pid)
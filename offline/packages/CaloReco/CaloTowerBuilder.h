@@ -4,6 +4,7 @@
 #define CALOTOWERBUILDER_H
 
 #include "CaloTowerDefs.h"
+#include "CaloWaveformBatch.h"
 #include "CaloWaveformProcessing.h"
 
 #include <cdbobjects/CDBTTree.h>  // for CDBTTree
@@ -15,6 +16,7 @@
 
 class CaloWaveformProcessing;
 class PHCompositeNode;
+class TowerInfo;
 class TowerInfoContainer;
 class TowerInfoContainerv3;
 
@@ -30,7 +32,14 @@ class CaloTowerBuilder : public SubsysReco
   void CreateNodeTree(PHCompositeNode *topNode);
 
   int process_data(PHCompositeNode *topNode, std::vector<std::vector<float>> &wv);
-  
+  //! fill the batch with the waveforms of all channels of the event
+  int process_data(PHCompositeNode *topNode, CaloWaveformBatch &batch);
+  //! unpack and fit the waveforms of the event, the towers are not touched
+  int process_batch(PHCompositeNode *topNode);
+  int get_batch_nchannels() const { return m_batch.get_nchannels(); }
+  //! copy the fit result and samples of one channel of the batch into its tower
+  void fill_tower(int channel, TowerInfo *towerinfo) const;
+
 
   void set_detector_type(CaloTowerDefs::DetectorSystem dettype)
   {
@@ -54,6 +63,7 @@ class CaloTowerBuilder : public SubsysReco
     m_isdata = flag;
     return;
   }
+  bool get_dataflag() const { return m_isdata; }
 
   void set_processing_type(CaloWaveformProcessing::process processingtype)
   {
@@ -76,6 +86,12 @@ class CaloTowerBuilder : public SubsysReco
   {
     m_UseOfflinePacketFlag = f;
   }
+  //! worker threads for the waveform processing of one event
+  void set_nthreads(int nthreads)
+  {
+    m_nthreads = nthreads;
+    return;
+  }
   void set_timeFitLim(float low,float high)
   {
     m_setTimeLim = true;
@@ -91,12 +107,14 @@ class CaloTowerBuilder : public SubsysReco
   TowerInfoContainer *m_CaloInfoContainer{nullptr};      //! Calo info
   TowerInfoContainer *m_CalowaveformContainer{nullptr};  // waveform from simulation
   CDBTTree *cdbttree = nullptr;
+  CaloWaveformBatch m_batch;  // waveforms and fit results, reused every event
 
   bool m_isdata{true};
   bool m_bdosoftwarezerosuppression{false};
   bool m_UseOfflinePacketFlag{false};
   int m_packet_low{std::numeric_limits<int>::min()};
   int m_packet_high{std::numeric_limits<int>::min()};
+  int m_nthreads{1};
   int m_nsamples{16};
   int m_nchannels{192};
   int m_nzerosuppsamples{2};
@@ -33,6 +33,7 @@
 #include <exception>  // for exception
 #include <iostream>   // for operator<<, basic_ostream
 #include <stdexcept>  // for runtime_error
+#include <vector>
 
 //____________________________________________________________________________..
 CaloTowerCalib::CaloTowerCalib(const std::string &name)
@@ -229,6 +230,8 @@ int CaloTowerCalib::InitRun(PHCompositeNode *topNode)
     std::cout << e.what() << std::endl;
     return Fun4AllReturnCodes::ABORTRUN;
   }
+  TowerInfoContainer *_raw_towers = findNode::getClass<TowerInfoContainer>(topNode, RawTowerNodeName);
+  LoadCalibConstants(_raw_towers);
   if (Verbosity() > 0)
   {
     topNode->print();
@@ -236,29 +239,49 @@ int CaloTowerCalib::InitRun(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+//____________________________________________________________________________..
+void CaloTowerCalib::LoadCalibConstants(TowerInfoContainer *towers)
+{
+  // the calibration does not change within a run, look up the
+  // constant of every channel once instead of per event
+  unsigned int ntowers = towers->size();
+  std::vector<int> keys(ntowers);
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    keys[channel] = towers->encode_key(channel);
+  }
+  m_calibconst = cdbttree->GetFloatValues(keys, m_fieldname);
+}
+
 //____________________________________________________________________________..
 int CaloTowerCalib::process_event(PHCompositeNode *topNode)
 {
   TowerInfoContainer *_raw_towers = findNode::getClass<TowerInfoContainer>(topNode, RawTowerNodeName);
   TowerInfoContainer *_calib_towers = findNode::getClass<TowerInfoContainer>(topNode, CalibTowerNodeName);
   unsigned int ntowers = _raw_towers->size();
+  if (m_calibconst.size() != ntowers)
+  {
+    LoadCalibConstants(_raw_towers);
+  }
 
   for (unsigned int channel = 0; channel < ntowers; channel++)
   {
-    unsigned int key = _raw_towers->encode_key(channel);
-    TowerInfo *caloinfo_raw = _raw_towers->get_tower_at_channel(channel);
-    _calib_towers->get_tower_at_channel(channel)->copy_tower(caloinfo_raw);
-    float raw_amplitude = caloinfo_raw->get_energy();
-    float calibconst = cdbttree->GetFloatValue(key, m_fieldname);
-    _calib_towers->get_tower_at_channel(channel)->set_energy(raw_amplitude * calibconst);
-    if (calibconst == 0)
-    {
-      _calib_towers->get_tower_at_channel(channel)->set_isNoCalib(true);
-    }
+    calibrate(channel, _raw_towers->get_tower_at_channel(channel), _calib_towers->get_tower_at_channel(channel));
   }
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void CaloTowerCalib::calibrate(unsigned int channel, TowerInfo *raw, TowerInfo *calib) const
+{
+  float calibconst = m_calibconst[channel];
+  calib->copy_tower(raw);
+  calib->set_energy(raw->get_energy() * calibconst);
+  if (calibconst == 0)
+  {
+    calib->set_isNoCalib(true);
+  }
+}
+
 void CaloTowerCalib::CreateNodeTree(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
@@ -11,9 +11,11 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 class CDBTTree;
 class PHCompositeNode;
+class TowerInfo;
 class TowerInfoContainer;
 
 class CaloTowerCalib : public SubsysReco
@@ -26,6 +28,8 @@ class CaloTowerCalib : public SubsysReco
   int InitRun(PHCompositeNode *topNode) override;
   int process_event(PHCompositeNode *topNode) override;
   void CreateNodeTree(PHCompositeNode *topNode);
+  //! calibrated copy of one tower of the input container, the constants are set up in InitRun
+  void calibrate(unsigned int channel, TowerInfo *raw, TowerInfo *calib) const;
 
   void set_detector_type(CaloTowerDefs::DetectorSystem dettype)
   {
@@ -64,6 +68,8 @@ class CaloTowerCalib : public SubsysReco
   void set_use_TowerInfov2(bool use) { m_use_TowerInfov2 = use; }
 
  private:
+  void LoadCalibConstants(TowerInfoContainer *towers);
+
   CaloTowerDefs::DetectorSystem m_dettype;
 
   std::string m_detector;
@@ -83,6 +89,8 @@ class CaloTowerCalib : public SubsysReco
   std::string m_directURL = "";
 
   CDBTTree *cdbttree = nullptr;
+  // calibration constant per channel of the input container, set in InitRun
+  std::vector<float> m_calibconst;
   int m_runNumber;
 };
 
@@ -0,0 +1,165 @@
+#include "CaloTowerPipeline.h"
+
+#include "CaloTowerBuilder.h"
+#include "CaloTowerCalib.h"
+#include "CaloTowerStatus.h"
+
+#include <calobase/TowerInfo.h>
+#include <calobase/TowerInfoContainer.h>
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/SubsysReco.h>  // for SubsysReco
+
+#include <phool/PHCompositeNode.h>
+#include <phool/getClass.h>
+#include <phool/phool.h>  // for PHWHERE
+
+#include <algorithm>  // for min
+#include <iostream>   // for operator<<, endl, basic...
+
+//____________________________________________________________________________..
+CaloTowerPipeline::CaloTowerPipeline(const std::string &name)
+  : SubsysReco(name)
+{
+  m_builder = new CaloTowerBuilder(name + "_Builder");
+  m_status = new CaloTowerStatus(name + "_Status");
+  m_calib = new CaloTowerCalib(name + "_Calib");
+  set_detector_type(m_dettype);
+}
+
+//____________________________________________________________________________..
+CaloTowerPipeline::~CaloTowerPipeline()
+{
+  delete m_builder;
+  delete m_status;
+  delete m_calib;
+}
+
+//____________________________________________________________________________..
+void CaloTowerPipeline::set_detector_type(CaloTowerDefs::DetectorSystem dettype)
+{
+  m_dettype = dettype;
+  m_builder->set_detector_type(dettype);
+  m_status->set_detector_type(dettype);
+  m_calib->set_detector_type(dettype);
+  return;
+}
+
+//____________________________________________________________________________..
+int CaloTowerPipeline::InitRun(PHCompositeNode *topNode)
+{
+  if (m_dettype == CaloTowerDefs::CEMC)
+  {
+    m_detector = "CEMC";
+  }
+  else if (m_dettype == CaloTowerDefs::HCALIN)
+  {
+    m_detector = "HCALIN";
+  }
+  else if (m_dettype == CaloTowerDefs::HCALOUT)
+  {
+    m_detector = "HCALOUT";
+  }
+  else if (m_dettype == CaloTowerDefs::ZDC)
+  {
+    m_detector = "ZDC";
+  }
+  else if (m_dettype == CaloTowerDefs::SEPD)
+  {
+    m_detector = "SEPD";
+  }
+  m_towerNodeName = m_towerNodePrefix + m_detector;
+  m_calibNodeName = m_calibNodePrefix + m_detector;
+
+  m_builder->set_outputNodePrefix(m_towerNodePrefix);
+  m_status->set_inputNodePrefix(m_towerNodePrefix);
+  m_calib->set_inputNodePrefix(m_towerNodePrefix);
+  m_calib->set_outputNodePrefix(m_calibNodePrefix);
+
+  m_builder->Verbosity(Verbosity());
+  m_status->Verbosity(Verbosity());
+  m_calib->Verbosity(Verbosity());
+
+  // same order as registering the modules one by one, each one needs
+  // the nodes of the previous one
+  int iret = m_builder->InitRun(topNode);
+  if (iret != Fun4AllReturnCodes::EVENT_OK)
+  {
+    return iret;
+  }
+  if (m_doStatus)
+  {
+    iret = m_status->InitRun(topNode);
+    if (iret != Fun4AllReturnCodes::EVENT_OK)
+    {
+      return iret;
+    }
+  }
+  if (m_doCalib)
+  {
+    iret = m_calib->InitRun(topNode);
+  }
+  return iret;
+}
+
+//____________________________________________________________________________..
+int CaloTowerPipeline::process_event(PHCompositeNode *topNode)
+{
+  if (!m_builder->get_dataflag())
+  {
+    int iret = m_builder->process_event(topNode);
+    if (iret == Fun4AllReturnCodes::EVENT_OK && m_doStatus)
+    {
+      iret = m_status->process_event(topNode);
+    }
+    if (iret == Fun4AllReturnCodes::EVENT_OK && m_doCalib)
+    {
+      iret = m_calib->process_event(topNode);
+    }
+    return iret;
+  }
+
+  if (m_builder->process_batch(topNode) == Fun4AllReturnCodes::ABORTEVENT)
+  {
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+
+  TowerInfoContainer *towers = findNode::getClass<TowerInfoContainer>(topNode, m_towerNodeName);
+  TowerInfoContainer *calib_towers = nullptr;
+  if (!towers)
+  {
+    std::cout << PHWHERE << " " << m_towerNodeName << " node missing" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+  if (m_doCalib)
+  {
+    calib_towers = findNode::getClass<TowerInfoContainer>(topNode, m_calibNodeName);
+    if (!calib_towers)
+    {
+      std::cout << PHWHERE << " " << m_calibNodeName << " node missing" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+  }
+
+  // one pass: fill, flag and calibrate a tower before moving to the next one
+  unsigned int ntowers = towers->size();
+  unsigned int nfilled = std::min(ntowers, static_cast<unsigned int>(m_builder->get_batch_nchannels()));
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    TowerInfo *tower = towers->get_tower_at_channel(channel);
+    if (channel < nfilled)
+    {
+      m_builder->fill_tower(channel, tower);
+    }
+    if (m_doStatus)
+    {
+      m_status->set_status(channel, tower);
+    }
+    if (m_doCalib)
+    {
+      m_calib->calibrate(channel, tower, calib_towers->get_tower_at_channel(channel));
+    }
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
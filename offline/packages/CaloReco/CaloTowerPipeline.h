@@ -0,0 +1,86 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef CALOTOWERPIPELINE_H
+#define CALOTOWERPIPELINE_H
+
+#include "CaloTowerDefs.h"
+
+#include <fun4all/SubsysReco.h>
+
+#include <string>
+
+class CaloTowerBuilder;
+class CaloTowerCalib;
+class CaloTowerStatus;
+class PHCompositeNode;
+
+/// \class CaloTowerPipeline
+///
+/// \brief CaloTowerBuilder, CaloTowerStatus and CaloTowerCalib in one pass
+///
+/// Replaces the three modules registered one after the other, with the same
+/// output nodes (TOWERS_<det> with the status bits and TOWERINFO_CALIB_<det>).
+/// The waveforms of the event are unpacked and fitted by the builder as
+/// before, then a single loop over the channels fills each raw tower, flags
+/// it and writes its calibrated copy while the tower is still in cache,
+/// instead of three passes over the containers. The status maps and
+/// calibration constants are resolved per run by the modules themselves.
+///
+/// Simulation (set_dataflag(false) on the builder) runs the three modules
+/// one after the other. Settings not forwarded here are made on the modules
+/// directly, e.g. get_builder()->set_processing_type(...)
+///
+class CaloTowerPipeline : public SubsysReco
+{
+ public:
+  explicit CaloTowerPipeline(const std::string &name = "CaloTowerPipeline");
+  ~CaloTowerPipeline() override;
+
+  int InitRun(PHCompositeNode *topNode) override;
+  int process_event(PHCompositeNode *topNode) override;
+
+  void set_detector_type(CaloTowerDefs::DetectorSystem dettype);
+
+  //! output of the builder and input of status and calibration
+  void set_towerNodePrefix(const std::string &name)
+  {
+    m_towerNodePrefix = name;
+    return;
+  }
+  void set_calibNodePrefix(const std::string &name)
+  {
+    m_calibNodePrefix = name;
+    return;
+  }
+  void set_doStatus(bool flag)
+  {
+    m_doStatus = flag;
+    return;
+  }
+  void set_doCalib(bool flag)
+  {
+    m_doCalib = flag;
+    return;
+  }
+
+  CaloTowerBuilder *get_builder() { return m_builder; }
+  CaloTowerStatus *get_status() { return m_status; }
+  CaloTowerCalib *get_calib() { return m_calib; }
+
+ private:
+  CaloTowerBuilder *m_builder{nullptr};
+  CaloTowerStatus *m_status{nullptr};
+  CaloTowerCalib *m_calib{nullptr};
+
+  bool m_doStatus{true};
+  bool m_doCalib{true};
+
+  CaloTowerDefs::DetectorSystem m_dettype{CaloTowerDefs::CEMC};
+  std::string m_detector{"CEMC"};
+  std::string m_towerNodePrefix{"TOWERS_"};
+  std::string m_calibNodePrefix{"TOWERINFO_CALIB_"};
+  std::string m_towerNodeName;
+  std::string m_calibNodeName;
+};
+
+#endif  // CALOTOWERPIPELINE_H
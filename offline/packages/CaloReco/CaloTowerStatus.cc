@@ -29,11 +29,13 @@
 
 #include <TSystem.h>
 
+#include <algorithm>  // for max
 #include <cmath>
 #include <cstdlib>    // for exit
 #include <exception>  // for exception
 #include <iostream>   // for operator<<, basic_ostream
 #include <stdexcept>  // for runtime_error
+#include <vector>
 
 //____________________________________________________________________________..
 CaloTowerStatus::CaloTowerStatus(const std::string &name)
@@ -162,6 +164,7 @@ int CaloTowerStatus::InitRun(PHCompositeNode *topNode)
     std::cout << e.what() << std::endl;
     return Fun4AllReturnCodes::ABORTRUN;
   }
+  LoadStatusMaps();
   if (Verbosity() > 0)
   {
     topNode->print();
@@ -169,57 +172,78 @@ int CaloTowerStatus::InitRun(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+//____________________________________________________________________________..
+void CaloTowerStatus::LoadStatusMaps()
+{
+  // the maps do not change within a run, look up the values of every
+  // channel once instead of per event. Channels without maps get 0
+  unsigned int ntowers = m_raw_towers->size();
+  std::vector<int> keys(ntowers);
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    keys[channel] = m_raw_towers->encode_key(channel);
+  }
+  m_fraction_badChi2.assign(ntowers, 0);
+  m_mean_time.assign(ntowers, 0);
+  m_hotMap.assign(ntowers, 0);
+  if (m_doHotChi2)
+  {
+    m_fraction_badChi2 = m_cdbttree_chi2->GetFloatValues(keys, m_fieldname_chi2);
+  }
+  if (m_doTime)
+  {
+    m_mean_time = m_cdbttree_time->GetFloatValues(keys, m_fieldname_time);
+  }
+  if (m_doHotMap)
+  {
+    m_hotMap = m_cdbttree_hotMap->GetIntValues(keys, m_fieldname_hotMap);
+  }
+}
+
 //____________________________________________________________________________..
 int CaloTowerStatus::process_event(PHCompositeNode * /*topNode*/)
 {
   unsigned int ntowers = m_raw_towers->size();
-  float fraction_badChi2 = 0;
-  float mean_time = 0;
-  int hotMap_val = 0;
+  if (m_hotMap.size() != ntowers)
+  {
+    LoadStatusMaps();
+  }
   for (unsigned int channel = 0; channel < ntowers; channel++)
   {
-    unsigned int key = m_raw_towers->encode_key(channel);
-    //only reset what we will set
-    m_raw_towers->get_tower_at_channel(channel)->set_isHot(false); 
-    m_raw_towers->get_tower_at_channel(channel)->set_isBadTime(false); 
-    m_raw_towers->get_tower_at_channel(channel)->set_isBadChi2(false); 
-
-    if (m_doHotChi2)
-    {
-      fraction_badChi2 = m_cdbttree_chi2->GetFloatValue(key, m_fieldname_chi2);
-    }
-    if (m_doTime)
-    {
-      mean_time = m_cdbttree_time->GetFloatValue(key, m_fieldname_time);
-    }
-    if (m_doHotMap)
-    {
-      hotMap_val = m_cdbttree_hotMap->GetIntValue(key, m_fieldname_hotMap);
-    }
-    float chi2 = m_raw_towers->get_tower_at_channel(channel)->get_chi2();
-    float time = m_raw_towers->get_tower_at_channel(channel)->get_time_float();
-    float adc = m_raw_towers->get_tower_at_channel(channel)->get_energy();
-
-    if (fraction_badChi2 > fraction_badChi2_threshold && m_doHotChi2)
-    {
-      m_raw_towers->get_tower_at_channel(channel)->set_isHot(true);
-    }
-    if (std::fabs(time - mean_time) > time_cut && m_doTime)
-    {
-      m_raw_towers->get_tower_at_channel(channel)->set_isBadTime(true);
-    }
-    if (hotMap_val != 0 && m_doHotMap)
-    {
-      m_raw_towers->get_tower_at_channel(channel)->set_isHot(true);
-    }
-    if (chi2 > std::max(badChi2_treshold_const, adc * adc * badChi2_treshold_quadratic))
-    {
-      m_raw_towers->get_tower_at_channel(channel)->set_isBadChi2(true);
-    }
+    set_status(channel, m_raw_towers->get_tower_at_channel(channel));
   }
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void CaloTowerStatus::set_status(unsigned int channel, TowerInfo *tower) const
+{
+  //only reset what we will set
+  tower->set_isHot(false);
+  tower->set_isBadTime(false);
+  tower->set_isBadChi2(false);
+
+  float chi2 = tower->get_chi2();
+  float time = tower->get_time_float();
+  float adc = tower->get_energy();
+
+  if (m_fraction_badChi2[channel] > fraction_badChi2_threshold && m_doHotChi2)
+  {
+    tower->set_isHot(true);
+  }
+  if (std::fabs(time - m_mean_time[channel]) > time_cut && m_doTime)
+  {
+    tower->set_isBadTime(true);
+  }
+  if (m_hotMap[channel] != 0 && m_doHotMap)
+  {
+    tower->set_isHot(true);
+  }
+  if (chi2 > std::max(badChi2_treshold_const, adc * adc * badChi2_treshold_quadratic))
+  {
+    tower->set_isBadChi2(true);
+  }
+}
+
 void CaloTowerStatus::CreateNodeTree(PHCompositeNode *topNode)
 {
   std::string RawTowerNodeName = m_inputNodePrefix + m_detector;
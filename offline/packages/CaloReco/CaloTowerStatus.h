@@ -11,9 +11,11 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 class CDBTTree;
 class PHCompositeNode;
+class TowerInfo;
 class TowerInfoContainer;
 
 class CaloTowerStatus : public SubsysReco
@@ -26,6 +28,8 @@ class CaloTowerStatus : public SubsysReco
   int InitRun(PHCompositeNode *topNode) override;
   int process_event(PHCompositeNode *topNode) override;
   void CreateNodeTree(PHCompositeNode *topNode);
+  //! flag one tower of the input container, the maps are set up in InitRun
+  void set_status(unsigned int channel, TowerInfo *tower) const;
 
   void set_detector_type(CaloTowerDefs::DetectorSystem dettype)
   {
@@ -77,6 +81,8 @@ class CaloTowerStatus : public SubsysReco
   }
 
  private:
+  void LoadStatusMaps();
+
   TowerInfoContainer *m_raw_towers{nullptr};
 
   CDBTTree *m_cdbttree_chi2{nullptr};
@@ -87,6 +93,11 @@ class CaloTowerStatus : public SubsysReco
   bool m_doTime{true};
   bool m_doHotMap{true};
 
+  // per channel values of the maps, set in InitRun
+  std::vector<float> m_fraction_badChi2;
+  std::vector<float> m_mean_time;
+  std::vector<int> m_hotMap;
+
   CaloTowerDefs::DetectorSystem m_dettype{CaloTowerDefs::DETECTOR_INVALID};
 
   std::string m_detector;
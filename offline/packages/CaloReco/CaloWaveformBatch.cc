@@ -0,0 +1,96 @@
+#include "CaloWaveformBatch.h"
+
+#include <algorithm>  // for min, fill
+#include <iostream>
+
+void CaloWaveformBatch::reset(int nsamples, int nchannels)
+{
+  if (nsamples > max_samples)
+  {
+    std::cout << "CaloWaveformBatch::reset: " << nsamples << " samples requested, only the first " << max_samples << " are kept" << std::endl;
+    nsamples = max_samples;
+  }
+  if (nsamples != m_nsamples)
+  {
+    // the layout depends on the number of samples, start over
+    m_nsamples = nsamples;
+    m_capacity = 0;
+  }
+  m_nchannels = 0;
+  if (nchannels > m_capacity)
+  {
+    grow(nchannels);
+  }
+}
+
+int CaloWaveformBatch::add_channel(int nsamples)
+{
+  if (m_nchannels == m_capacity)
+  {
+    grow(std::max(2 * m_capacity, 64));
+  }
+  int channel = m_nchannels++;
+  m_channel_nsamples[channel] = std::min(nsamples, m_nsamples);
+  for (int sample = 0; sample < m_nsamples; sample++)
+  {
+    m_adc[sample * m_capacity + channel] = 0;
+  }
+  return channel;
+}
+
+void CaloWaveformBatch::get_waveform(int channel, float *samples) const
+{
+  int nsamples = m_channel_nsamples[channel];
+  for (int sample = 0; sample < nsamples; sample++)
+  {
+    samples[sample] = m_adc[sample * m_capacity + channel];
+  }
+}
+
+void CaloWaveformBatch::find_peaks()
+{
+  if (m_nchannels == 0)
+  {
+    return;
+  }
+  // branch free over the channels of a row. The rows past the 2 samples
+  // of zero suppressed channels are 0, their peaks are not used
+  const int16_t *first = get_row(0);
+  int *maxbin = m_maxbin.data();
+  float *maxheight = m_maxheight.data();
+  for (int channel = 0; channel < m_nchannels; channel++)
+  {
+    maxbin[channel] = 0;
+    maxheight[channel] = first[channel];
+  }
+  for (int sample = 1; sample < m_nsamples; sample++)
+  {
+    const int16_t *row = get_row(sample);
+    for (int channel = 0; channel < m_nchannels; channel++)
+    {
+      float value = row[channel];
+      bool larger = value > maxheight[channel];
+      maxheight[channel] = larger ? value : maxheight[channel];
+      maxbin[channel] = larger ? sample : maxbin[channel];
+    }
+  }
+}
+
+void CaloWaveformBatch::grow(int capacity)
+{
+  std::vector<int16_t> adc(static_cast<size_t>(m_nsamples) * capacity, 0);
+  for (int sample = 0; sample < m_nsamples; sample++)
+  {
+    std::copy(m_adc.begin() + sample * m_capacity, m_adc.begin() + sample * m_capacity + m_nchannels, adc.begin() + sample * capacity);
+  }
+  m_adc.swap(adc);
+  m_capacity = capacity;
+
+  m_channel_nsamples.resize(capacity);
+  m_maxbin.resize(capacity);
+  m_maxheight.resize(capacity);
+  m_amplitude.resize(capacity);
+  m_time.resize(capacity);
+  m_pedestal.resize(capacity);
+  m_chi2.resize(capacity);
+}
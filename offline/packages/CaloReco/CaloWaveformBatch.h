@@ -0,0 +1,93 @@
+#ifndef CALORECO_CALOWAVEFORMBATCH_H
+#define CALORECO_CALOWAVEFORMBATCH_H
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/// \class CaloWaveformBatch
+///
+/// \brief ADC samples and fit results of all channels of one event
+///
+/// The samples are stored sample-major, m_adc[sample * capacity + channel],
+/// so a loop over the channels at fixed sample is contiguous and the
+/// pedestal / peak searches of CaloWaveformFitting vectorize across
+/// channels. Zero suppressed channels hold 2 samples (pre, post), the
+/// remaining rows are 0. Results are stored per channel in separate
+/// arrays. The buffers are kept between events, so after the first event
+/// filling and processing a batch does not allocate.
+///
+class CaloWaveformBatch
+{
+ public:
+  static const int max_samples = 64;
+
+  CaloWaveformBatch() = default;
+  ~CaloWaveformBatch() = default;
+
+  //! start a new event, nsamples for not zero suppressed channels,
+  //! nchannels is the expected number of channels (more can be added)
+  void reset(int nsamples, int nchannels);
+
+  //! add a channel with nsamples samples, all 0, returns its index
+  int add_channel(int nsamples);
+
+  void set_sample(int channel, int sample, int16_t adc)
+  {
+    assert(channel >= 0 && channel < m_nchannels && sample >= 0 && sample < m_nsamples);
+    m_adc[sample * m_capacity + channel] = adc;
+  }
+  int16_t get_sample(int channel, int sample) const
+  {
+    assert(channel >= 0 && channel < m_nchannels && sample >= 0 && sample < m_nsamples);
+    return m_adc[sample * m_capacity + channel];
+  }
+  //! all channels of one sample
+  const int16_t *get_row(int sample) const { return &m_adc[sample * m_capacity]; }
+
+  int get_nchannels() const { return m_nchannels; }
+  int get_nsamples() const { return m_nsamples; }
+  int get_nsamples(int channel) const { return m_channel_nsamples[channel]; }
+
+  //! copy the samples of a channel
+  void get_waveform(int channel, float *samples) const;
+
+  //! first maximum sample and its value (0 and the first sample if none
+  //! is larger) for all channels
+  void find_peaks();
+  int get_maxbin(int channel) const { return m_maxbin[channel]; }
+  float get_maxheight(int channel) const { return m_maxheight[channel]; }
+
+  void set_result(int channel, float amplitude, float time, float pedestal, float chi2)
+  {
+    m_amplitude[channel] = amplitude;
+    m_time[channel] = time;
+    m_pedestal[channel] = pedestal;
+    m_chi2[channel] = chi2;
+  }
+  void set_pedestal(int channel, float pedestal) { m_pedestal[channel] = pedestal; }
+  float get_amplitude(int channel) const { return m_amplitude[channel]; }
+  float get_time(int channel) const { return m_time[channel]; }
+  float get_pedestal(int channel) const { return m_pedestal[channel]; }
+  float get_chi2(int channel) const { return m_chi2[channel]; }
+
+ private:
+  void grow(int capacity);
+
+  int m_nsamples{0};
+  int m_nchannels{0};
+  int m_capacity{0};
+
+  std::vector<int16_t> m_adc;
+  std::vector<int> m_channel_nsamples;
+
+  std::vector<int> m_maxbin;
+  std::vector<float> m_maxheight;
+
+  std::vector<float> m_amplitude;
+  std::vector<float> m_time;
+  std::vector<float> m_pedestal;
+  std::vector<float> m_chi2;
+};
+
+#endif
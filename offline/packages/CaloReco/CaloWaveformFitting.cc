@@ -1,28 +1,65 @@
 #include "CaloWaveformFitting.h"
+#include "CaloWaveformBatch.h"
 
-#include <TF1.h>
 #include <TFile.h>
 #include <TProfile.h>
 #include <TSpline.h>
 
-#include <Fit/BinData.h>
-#include <Fit/Chi2FCN.h>
-#include <Fit/Fitter.h>
-#include <Fit/UnBinData.h>
-#include <HFitInterface.h>
-#include <Math/WrappedMultiTF1.h>
-#include <Math/WrappedTF1.h>
+#include <ROOT/TSeq.hxx>
 #include <ROOT/TThreadExecutor.hxx>
-#include <ROOT/TThreadedObject.hxx>
 
-#include <pthread.h>
+#include <algorithm>  // for max_element, min
+#include <cmath>
 #include <iostream>
+#include <memory>  // for make_unique
 #include <string>
 
-ROOT::TThreadExecutor *t = new ROOT::TThreadExecutor(1);
-double CaloWaveformFitting::template_function(double *x, double *par)
+// out of line, the executor is only forward declared in the header
+CaloWaveformFitting::CaloWaveformFitting() = default;
+CaloWaveformFitting::~CaloWaveformFitting() = default;
+
+void CaloWaveformFitting::set_nthreads(int nthreads)
+{
+  if (nthreads != _nthreads)
+  {
+    // the pool is made again with the new size on the next event
+    m_executor.reset();
+  }
+  _nthreads = nthreads;
+}
+
+template <typename Func>
+void CaloWaveformFitting::for_each_channel(int nchannels, Func func)
 {
-  Double_t v1 = par[0] * h_template->Interpolate(x[0] - par[1]) + par[2];
+  // a few chunks per worker, the fit time varies between channels
+  int nchunks = std::min(4 * _nthreads, nchannels);
+  if (_nthreads <= 1 || nchunks <= 1)
+  {
+    for (int ich = 0; ich < nchannels; ich++)
+    {
+      func(ich);
+    }
+    return;
+  }
+  if (!m_executor)
+  {
+    m_executor = std::make_unique<ROOT::TThreadExecutor>(_nthreads);
+  }
+  auto chunk = [&](int ichunk)
+  {
+    int begin = static_cast<long>(nchannels) * ichunk / nchunks;
+    int end = static_cast<long>(nchannels) * (ichunk + 1) / nchunks;
+    for (int ich = begin; ich < end; ich++)
+    {
+      func(ich);
+    }
+  };
+  m_executor->Foreach(chunk, ROOT::TSeqI(nchunks));
+}
+
+double CaloWaveformFitting::template_function(double *x, double *par) const
+{
+  Double_t v1 = par[0] * m_template_fit.interpolate(x[0] - par[1]) + par[2];
   return v1;
 }
 
@@ -33,7 +70,7 @@ void CaloWaveformFitting::initialize_processing(const std::string &templatefile)
   assert(fin->IsOpen());
   h_template = static_cast<TProfile *>(fin->Get("waveform_template"));
   m_peakTimeTemp = h_template->GetBinCenter(h_template->GetMaximumBin());
-  t = new ROOT::TThreadExecutor(_nthreads);
+  m_template_fit.set_template(h_template);
 }
 
 std::vector<std::vector<float>> CaloWaveformFitting::process_waveform(std::vector<std::vector<float>> waveformvector)
@@ -50,91 +87,29 @@ std::vector<std::vector<float>> CaloWaveformFitting::process_waveform(std::vecto
 
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit(std::vector<std::vector<float>> chnlvector)
 {
-  auto func = [&](std::vector<float> &v)
+  auto func = [&](int ich)
   {
+    std::vector<float> &v = chnlvector[ich];
     int size1 = v.size() - 1;
-    if (size1 == _nzerosuppresssamples)
-    {
-      v.push_back(v.at(1) - v.at(0));  // returns peak sample - pedestal sample
-      v.push_back(-1);                 // set time to -1 to indicate zero suppressed
-      v.push_back(v.at(0));
-      v.push_back(0);
-    }
-    else
+    float maxheight = 0;
+    int maxbin = 0;
+    for (int i = 0; i < size1; i++)
     {
-      float maxheight = 0;
-      int maxbin = 0;
-      for (int i = 0; i < size1; i++)
-      {
-        if (v.at(i) > maxheight)
-        {
-          maxheight = v.at(i);
-          maxbin = i;
-        }
-      }
-      float pedestal = 1500;
-      if (maxbin > 4)
-      {
-        pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
-      }
-      else if (maxbin > 3)
-      {
-        pedestal = (v.at(maxbin - 4));
-      }
-      else
+      if (v.at(i) > maxheight)
       {
-        pedestal = 0.5 * (v.at(size1 - 3) + v.at(size1 - 2));
-      }
-
-      if ( (_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight-pedestal  < _nsoftwarezerosuppression)  )
-      {
-        v.push_back(v.at(6) - v.at(0));
-        v.push_back(-1);
-        v.push_back(v.at(0));
-        v.push_back(0);
-      }
-      else
-      {
-        auto h = new TH1F(std::string("h_" + std::to_string((int) round(v.at(size1)))).c_str(), "", size1, -0.5, size1 - 0.5);
-        for (int i = 0; i < size1; i++)
-        {
-          h->SetBinContent(i + 1, v.at(i));
-          h->SetBinError(i + 1, 1);
-        }
-        auto f = new TF1(std::string("f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
-        ROOT::Math::WrappedMultiTF1 *fitFunction = new ROOT::Math::WrappedMultiTF1(*f, 3);
-        ROOT::Fit::BinData data(v.size() - 1, 1);
-        ROOT::Fit::FillData(data, h);
-        ROOT::Fit::Chi2Function *EPChi2 = new ROOT::Fit::Chi2Function(data, *fitFunction);
-        ROOT::Fit::Fitter *fitter = new ROOT::Fit::Fitter();
-        fitter->Config().MinimizerOptions().SetMinimizerType("GSLMultiFit");
-        double params[] = {static_cast<double>(maxheight - pedestal), 0, static_cast<double>(pedestal)};
-        fitter->Config().SetParamsSettings(3, params);
-        fitter->Config().ParSettings(1).SetLimits(-1 * m_peakTimeTemp, size1 - m_peakTimeTemp);  // set lim on time par
-        if (m_setTimeLim) 
-        {
-          fitter->Config().ParSettings(1).SetLimits(m_timeLim_low, m_timeLim_high);
-        }
-        fitter->FitFCN(*EPChi2, nullptr, data.Size(), true);
-        ROOT::Fit::FitResult fitres = fitter->Result();
-        double chi2min = fitres.MinFcnValue();
-        chi2min /= size1 - 3;  // divide by the number of dof
-        for (int i = 0; i < 3; i++)
-        {
-          v.push_back(f->GetParameter(i));
-        }
-
-        v.push_back(chi2min);
-        h->Delete();
-        f->Delete();
-        delete fitFunction;
-        delete fitter;
-        delete EPChi2;
+        maxheight = v.at(i);
+        maxbin = i;
       }
     }
+    float result[4];
+    templatefit_channel(v.data(), size1, maxheight, maxbin, result);
+    for (float value : result)
+    {
+      v.push_back(value);
+    }
   };
 
-  t->Foreach(func, chnlvector);
+  for_each_channel(chnlvector.size(), func);
   int size3 = chnlvector.size();
   std::vector<std::vector<float>> fit_params;
   std::vector<float> fit_params_tmp;
@@ -153,13 +128,99 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
   return fit_params;
 }
 
-void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax)
+void CaloWaveformFitting::calo_processing_templatefit(CaloWaveformBatch &batch)
+{
+  batch.find_peaks();
+  auto func = [&](int ich)
+  {
+    float v[CaloWaveformBatch::max_samples];
+    batch.get_waveform(ich, v);
+    // the vector version searches the maximum starting from 0
+    float maxheight = batch.get_maxheight(ich);
+    int maxbin = batch.get_maxbin(ich);
+    if (maxheight <= 0)
+    {
+      maxheight = 0;
+      maxbin = 0;
+    }
+    float result[4];
+    templatefit_channel(v, batch.get_nsamples(ich), maxheight, maxbin, result);
+    batch.set_result(ich, result[0], result[1], result[2], result[3]);
+  };
+
+  for_each_channel(batch.get_nchannels(), func);
+}
+
+void CaloWaveformFitting::templatefit_channel(const float *v, int size1, float maxheight, int maxbin, float *result) const
+{
+  if (size1 == _nzerosuppresssamples)
+  {
+    result[0] = v[1] - v[0];  // returns peak sample - pedestal sample
+    result[1] = -1;           // set time to -1 to indicate zero suppressed
+    result[2] = v[0];
+    result[3] = 0;
+    return;
+  }
+
+  float pedestal = 1500;
+  if (maxbin > 4)
+  {
+    pedestal = 0.5 * (v[maxbin - 4] + v[maxbin - 5]);
+  }
+  else if (maxbin > 3)
+  {
+    pedestal = (v[maxbin - 4]);
+  }
+  else
+  {
+    pedestal = 0.5 * (v[size1 - 3] + v[size1 - 2]);
+  }
+
+  if ((_bdosoftwarezerosuppression && v[6] - v[0] < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+  {
+    result[0] = v[6] - v[0];
+    result[1] = -1;
+    result[2] = v[0];
+    result[3] = 0;
+    return;
+  }
+
+  double time_min = -1 * m_peakTimeTemp;  // set lim on time par
+  double time_max = size1 - m_peakTimeTemp;
+  if (m_setTimeLim)
+  {
+    time_min = m_timeLim_low;
+    time_max = m_timeLim_high;
+  }
+  double amplitude = maxheight - pedestal;
+  double time = maxbin - m_peakTimeTemp;
+  double ped = pedestal;
+  double chi2min = 0;
+  m_template_fit.fit(v, size1, time_min, time_max, amplitude, time, ped, chi2min);
+  chi2min /= size1 - 3;  // divide by the number of dof
+  result[0] = amplitude;
+  result[1] = time;
+  result[2] = ped;
+  result[3] = chi2min;
+}
+
+void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax) const
 {
-  int n = 3;
   double xp[3] = {x0, x1, x2};
   double yp[3] = {y0, y1, y2};
-  TSpline3 *sp = new TSpline3("", xp, yp, n, "b2e2", 0, 0);
-  double X, Y, B, C, D;
+  // cubic spline with zero second derivative at both ends ("b2e2"),
+  // coefficients of y = Y + B dx + C dx^2 + D dx^3 per segment as in TSpline3
+  double h0 = xp[1] - xp[0];
+  double h1 = xp[2] - xp[1];
+  double M1 = 3 * ((yp[2] - yp[1]) / h1 - (yp[1] - yp[0]) / h0) / (h0 + h1);
+  double coeffs[2][4] = {{yp[0], (yp[1] - yp[0]) / h0 - h0 * M1 / 6, 0, M1 / (6 * h0)},
+                         {yp[1], (yp[2] - yp[1]) / h1 - h1 * M1 / 3, M1 / 2, -M1 / (6 * h1)}};
+  auto eval = [&](int i, double x)
+  {
+    double dx = x - xp[i];
+    return coeffs[i][0] + dx * (coeffs[i][1] + dx * (coeffs[i][2] + dx * coeffs[i][3]));
+  };
+  double X, B, C, D;
   ymax = y1;
   xmax = x1;
   if (y0 > ymax)
@@ -174,7 +235,10 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
   }
   for (int i = 0; i <= 1; i++)
   {
-    sp->GetCoeff(i, X, Y, B, C, D);
+    X = xp[i];
+    B = coeffs[i][1];
+    C = coeffs[i][2];
+    D = coeffs[i][3];
     if (D == 0)
     {
       if (C < 0)
@@ -184,7 +248,7 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
         float root = -B / (2 * C) + X;
         if (root >= xp[i] && root <= xp[i + 1])
         {
-          float yvalue = sp->Eval(root);
+          float yvalue = eval(i, root);
           if (yvalue > ymax)
           {
             ymax = yvalue;
@@ -199,7 +263,7 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
       float root = (-2 * C + sqrt(4 * C * C - 12 * B * D)) / (6 * D) + X;
       if (root >= xp[i] && root <= xp[i + 1])
       {
-        float yvalue = sp->Eval(root);
+        float yvalue = eval(i, root);
         if (yvalue > ymax)
         {
           ymax = yvalue;
@@ -209,7 +273,7 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
       root = (-2 * C - sqrt(4 * C * C - 12 * B * D)) / (6 * D) + X;
       if (root >= xp[i] && root <= xp[i + 1])
       {
-        float yvalue = sp->Eval(root);
+        float yvalue = eval(i, root);
         if (yvalue > ymax)
         {
           ymax = yvalue;
@@ -218,16 +282,15 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
       }
     }
   }
-  delete sp;
   return;
 }
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(std::vector<std::vector<float>> chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
   int nchnls = chnlvector.size();
-  for (int m = 0; m < nchnls; m++)
+  std::vector<std::vector<float>> fit_values(nchnls);
+  auto func = [&](int m)
   {
-    std::vector<float> v = chnlvector.at(m);
+    const std::vector<float> &v = chnlvector.at(m);
     int nsamples = v.size();
 
     double maxy = v.at(0);
@@ -272,40 +335,120 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(std::v
       }
     }
     amp -= ped;
-    std::vector<float> val = {amp, time, ped, 0};
-    fit_values.push_back(val);
-    val.clear();
-  }
+    fit_values[m] = {amp, time, ped, 0};
+  };
+
+  for_each_channel(nchnls, func);
   return fit_values;
 }
 
+void CaloWaveformFitting::calo_processing_fast(CaloWaveformBatch &batch)
+{
+  batch.find_peaks();
+  int nchnls = batch.get_nchannels();
+  int nsamples = batch.get_nsamples();
+
+  // average of the first 3 samples, across channels
+  if (nsamples >= 3)
+  {
+    const int16_t *s0 = batch.get_row(0);
+    const int16_t *s1 = batch.get_row(1);
+    const int16_t *s2 = batch.get_row(2);
+    for (int m = 0; m < nchnls; m++)
+    {
+      batch.set_pedestal(m, (static_cast<float>(s0[m]) + s1[m] + s2[m]) / 3);
+    }
+  }
+
+  auto func = [&](int m)
+  {
+    int n = batch.get_nsamples(m);
+    float amp = 0;
+    float time = 0;
+    float ped = 0;
+    if (n == 2)
+    {
+      amp = batch.get_sample(m, 1);
+      time = -1;
+      ped = batch.get_sample(m, 0);
+    }
+    else if (n >= 3)
+    {
+      int maxx = batch.get_maxbin(m);
+      float maxy = batch.get_maxheight(m);
+      ped = batch.get_pedestal(m);
+      // if maxx <=5 nsample >=10 use the last two sample for pedestal(for HCal TP)
+      if (maxx <= 5 && n >= 10)
+      {
+        ped = 0.5 * (batch.get_sample(m, n - 2) + batch.get_sample(m, n - 1));
+      }
+      if (maxx == 0 || maxx == n - 1)
+      {
+        amp = maxy;
+        time = maxx;
+      }
+      else
+      {
+        FastMax(maxx - 1, maxx, maxx + 1, batch.get_sample(m, maxx - 1), batch.get_sample(m, maxx), batch.get_sample(m, maxx + 1), time, amp);
+      }
+    }
+    amp -= ped;
+    batch.set_result(m, amp, time, ped, 0);
+  };
+
+  for_each_channel(nchnls, func);
+}
+
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_nyquist(std::vector<std::vector<float>> chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
   int nchnls = chnlvector.size();
-  for (int m = 0; m < nchnls; m++)
+  std::vector<std::vector<float>> fit_values(nchnls);
+  auto func = [&](int m)
   {
-    std::vector<float> v = chnlvector.at(m);
+    const std::vector<float> &v = chnlvector.at(m);
     int nsamples = (int)v.size();
 
     if (nsamples == 2)
     {
-      fit_values.push_back({v.at(1) - v.at(0), -1, v.at(0), 0});
-      continue;
+      fit_values[m] = {v.at(1) - v.at(0), -1, v.at(0), 0};
+      return;
     }
     
-    std::vector<float> result = NyquistInterpolation(v);
-    fit_values.push_back(result);
-  }
+    fit_values[m].resize(4);
+    NyquistInterpolation(v.data(), nsamples, fit_values[m].data());
+  };
+
+  for_each_channel(nchnls, func);
   return fit_values;
 
 }
-//mabye I can find a way to make it thread safe
-std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float> &vec_signal_samples)
+
+void CaloWaveformFitting::calo_processing_nyquist(CaloWaveformBatch &batch)
+{
+  auto func = [&](int m)
+  {
+    int nsamples = batch.get_nsamples(m);
+    float v[CaloWaveformBatch::max_samples];
+    batch.get_waveform(m, v);
+
+    if (nsamples == 2)
+    {
+      batch.set_result(m, v[1] - v[0], -1, v[0], 0);
+      return;
+    }
+
+    float result[4];
+    NyquistInterpolation(v, nsamples, result);
+    batch.set_result(m, result[0], result[1], result[2], result[3]);
+  };
+
+  for_each_channel(batch.get_nchannels(), func);
+}
+// reentrant, only reads the samples and the tabulated template
+void CaloWaveformFitting::NyquistInterpolation(const float *vec_signal_samples, int N, float *result) const
 {
-  // int N = (int) vec_signal_samples.size();
-  auto max_elem_iter = std::max_element(vec_signal_samples.begin(), vec_signal_samples.end());
-  int maxx = std::distance(vec_signal_samples.begin(), max_elem_iter);
+  const float *max_elem_iter = std::max_element(vec_signal_samples, vec_signal_samples + N);
+  int maxx = std::distance(vec_signal_samples, max_elem_iter);
   float max = *max_elem_iter;
 
   float maxpos = maxx;
@@ -322,7 +465,7 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
 
       float yval = max;
       if(i != maxpos){ 
-        yval = psinc(i, vec_signal_samples);
+        yval = psinc(i, vec_signal_samples, N);
        
       }
       if (yval > max)
@@ -354,7 +497,7 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
     pedestal = max;
     for (float i = maxpos - 5; i < maxpos; i += 0.1)
     {
-      float yval = psinc(i, vec_signal_samples);
+      float yval = psinc(i, vec_signal_samples, N);
       if (yval < pedestal)
       {
         pedestal = yval;
@@ -364,17 +507,19 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
   //calculate chi2 using the tempalte
   float chi2 = 0;
   double par[3] = {max - pedestal, maxpos - m_peakTimeTemp, pedestal};
-  for(int i = 0; i < (int)vec_signal_samples.size(); i++){
+  for(int i = 0; i < N; i++){
     double xval[1] = {(double)i};
     float diff = vec_signal_samples[i] - template_function(xval, par);
     chi2 += diff*diff;
   }
-  std::vector<float> val = {max - pedestal, maxpos, pedestal, chi2};
-  return val;
+  result[0] = max - pedestal;
+  result[1] = maxpos;
+  result[2] = pedestal;
+  result[3] = chi2;
 }
 
 // for odd N
-double CaloWaveformFitting::Dkernelodd(double x, int N)
+double CaloWaveformFitting::Dkernelodd(double x, int N) const
 {
   double sum = 0;
   for (int k = 0; k < (N + 1) / 2; k++)
@@ -387,7 +532,7 @@ double CaloWaveformFitting::Dkernelodd(double x, int N)
 }
 
 // for even N
-double CaloWaveformFitting::Dkernel(double x, int N)
+double CaloWaveformFitting::Dkernel(double x, int N) const
 {
   double sum = 0;
   for (int k = 0; k < N / 2; k++)
@@ -400,9 +545,8 @@ double CaloWaveformFitting::Dkernel(double x, int N)
   return sum;
 }
 
-float CaloWaveformFitting::stablepsinc(float time, std::vector<float> &vec_signal_samples)
+float CaloWaveformFitting::stablepsinc(float time, const float *vec_signal_samples, int N) const
 {
-  int N = (int) vec_signal_samples.size();
   float sum = 0;
   if (N % 2 == 0)
   {
@@ -421,20 +565,19 @@ float CaloWaveformFitting::stablepsinc(float time, std::vector<float> &vec_signa
   return sum;
 }
 
-float CaloWaveformFitting::psinc(float time, std::vector<float> &vec_signal_samples)
+float CaloWaveformFitting::psinc(float time, const float *vec_signal_samples, int N) const
 {
-  int N = (int) vec_signal_samples.size();
 
   if (abs(std::round(time) - time) < 1e-6)
   {
  
     if (time < 0 || time >= N)
     {
-      return stablepsinc(time, vec_signal_samples);
+      return stablepsinc(time, vec_signal_samples, N);
     }
     else
     {
-      return vec_signal_samples.at(std::round(time));
+      return vec_signal_samples[(int) std::round(time)];
     }
   }
 
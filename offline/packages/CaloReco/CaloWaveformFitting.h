@@ -1,16 +1,24 @@
 #ifndef CALORECO_CALOWAVEFORMFITTING_H
 #define CALORECO_CALOWAVEFORMFITTING_H
 
+#include "CaloWaveformTemplateFit.h"
+
+#include <memory>
 #include <string>
 #include <vector>
 
+class CaloWaveformBatch;
 class TProfile;
+namespace ROOT
+{
+  class TThreadExecutor;
+}
 
 class CaloWaveformFitting
 {
  public:
-  CaloWaveformFitting() = default;
-  ~CaloWaveformFitting() = default;
+  CaloWaveformFitting();
+  ~CaloWaveformFitting();
 
   void set_template_file(const std::string &template_input_file)
   {
@@ -18,11 +26,9 @@ class CaloWaveformFitting
     return;
   }
 
-  void set_nthreads(int nthreads)
-  {
-    _nthreads = nthreads;
-    return;
-  }
+  //! number of workers the channels of an event are split over, the
+  //! fits are reentrant so any method can run on several threads
+  void set_nthreads(int nthreads);
 
   void set_softwarezerosuppression(bool usezerosuppression, int softwarezerosuppression)
   {
@@ -52,20 +58,32 @@ class CaloWaveformFitting
   std::vector<std::vector<float>> calo_processing_fast(std::vector<std::vector<float>> chnlvector);
   std::vector<std::vector<float>> calo_processing_nyquist(std::vector<std::vector<float>> chnlvector);
 
+  // same on all channels of a batch, results are stored in the batch
+  void calo_processing_templatefit(CaloWaveformBatch &batch);
+  void calo_processing_fast(CaloWaveformBatch &batch);
+  void calo_processing_nyquist(CaloWaveformBatch &batch);
+
   void initialize_processing(const std::string &templatefile);
 
  private:
-  void FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax);
-  std::vector<float> NyquistInterpolation(std::vector<float> &vec_signal_samples);
-  double Dkernelodd(double x, int N);
-  double Dkernel(double x, int N);
+  void FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax) const;
+  // run func(channel) for all channels, in chunks over the workers
+  template <typename Func>
+  void for_each_channel(int nchannels, Func func);
+  // fit of one channel of size1 samples, result = amplitude, time, pedestal, chi2
+  void templatefit_channel(const float *v, int size1, float maxheight, int maxbin, float *result) const;
+  void NyquistInterpolation(const float *vec_signal_samples, int N, float *result) const;
+  double Dkernelodd(double x, int N) const;
+  double Dkernel(double x, int N) const;
 
-  float stablepsinc(float t, std::vector<float> &vec_signal_samples);
+  float stablepsinc(float t, const float *vec_signal_samples, int N) const;
 
-  float psinc(float t, std::vector<float> &vec_signal_samples);
+  float psinc(float t, const float *vec_signal_samples, int N) const;
   TProfile *h_template = nullptr;
-  double template_function(double *x, double *par);
+  CaloWaveformTemplateFit m_template_fit;
+  double template_function(double *x, double *par) const;
   int _nthreads{1};
+  std::unique_ptr<ROOT::TThreadExecutor> m_executor;
   int _nzerosuppresssamples{2};
   int _nsoftwarezerosuppression{40};
 //  float _stepsize{0.001};
@@ -1,4 +1,5 @@
 #include "CaloWaveformProcessing.h"
+#include "CaloWaveformBatch.h"
 #include "CaloWaveformFitting.h"
 
 #include <ffamodules/CDBInterface.h>
@@ -29,7 +30,7 @@ void CaloWaveformProcessing::initialize_processing()
     url_template = CDBInterface::instance()->getUrl(m_template_name, calibrations_repo_template);
     m_Fitter = new CaloWaveformFitting();
     m_Fitter->initialize_processing(url_template);
-    m_Fitter->set_nthreads(get_nthreads());
+    m_Fitter->set_nthreads(_nthreads);
     if (m_setTimeLim)
     {
       m_Fitter->set_timeFitLim(m_timeLim_low,m_timeLim_high);
@@ -46,12 +47,18 @@ void CaloWaveformProcessing::initialize_processing()
     url_onnx = CDBInterface::instance()->getUrl(m_model_name, calibrations_repo_model);
     onnxmodule = onnxSession(url_onnx);
   }
+  else if (m_processingtype == CaloWaveformProcessing::FAST)
+  {
+    m_Fitter = new CaloWaveformFitting();
+    m_Fitter->set_nthreads(_nthreads);
+  }
   else if (m_processingtype == CaloWaveformProcessing::NYQUIST)
   {
     std::string calibrations_repo_template = std::string(calibrationsroot) + "/WaveformProcessing/templates/" + m_template_input_file;
     url_template = CDBInterface::instance()->getUrl(m_template_name, calibrations_repo_template);
     m_Fitter = new CaloWaveformFitting();
     m_Fitter->initialize_processing(url_template);
+    m_Fitter->set_nthreads(_nthreads);
   }
 }
 
@@ -82,6 +89,38 @@ std::vector<std::vector<float>> CaloWaveformProcessing::process_waveform(std::ve
   return fitresults;
 }
 
+void CaloWaveformProcessing::process_waveform(CaloWaveformBatch &batch)
+{
+  if (m_processingtype == CaloWaveformProcessing::TEMPLATE)
+  {
+    m_Fitter->calo_processing_templatefit(batch);
+  }
+  if (m_processingtype == CaloWaveformProcessing::ONNX)
+  {
+    // no batched inference, go through the per channel vectors
+    int nchannels = batch.get_nchannels();
+    std::vector<std::vector<float>> waveformvector(nchannels);
+    for (int i = 0; i < nchannels; i++)
+    {
+      waveformvector[i].resize(batch.get_nsamples(i));
+      batch.get_waveform(i, waveformvector[i].data());
+    }
+    std::vector<std::vector<float>> fitresults = CaloWaveformProcessing::calo_processing_ONNX(waveformvector);
+    for (int i = 0; i < nchannels; i++)
+    {
+      batch.set_result(i, fitresults[i].at(0), fitresults[i].at(1), fitresults[i].at(2), fitresults[i].size() > 3 ? fitresults[i].at(3) : 0);
+    }
+  }
+  if (m_processingtype == CaloWaveformProcessing::FAST)
+  {
+    m_Fitter->calo_processing_fast(batch);
+  }
+  if (m_processingtype == CaloWaveformProcessing::NYQUIST)
+  {
+    m_Fitter->calo_processing_nyquist(batch);
+  }
+}
+
 std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(std::vector<std::vector<float>> chnlvector)
 {
   std::vector<std::vector<float>> fit_values;
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+class CaloWaveformBatch;
 class CaloWaveformFitting;
 
 class CaloWaveformProcessing : public SubsysReco
@@ -70,6 +71,8 @@ class CaloWaveformProcessing : public SubsysReco
 
 
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
+  //! process all channels of the batch in place
+  void process_waveform(CaloWaveformBatch &batch);
   std::vector<std::vector<float>> calo_processing_ONNX(std::vector<std::vector<float>> chnlvector);
 
   void initialize_processing();
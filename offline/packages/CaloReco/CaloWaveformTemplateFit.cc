@@ -0,0 +1,204 @@
+#include "CaloWaveformTemplateFit.h"
+
+#include <TProfile.h>
+
+#include <algorithm>  // for clamp
+#include <cmath>
+
+void CaloWaveformTemplateFit::set_template(const TProfile *h_template)
+{
+  m_coeffs.clear();
+  int n = h_template->GetNbinsX();
+  if (n < 2)
+  {
+    return;
+  }
+  m_nknots = n;
+  m_xmin = h_template->GetBinCenter(1);
+  m_dx = h_template->GetBinWidth(1);
+  m_value_low = h_template->GetBinContent(1);
+  m_value_high = h_template->GetBinContent(n);
+
+  std::vector<double> y(n);
+  for (int k = 0; k < n; k++)
+  {
+    y[k] = h_template->GetBinContent(k + 1);
+  }
+
+  // natural spline, second derivatives M from
+  // M[k-1] + 4 M[k] + M[k+1] = 6 (y[k+1] - 2 y[k] + y[k-1]) / dx^2, M[0] = M[n-1] = 0
+  std::vector<double> M(n, 0.);
+  std::vector<double> cprime(n, 0.);
+  for (int k = 1; k < n - 1; k++)
+  {
+    double rhs = 6 * (y[k + 1] - 2 * y[k] + y[k - 1]) / (m_dx * m_dx);
+    double denom = 4 - cprime[k - 1];
+    cprime[k] = 1 / denom;
+    M[k] = (rhs - M[k - 1]) / denom;
+  }
+  for (int k = n - 3; k > 0; k--)
+  {
+    M[k] -= cprime[k] * M[k + 1];
+  }
+
+  m_coeffs.resize(4 * (n - 1));
+  for (int k = 0; k < n - 1; k++)
+  {
+    double *c = &m_coeffs[4 * k];
+    c[0] = y[k];
+    c[1] = (y[k + 1] - y[k]) / m_dx - m_dx * (2 * M[k] + M[k + 1]) / 6;
+    c[2] = M[k] / 2;
+    c[3] = (M[k + 1] - M[k]) / (6 * m_dx);
+  }
+}
+
+void CaloWaveformTemplateFit::eval(double x, double &value, double &derivative) const
+{
+  double u = (x - m_xmin) / m_dx;
+  if (!(u >= 0))
+  {
+    value = m_value_low;
+    derivative = 0;
+    return;
+  }
+  if (u >= m_nknots - 1)
+  {
+    value = m_value_high;
+    derivative = 0;
+    return;
+  }
+  int k = static_cast<int>(u);
+  double t = x - (m_xmin + k * m_dx);
+  const double *c = &m_coeffs[4 * k];
+  value = c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+  derivative = c[1] + t * (2 * c[2] + t * 3 * c[3]);
+}
+
+double CaloWaveformTemplateFit::interpolate(double x) const
+{
+  double u = (x - m_xmin) / m_dx;
+  if (!(u >= 0))
+  {
+    return m_value_low;
+  }
+  if (u >= m_nknots - 1)
+  {
+    return m_value_high;
+  }
+  int k = static_cast<int>(u);
+  double y0 = m_coeffs[4 * k];
+  double y1 = (k + 1 < m_nknots - 1) ? m_coeffs[4 * (k + 1)] : m_value_high;
+  return y0 + (u - k) * (y1 - y0);
+}
+
+double CaloWaveformTemplateFit::accumulate(const float *samples, int nsamples, const double *par, double JTJ[3][3], double *JTr) const
+{
+  for (int i = 0; i < 3; i++)
+  {
+    JTr[i] = 0;
+    for (int j = 0; j < 3; j++)
+    {
+      JTJ[i][j] = 0;
+    }
+  }
+
+  double chi2 = 0;
+  for (int isample = 0; isample < nsamples; isample++)
+  {
+    double value;
+    double derivative;
+    eval(isample - par[1], value, derivative);
+    double residual = samples[isample] - (par[0] * value + par[2]);
+    // derivatives of the model with respect to amplitude, time and pedestal
+    double J[3] = {value, -par[0] * derivative, 1};
+    for (int i = 0; i < 3; i++)
+    {
+      JTr[i] += J[i] * residual;
+      for (int j = i; j < 3; j++)
+      {
+        JTJ[i][j] += J[i] * J[j];
+      }
+    }
+    chi2 += residual * residual;
+  }
+  JTJ[1][0] = JTJ[0][1];
+  JTJ[2][0] = JTJ[0][2];
+  JTJ[2][1] = JTJ[1][2];
+
+  return chi2;
+}
+
+bool CaloWaveformTemplateFit::fit(const float *samples, int nsamples, double time_min, double time_max,
+                                  double &amplitude, double &time, double &pedestal, double &chi2) const
+{
+  double par[3] = {amplitude, std::clamp(time, time_min, time_max), pedestal};
+  double JTJ[3][3];
+  double JTr[3];
+  chi2 = accumulate(samples, nsamples, par, JTJ, JTr);
+
+  double lambda = 1e-3;
+  for (int iter = 0; iter < m_max_iterations && chi2 > 0; iter++)
+  {
+    // damped normal equations, solved by Cramer's rule
+    double A[3][3];
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        A[i][j] = JTJ[i][j];
+      }
+      A[i][i] *= 1 + lambda;
+    }
+    double c00 = A[1][1] * A[2][2] - A[1][2] * A[2][1];
+    double c01 = A[1][2] * A[2][0] - A[1][0] * A[2][2];
+    double c02 = A[1][0] * A[2][1] - A[1][1] * A[2][0];
+    double det = A[0][0] * c00 + A[0][1] * c01 + A[0][2] * c02;
+    if (!(std::fabs(det) > 0))
+    {
+      // amplitude 0 leaves the time undetermined
+      break;
+    }
+    double delta[3];
+    delta[0] = (JTr[0] * c00 + JTr[1] * (A[0][2] * A[2][1] - A[0][1] * A[2][2]) + JTr[2] * (A[0][1] * A[1][2] - A[0][2] * A[1][1])) / det;
+    delta[1] = (JTr[0] * c01 + JTr[1] * (A[0][0] * A[2][2] - A[0][2] * A[2][0]) + JTr[2] * (A[0][2] * A[1][0] - A[0][0] * A[1][2])) / det;
+    delta[2] = (JTr[0] * c02 + JTr[1] * (A[0][1] * A[2][0] - A[0][0] * A[2][1]) + JTr[2] * (A[0][0] * A[1][1] - A[0][1] * A[1][0])) / det;
+
+    double trial[3] = {par[0] + delta[0], std::clamp(par[1] + delta[1], time_min, time_max), par[2] + delta[2]};
+    double trialJTJ[3][3];
+    double trialJTr[3];
+    double trialchi2 = accumulate(samples, nsamples, trial, trialJTJ, trialJTr);
+    if (trialchi2 <= chi2)
+    {
+      bool converged = (chi2 - trialchi2 <= 1e-9 * chi2) && std::fabs(trial[1] - par[1]) < 1e-5;
+      for (int i = 0; i < 3; i++)
+      {
+        par[i] = trial[i];
+        JTr[i] = trialJTr[i];
+        for (int j = 0; j < 3; j++)
+        {
+          JTJ[i][j] = trialJTJ[i][j];
+        }
+      }
+      chi2 = trialchi2;
+      lambda = std::max(lambda * 0.1, 1e-9);
+      if (converged)
+      {
+        break;
+      }
+    }
+    else
+    {
+      lambda *= 10;
+      if (lambda > 1e9)
+      {
+        // no step reduces the chi2 any more
+        break;
+      }
+    }
+  }
+
+  amplitude = par[0];
+  time = par[1];
+  pedestal = par[2];
+  return std::isfinite(chi2);
+}
@@ -0,0 +1,60 @@
+#ifndef CALORECO_CALOWAVEFORMTEMPLATEFIT_H
+#define CALORECO_CALOWAVEFORMTEMPLATEFIT_H
+
+#include <vector>
+
+class TProfile;
+
+/// \class CaloWaveformTemplateFit
+///
+/// \brief least squares fit of amplitude * template(x - time) + pedestal
+///
+/// The template profile is tabulated once as a natural cubic spline
+/// through its bin centers, one set of coefficients per bin, which gives
+/// the template and its derivative at any time with a single lookup.
+/// Outside the profile the first/last bin content is used, as in
+/// TH1::Interpolate.
+///
+/// The fit itself is a Levenberg-Marquardt iteration on the 3 parameters
+/// with the normal equations accumulated and solved on the stack, so
+/// fitting a channel does not allocate and fit() can be called from
+/// several threads at once.
+///
+class CaloWaveformTemplateFit
+{
+ public:
+  CaloWaveformTemplateFit() = default;
+  ~CaloWaveformTemplateFit() = default;
+
+  //! tabulate the template, the profile is not used afterwards
+  void set_template(const TProfile *h_template);
+  bool has_template() const { return !m_coeffs.empty(); }
+
+  void set_max_iterations(int n) { m_max_iterations = n; }
+
+  //! template value and derivative at x
+  void eval(double x, double &value, double &derivative) const;
+  //! linear interpolation between the bin centers, as TH1::Interpolate
+  double interpolate(double x) const;
+
+  //! fit samples[0..nsamples-1] with unit errors, starting from the given
+  //! parameters, with the time limited to [time_min, time_max]. chi2 is
+  //! the sum of squared residuals, returns false if it is not finite
+  bool fit(const float *samples, int nsamples, double time_min, double time_max,
+           double &amplitude, double &time, double &pedestal, double &chi2) const;
+
+ private:
+  double accumulate(const float *samples, int nsamples, const double *par, double JTJ[3][3], double *JTr) const;
+
+  double m_xmin{0};
+  double m_dx{1};
+  int m_nknots{0};
+  // per segment between knots: a, b, c, d of a + b u + c u^2 + d u^3, u = x - knot
+  std::vector<double> m_coeffs;
+  double m_value_low{0};
+  double m_value_high{0};
+
+  int m_max_iterations{20};
+};
+
+#endif
@@ -32,8 +32,10 @@
 
 #include <cassert>
 #include <iostream>
+#include <numeric>  // for iota
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 DeadHotMapLoader::DeadHotMapLoader(const std::string &detector)
   : SubsysReco("DeadHotMapLoader_" + detector)
@@ -99,11 +101,12 @@ int DeadHotMapLoader::InitRun(PHCompositeNode *topNode)
       etabins = 24;
       phibins = 64;
 
-     
+      std::vector<int> channels(etabins * phibins);
+      std::iota(channels.begin(), channels.end(), 0);
+      std::vector<int> status = m_CDBTTree->GetIntValues(channels, "status");
       for(int i = 0; i < etabins*phibins; i++)
 	{
-	  int isDead = m_CDBTTree->GetIntValue(i,"status");
-	  if(isDead > 0)
+	  if(status[i] > 0)
 	    {
 	      unsigned int key = TowerInfoDefs::encode_hcal(i);
 	      int ieta = TowerInfoDefs::getCaloTowerEtaBin(key);
@@ -118,10 +121,12 @@ int DeadHotMapLoader::InitRun(PHCompositeNode *topNode)
       etabins = 96;
       phibins = 256;
 
-      for(int i = 0; i < 96*256; i++)
+      std::vector<int> channels(etabins * phibins);
+      std::iota(channels.begin(), channels.end(), 0);
+      std::vector<int> status = m_CDBTTree->GetIntValues(channels, "status");
+      for(int i = 0; i < etabins*phibins; i++)
 	{
-	  int isDead = m_CDBTTree->GetIntValue(i,"status");
-	  if(isDead > 0)
+	  if(status[i] > 0)
 	    {
 	      unsigned int key = TowerInfoDefs::encode_emcal(i);
 	      int ieta = TowerInfoDefs::getCaloTowerEtaBin(key);
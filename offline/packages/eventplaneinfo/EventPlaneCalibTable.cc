@@ -0,0 +1,118 @@
+#include "EventPlaneCalibTable.h"
+
+#include <TProfile2D.h>
+
+#include <vector>  // for vector
+
+bool EventPlaneCalibTable::build(TProfile2D *const *mean_cos, TProfile2D *const *mean_sin,
+                                 TProfile2D *(*shift_cos)[6], TProfile2D *(*shift_sin)[6],
+                                 unsigned int norders, unsigned int nterms)
+{
+  m_norders = norders;
+  m_nterms = nterms;
+  m_has_recentering.assign(norders, false);
+  m_has_shift.assign(norders * nterms, false);
+  m_bin_row.clear();
+  m_coeffs.clear();
+
+  std::vector<const TProfile2D *> profiles;
+  for (unsigned int order = 0; order < norders; order++)
+  {
+    if (mean_cos[order] && mean_sin[order])
+    {
+      m_has_recentering[order] = true;
+      profiles.push_back(mean_cos[order]);
+      profiles.push_back(mean_sin[order]);
+    }
+    for (unsigned int p = 0; p < nterms; p++)
+    {
+      if (shift_cos[order][p] && shift_sin[order][p])
+      {
+        m_has_shift[order * nterms + p] = true;
+        profiles.push_back(shift_cos[order][p]);
+        profiles.push_back(shift_sin[order][p]);
+      }
+    }
+  }
+
+  if (profiles.empty())
+  {
+    return true;
+  }
+
+  // every profile is looked up with the bin of the first one
+  const TProfile2D *ref = profiles.front();
+  for (const TProfile2D *h : profiles)
+  {
+    if (h->GetNbinsX() != ref->GetNbinsX() || h->GetNbinsY() != ref->GetNbinsY() ||
+        h->GetXaxis()->GetXmin() != ref->GetXaxis()->GetXmin() || h->GetXaxis()->GetXmax() != ref->GetXaxis()->GetXmax() ||
+        h->GetYaxis()->GetXmin() != ref->GetYaxis()->GetXmin() || h->GetYaxis()->GetXmax() != ref->GetYaxis()->GetXmax())
+    {
+      return false;
+    }
+  }
+  m_xaxis = *ref->GetXaxis();
+  m_yaxis = *ref->GetYaxis();
+
+  // rows for the bins with entries in any profile
+  int nbins = (ref->GetNbinsX() + 2) * (ref->GetNbinsY() + 2);
+  m_bin_row.assign(nbins, -1);
+  int nrows = 0;
+  for (int bin = 0; bin < nbins; bin++)
+  {
+    for (const TProfile2D *h : profiles)
+    {
+      if (h->GetBinEntries(bin) > 0)
+      {
+        m_bin_row[bin] = nrows++;
+        break;
+      }
+    }
+  }
+
+  unsigned int row_size = norders * stride();
+  m_coeffs.assign(nrows * row_size, 0.);
+  for (int bin = 0; bin < nbins; bin++)
+  {
+    if (m_bin_row[bin] < 0)
+    {
+      continue;
+    }
+    double *row = &m_coeffs[m_bin_row[bin] * row_size];
+    for (unsigned int order = 0; order < norders; order++)
+    {
+      double *coeffs = row + order * stride();
+      if (m_has_recentering[order])
+      {
+        coeffs[0] = mean_cos[order]->GetBinContent(bin);
+        coeffs[1] = mean_sin[order]->GetBinContent(bin);
+      }
+      for (unsigned int p = 0; p < nterms; p++)
+      {
+        if (m_has_shift[order * nterms + p])
+        {
+          coeffs[2 + p] = shift_cos[order][p]->GetBinContent(bin);
+          coeffs[2 + nterms + p] = shift_sin[order][p]->GetBinContent(bin);
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+const double *EventPlaneCalibTable::lookup(double x, double y) const
+{
+  if (m_bin_row.empty())
+  {
+    return nullptr;
+  }
+
+  int bin = m_xaxis.FindFixBin(x) + (m_xaxis.GetNbins() + 2) * m_yaxis.FindFixBin(y);
+  int row = m_bin_row[bin];
+  if (row < 0)
+  {
+    return nullptr;
+  }
+  return &m_coeffs[row * m_norders * stride()];
+}
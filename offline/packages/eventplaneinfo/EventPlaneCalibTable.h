@@ -0,0 +1,60 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef EVENTPLANECALIBTABLE_H
+#define EVENTPLANECALIBTABLE_H
+
+#include <TAxis.h>
+
+#include <vector>
+
+class TProfile2D;
+
+/// \class EventPlaneCalibTable
+///
+/// \brief flat copy of the event plane recentering and shift profiles of one side
+///
+/// The recentering (<cos n psi>, <sin n psi>) and shift (<cos i n psi>,
+/// <sin i n psi>) profiles are binned in the same (charge, z-vertex) grid.
+/// All their bin contents are copied at InitRun into one row per occupied
+/// bin, so an event does a single bin lookup and reads the coefficients
+/// of all orders and terms from one contiguous block. Empty bins give no
+/// row, as their contents are zero.
+///
+/// Row layout per order: mean cos, mean sin, shift cos[nterms], shift sin[nterms].
+///
+class EventPlaneCalibTable
+{
+ public:
+  EventPlaneCalibTable() = default;
+  ~EventPlaneCalibTable() = default;
+
+  //! copy the profiles ([order] and [order][term]), missing profiles are
+  //! flagged as such. Returns false if the profiles do not share one binning
+  bool build(TProfile2D *const *mean_cos, TProfile2D *const *mean_sin,
+             TProfile2D *(*shift_cos)[6], TProfile2D *(*shift_sin)[6],
+             unsigned int norders, unsigned int nterms);
+
+  bool has_recentering(unsigned int order) const { return m_has_recentering[order]; }
+  bool has_shift(unsigned int order, unsigned int term) const { return m_has_shift[order * m_nterms + term]; }
+
+  //! coefficients of the bin of (x, y), nullptr if the bin is empty
+  const double *lookup(double x, double y) const;
+
+  unsigned int stride() const { return 2 + 2 * m_nterms; }
+  unsigned int nrows() const { return m_coeffs.size() / (m_norders * stride()); }
+
+ private:
+  unsigned int m_norders{0};
+  unsigned int m_nterms{0};
+  std::vector<bool> m_has_recentering;
+  std::vector<bool> m_has_shift;
+
+  TAxis m_xaxis;
+  TAxis m_yaxis;
+
+  // global bin -> row, -1 if the bin is empty in all profiles
+  std::vector<int> m_bin_row;
+  std::vector<double> m_coeffs;
+};
+
+#endif  // EVENTPLANECALIBTABLE_H
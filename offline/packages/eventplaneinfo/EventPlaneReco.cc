@@ -119,6 +119,20 @@ int EventPlaneReco::InitRun(PHCompositeNode *topNode)
     }
   }
 
+  // copy the input histograms into per bin coefficient tables
+  if (!calib_south_mbd.build(tprof_mean_cos_south_mbd_input, tprof_mean_sin_south_mbd_input,
+                             tprof_cos_south_mbd_shift_input, tprof_sin_south_mbd_shift_input, m_MaxOrder, _imax) ||
+      !calib_north_mbd.build(tprof_mean_cos_north_mbd_input, tprof_mean_sin_north_mbd_input,
+                             tprof_cos_north_mbd_shift_input, tprof_sin_north_mbd_shift_input, m_MaxOrder, _imax))
+  {
+    std::cout << PHWHERE << " inconsistent binning of the event plane correction histograms in " << OutFileName << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // channel harmonics are filled with the first event of the run
+  epd_arm.clear();
+  mbd_arm.clear();
+
   cdbhistosIn->Print();
   //-----------------------------------create correction histograms-----------------------------------------//
 
@@ -229,37 +243,30 @@ int EventPlaneReco::process_event(PHCompositeNode *topNode)
       }
 
       unsigned int ntowers = epd_towerinfo->size();
+      if (epd_arm.size() != ntowers)
+      {
+        fill_epd_harmonics(epd_towerinfo, _epdgeom);
+      }
+
       for (unsigned int ch = 0; ch < ntowers; ch++)
       {
-        TowerInfo *_tower = epd_towerinfo->get_tower_at_channel(ch);
-        unsigned int key = TowerInfoDefs::encode_epd(ch);
-        float epd_e = _tower->get_energy();
+        float epd_e = epd_towerinfo->get_tower_at_channel(ch)->get_energy();
         if (epd_e < 0.5)
         {
           continue;
         }
-        float tile_phi = _epdgeom->get_phi(key);
-        int arm = TowerInfoDefs::get_epd_arm(key);
-        float truncated_e = (epd_e < _epd_e) ? epd_e : _epd_e;
-        if (arm == 0)
+        if (epd_arm[ch] != 0 && epd_arm[ch] != 1)
         {
-          for (unsigned int order = 0; order < m_MaxOrder; order++)
-          {
-            double Cosine = cos(tile_phi * (double) (order + 1));
-            double Sine = sin(tile_phi * (double) (order + 1));
-            south_q[order][0] += truncated_e * Cosine;  // south Qn,x
-            south_q[order][1] += truncated_e * Sine;    // south Qn,y
-          }
+          continue;
         }
-        else if (arm == 1)
+        float truncated_e = (epd_e < _epd_e) ? epd_e : _epd_e;
+        std::vector<std::vector<double>> &q = (epd_arm[ch] == 0 ? south_q : north_q);  // south or north
+        const double *Cosine = &epd_cos[ch * m_MaxOrder];
+        const double *Sine = &epd_sin[ch * m_MaxOrder];
+        for (unsigned int order = 0; order < m_MaxOrder; order++)
         {
-          for (unsigned int order = 0; order < m_MaxOrder; order++)
-          {
-            double Cosine = cos(tile_phi * (double) (order + 1));
-            double Sine = sin(tile_phi * (double) (order + 1));
-            north_q[order][0] += truncated_e * Cosine;  // north Qn,x
-            north_q[order][1] += truncated_e * Sine;    // north Qn,y
-          }
+          q[order][0] += truncated_e * Cosine[order];  // Qn,x
+          q[order][1] += truncated_e * Sine[order];    // Qn,y
         }
       }
     }
@@ -326,37 +333,34 @@ int EventPlaneReco::process_event(PHCompositeNode *topNode)
         mbdQ += mbd_q;
       }
 
-      for (int ipmt = 0; ipmt < mbdpmts->get_npmt(); ipmt++)
+      unsigned int npmt = mbdpmts->get_npmt();
+      if (mbd_arm.size() != npmt)
       {
-        float mbd_q = mbdpmts->get_pmt(ipmt)->get_q();
-        float phi = mbdgeom->get_phi(ipmt);
-        int arm = mbdgeom->get_arm(ipmt);
+        fill_mbd_harmonics(mbdpmts, mbdgeom);
+      }
 
-        if (mbdQ < _mbd_e)
-        {
-          continue;
-        }
+      for (unsigned int ipmt = 0; ipmt < npmt && mbdQ >= _mbd_e; ipmt++)
+      {
+        float mbd_q = mbdpmts->get_pmt(ipmt)->get_q();
+        const double *Cosine = &mbd_cos[ipmt * m_MaxOrder];
+        const double *Sine = &mbd_sin[ipmt * m_MaxOrder];
 
-        if (arm == 0)
+        if (mbd_arm[ipmt] == 0)
         {
           mbd_e_south += mbd_q;
           for (unsigned int order = 0; order < m_MaxOrder; order++)
           {
-            double Cosine = cos(phi * (double) (order + 1));
-            double Sine = sin(phi * (double) (order + 1));
-            south_q[order][0] += mbd_q * Cosine;  // south Qn,x
-            south_q[order][1] += mbd_q * Sine;    // south Qn,y
+            south_q[order][0] += mbd_q * Cosine[order];  // south Qn,x
+            south_q[order][1] += mbd_q * Sine[order];    // south Qn,y
           }
         }
-        else if (arm == 1)
+        else if (mbd_arm[ipmt] == 1)
         {
           mbd_e_north += mbd_q;
           for (unsigned int order = 0; order < m_MaxOrder; order++)
           {
-            double Cosine = cos(phi * (double) (order + 1));
-            double Sine = sin(phi * (double) (order + 1));
-            north_q[order][0] += mbd_q * Cosine;  // north Qn,x
-            north_q[order][1] += mbd_q * Sine;    // north Qn,y
+            north_q[order][0] += mbd_q * Cosine[order];  // north Qn,x
+            north_q[order][1] += mbd_q * Sine[order];    // north Qn,y
           }
         }
       }
@@ -372,35 +376,29 @@ int EventPlaneReco::process_event(PHCompositeNode *topNode)
       tprof_mean_sin_north_mbd[order]->Fill(mbd_e_north, _mbd_vertex, north_q[order][1] / mbd_e_north);
     }
 
-    // Get recentering histograms and do recentering
     // Recentering: subtract Qn,x and Qn,y values averaged over all events
     // Recentering histogram should be available on second run
+    // The averages of all orders and shift terms are read from one (charge, vertex) bin per side
+    const double *calib_south = calib_south_mbd.lookup(mbd_e_south, _mbd_vertex);
+    const double *calib_north = calib_north_mbd.lookup(mbd_e_north, _mbd_vertex);
+    unsigned int stride = calib_south_mbd.stride();
     for (unsigned int order = 0; order < m_MaxOrder; order++)
     {
-      if (tprof_mean_cos_south_mbd_input[order])  // check if recentering histograms exist
+      if (calib_south_mbd.has_recentering(order))  // check if recentering histograms exist
       {
-          
         // south
-        TAxis *south_xaxis = tprof_mean_cos_south_mbd_input[order]->GetXaxis();
-        TAxis *south_yaxis = tprof_mean_cos_south_mbd_input[order]->GetYaxis();
-        int xbin_south = south_xaxis->FindBin(mbd_e_south);
-        int ybin_south = south_yaxis->FindBin(_mbd_vertex);
-
-        double event_ave_cos_south = tprof_mean_cos_south_mbd_input[order]->GetBinContent(xbin_south, ybin_south);
-        double event_ave_sin_south = tprof_mean_sin_south_mbd_input[order]->GetBinContent(xbin_south, ybin_south);
+        double event_ave_cos_south = (calib_south ? calib_south[order * stride] : 0.);
+        double event_ave_sin_south = (calib_south ? calib_south[order * stride + 1] : 0.);
         south_q_subtract[order][0] = mbd_e_south * event_ave_cos_south;
         south_q_subtract[order][1] = mbd_e_south * event_ave_sin_south;
         south_q[order][0] -= south_q_subtract[order][0];
         south_q[order][1] -= south_q_subtract[order][1];
-
+      }
+      if (calib_north_mbd.has_recentering(order))
+      {
         // north
-        TAxis *north_xaxis = tprof_mean_cos_north_mbd_input[order]->GetXaxis();
-        TAxis *north_yaxis = tprof_mean_cos_north_mbd_input[order]->GetYaxis();
-        int xbin_north = north_xaxis->FindBin(mbd_e_north);
-        int ybin_north = north_yaxis->FindBin(_mbd_vertex);
-
-        double event_ave_cos_north = tprof_mean_cos_north_mbd_input[order]->GetBinContent(xbin_north, ybin_north);
-        double event_ave_sin_north = tprof_mean_sin_north_mbd_input[order]->GetBinContent(xbin_north, ybin_north);
+        double event_ave_cos_north = (calib_north ? calib_north[order * stride] : 0.);
+        double event_ave_sin_north = (calib_north ? calib_north[order * stride + 1] : 0.);
         north_q_subtract[order][0] = mbd_e_north * event_ave_cos_north;
         north_q_subtract[order][1] = mbd_e_north * event_ave_sin_north;
         north_q[order][0] -= north_q_subtract[order][0];
@@ -414,7 +412,7 @@ int EventPlaneReco::process_event(PHCompositeNode *topNode)
     for (unsigned int order = 0; order < m_MaxOrder; order++)
     {
       double n = order + 1.0;
-      if (tprof_mean_cos_south_mbd_input[order])  // if present, Qs are recentered
+      if (calib_south_mbd.has_recentering(order))  // if present, Qs are recentered
       {
         tmp_south_psi[order] = epinfo->GetPsi(south_q[order][0], south_q[order][1], n);
         tmp_north_psi[order] = epinfo->GetPsi(north_q[order][0], north_q[order][1], n);
@@ -425,68 +423,50 @@ int EventPlaneReco::process_event(PHCompositeNode *topNode)
         tmp_north_psi[order] = NAN;
       }
     }
+    delete epinfo;
 
-    // Filled during second run
     for (unsigned int order = 0; order < m_MaxOrder; order++)
     {
-      if (tprof_mean_cos_south_mbd_input[order])  // if present, Qs are recentered
+      if (!calib_south_mbd.has_recentering(order))  // without recentering psi_n is not defined
       {
-        // Fill shifting histograms by order and terms
-        for (int p = 0; p < _imax; p++)
-        {
-          double terms = p + 1.0;
-          double n = order + 1.0;
-          double tmp = (double) (n * terms);
-
-          tprof_cos_south_mbd_shift[order][p]->Fill(mbd_e_south, _mbd_vertex, cos(tmp * tmp_south_psi[order]));  // south <cos(i*n*psi_n)>
-          tprof_sin_south_mbd_shift[order][p]->Fill(mbd_e_south, _mbd_vertex, sin(tmp * tmp_south_psi[order]));  // south <sin(i*n*psi_n)>
-          tprof_cos_north_mbd_shift[order][p]->Fill(mbd_e_north, _mbd_vertex, cos(tmp * tmp_north_psi[order]));  // north <cos(i*n*psi_n)>
-          tprof_sin_north_mbd_shift[order][p]->Fill(mbd_e_north, _mbd_vertex, sin(tmp * tmp_north_psi[order]));  // north <sin(i*n*psi_n)>
-        }
+        continue;
       }
-    }
-    
-    // Get shifting histograms and calculate shift
-    // This was filled at the end of the second run
-    // In third run, shifting histograms should be available
-    for (unsigned int order = 0; order < m_MaxOrder; order++)
-    {
+
+      double n = order + 1.0;
       for (int p = 0; p < _imax; p++)
       {
-        if (tprof_cos_south_mbd_shift_input[order][p])  // check if shifting histograms exist
+        double terms = p + 1.0;
+        double tmp = (double) (n * terms);
+        double prefactor = 2.0 / terms;
+
+        double cos_south = cos(tmp * tmp_south_psi[order]);
+        double sin_south = sin(tmp * tmp_south_psi[order]);
+        double cos_north = cos(tmp * tmp_north_psi[order]);
+        double sin_north = sin(tmp * tmp_north_psi[order]);
+
+        // Filled during second run
+        // Fill shifting histograms by order and terms
+        tprof_cos_south_mbd_shift[order][p]->Fill(mbd_e_south, _mbd_vertex, cos_south);  // south <cos(i*n*psi_n)>
+        tprof_sin_south_mbd_shift[order][p]->Fill(mbd_e_south, _mbd_vertex, sin_south);  // south <sin(i*n*psi_n)>
+        tprof_cos_north_mbd_shift[order][p]->Fill(mbd_e_north, _mbd_vertex, cos_north);  // north <cos(i*n*psi_n)>
+        tprof_sin_north_mbd_shift[order][p]->Fill(mbd_e_north, _mbd_vertex, sin_north);  // north <sin(i*n*psi_n)>
+
+        // Calculate shift, the shifting histograms were filled at the end of the second run
+        // In third run, shifting histograms should be available
+
+        // Equation (6) of arxiv:nucl-ex/9805001
+        // i = terms; n = order; i*n = tmp
+        // (2 / i ) * <cos(i*n*psi_n)> * sin(i*n*psi_n) - <sin(i*n*psi_n)> * cos(i*n*psi_n)
+        if (calib_north_mbd.has_shift(order, p) && calib_north)
         {
-          double terms = p + 1.0;
-          double n = order + 1.0;
-          double tmp = (double) (n * terms);
-          double prefactor = 2.0 / terms;
-            
-          // south
-          TAxis *south_xaxis = tprof_cos_south_mbd_shift_input[order][p]->GetXaxis();
-          TAxis *south_yaxis = tprof_cos_south_mbd_shift_input[order][p]->GetYaxis();
-          int xbin_south = south_xaxis->FindBin(mbd_e_south);
-          int ybin_south = south_yaxis->FindBin(_mbd_vertex);
-
-          // north
-          TAxis *north_xaxis = tprof_cos_north_mbd_shift_input[order][p]->GetXaxis();
-          TAxis *north_yaxis = tprof_cos_north_mbd_shift_input[order][p]->GetYaxis();
-          int xbin_north = north_xaxis->FindBin(mbd_e_north);
-          int ybin_north = north_yaxis->FindBin(_mbd_vertex);
-            
-                     
-
-          // Equation (6) of arxiv:nucl-ex/9805001
-          // i = terms; n = order; i*n = tmp
-          // (2 / i ) * <cos(i*n*psi_n)> * sin(i*n*psi_n) - <sin(i*n*psi_n)> * cos(i*n*psi_n)
-
-          // north
-          shift_north[order] += prefactor * (tprof_cos_north_mbd_shift_input[order][p]->GetBinContent(xbin_north, ybin_north) * sin(tmp * tmp_north_psi[order]) - tprof_sin_north_mbd_shift_input[order][p]->GetBinContent(xbin_north, ybin_north) * cos(tmp * tmp_north_psi[order]));
-
-          // south
-          shift_south[order] += prefactor * (tprof_cos_south_mbd_shift_input[order][p]->GetBinContent(xbin_south, ybin_south) * sin(tmp * tmp_south_psi[order]) - tprof_sin_south_mbd_shift_input[order][p]->GetBinContent(xbin_south, ybin_south) * cos(tmp * tmp_south_psi[order]));
+          shift_north[order] += prefactor * (calib_north[order * stride + 2 + p] * sin_north - calib_north[order * stride + 2 + _imax + p] * cos_north);
+        }
+        if (calib_south_mbd.has_shift(order, p) && calib_south)
+        {
+          shift_south[order] += prefactor * (calib_south[order * stride + 2 + p] * sin_south - calib_south[order * stride + 2 + _imax + p] * cos_south);
         }
       }
     }
-     
 
     // n * deltapsi_n = (2 / i ) * <cos(i*n*psi_n)> * sin(i*n*psi_n) - <sin(i*n*psi_n)> * cos(i*n*psi_n)
     // Divide out n
@@ -501,7 +481,7 @@ int EventPlaneReco::process_event(PHCompositeNode *topNode)
     // Verify that this is done only in third run by asking for shifting hists
     for (unsigned int order = 0; order < m_MaxOrder; order++)
     {
-      if (tprof_cos_north_mbd_shift_input[0][0])
+      if (calib_north_mbd.has_shift(0, 0))
       {
         tmp_south_psi[order] += shift_south[order];
         tmp_north_psi[order] += shift_north[order];
@@ -511,7 +491,7 @@ int EventPlaneReco::process_event(PHCompositeNode *topNode)
     // Now enforce the range
     for (unsigned int order = 0; order < m_MaxOrder; order++)
     {
-      if (tprof_cos_north_mbd_shift_input[0][0])
+      if (calib_north_mbd.has_shift(0, 0))
       {
         double range = M_PI / (double) (order + 1);
         if (tmp_south_psi[order] < -1.0 * range)
@@ -598,6 +578,43 @@ int EventPlaneReco::CreateNodes(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void EventPlaneReco::fill_epd_harmonics(TowerInfoContainer *epd_towerinfo, EpdGeom *epdgeom)
+{
+  unsigned int ntowers = epd_towerinfo->size();
+  epd_arm.resize(ntowers);
+  epd_cos.resize(ntowers * m_MaxOrder);
+  epd_sin.resize(ntowers * m_MaxOrder);
+  for (unsigned int ch = 0; ch < ntowers; ch++)
+  {
+    unsigned int key = TowerInfoDefs::encode_epd(ch);
+    float tile_phi = epdgeom->get_phi(key);
+    epd_arm[ch] = TowerInfoDefs::get_epd_arm(key);
+    for (unsigned int order = 0; order < m_MaxOrder; order++)
+    {
+      epd_cos[ch * m_MaxOrder + order] = cos(tile_phi * (double) (order + 1));
+      epd_sin[ch * m_MaxOrder + order] = sin(tile_phi * (double) (order + 1));
+    }
+  }
+}
+
+void EventPlaneReco::fill_mbd_harmonics(MbdPmtContainer *mbdpmts, MbdGeom *mbdgeom)
+{
+  unsigned int npmt = mbdpmts->get_npmt();
+  mbd_arm.resize(npmt);
+  mbd_cos.resize(npmt * m_MaxOrder);
+  mbd_sin.resize(npmt * m_MaxOrder);
+  for (unsigned int ipmt = 0; ipmt < npmt; ipmt++)
+  {
+    float phi = mbdgeom->get_phi(ipmt);
+    mbd_arm[ipmt] = mbdgeom->get_arm(ipmt);
+    for (unsigned int order = 0; order < m_MaxOrder; order++)
+    {
+      mbd_cos[ipmt * m_MaxOrder + order] = cos(phi * (double) (order + 1));
+      mbd_sin[ipmt * m_MaxOrder + order] = sin(phi * (double) (order + 1));
+    }
+  }
+}
+
 void EventPlaneReco::ResetMe()
 {
   for (auto &vec : south_q)
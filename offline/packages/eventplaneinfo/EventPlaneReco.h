@@ -7,6 +7,8 @@
 /// \author Ejiro Umaka
 //===========================================================
 
+#include "EventPlaneCalibTable.h"
+
 #include <fun4all/SubsysReco.h>
 
 #include <string>  // for string
@@ -14,6 +16,10 @@
 
 class PHCompositeNode;
 class CDBHistos;
+class EpdGeom;
+class MbdGeom;
+class MbdPmtContainer;
+class TowerInfoContainer;
 class TProfile2D;
 class TH1;
 
@@ -55,6 +61,10 @@ class EventPlaneReco : public SubsysReco
  private:
   int CreateNodes(PHCompositeNode *topNode);
 
+  // per channel arm and cos / sin (n phi) of all orders, built with the first event
+  void fill_epd_harmonics(TowerInfoContainer *epd_towerinfo, EpdGeom *epdgeom);
+  void fill_mbd_harmonics(MbdPmtContainer *mbdpmts, MbdGeom *mbdgeom);
+
   unsigned int m_MaxOrder{3};
 
   int m_runNo{0};
@@ -72,6 +82,18 @@ class EventPlaneReco : public SubsysReco
   std::vector<std::vector<double>> south_q_subtract;
   std::vector<std::vector<double>> north_q_subtract;
 
+  // harmonics lookup, channel * m_MaxOrder + order
+  std::vector<int> epd_arm;
+  std::vector<double> epd_cos;
+  std::vector<double> epd_sin;
+  std::vector<int> mbd_arm;
+  std::vector<double> mbd_cos;
+  std::vector<double> mbd_sin;
+
+  // recentering and shift coefficients of the input histograms
+  EventPlaneCalibTable calib_south_mbd;
+  EventPlaneCalibTable calib_north_mbd;
+
   // shifting utility
   std::vector<double> tmp_south_psi;
   std::vector<double> tmp_north_psi;
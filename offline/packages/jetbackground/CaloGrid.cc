@@ -0,0 +1,157 @@
+#include "CaloGrid.h"
+
+#include <calobase/RawTowerDefs.h>
+#include <calobase/RawTowerGeom.h>
+#include <calobase/RawTowerGeomContainer.h>
+#include <calobase/TowerInfo.h>
+#include <calobase/TowerInfoContainer.h>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace
+{
+  // floats per 64-byte cache line
+  const int FLOATS_PER_LINE = 16;
+}  // namespace
+
+void CaloGrid::allocate(int neta, int nphi)
+{
+  m_neta = neta;
+  m_nphi = nphi;
+  m_stride = ((neta * nphi + FLOATS_PER_LINE - 1) / FLOATS_PER_LINE) * FLOATS_PER_LINE;
+
+  // over-allocate by one cache line and start the first column on a line boundary
+  m_buffer.assign(NLAYERS * NCOLUMNS * m_stride + FLOATS_PER_LINE, 0);
+  std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(m_buffer.data());
+  std::size_t offset = ((64 - addr % 64) % 64) / sizeof(float);
+  m_base = m_buffer.data() + offset;
+
+  m_status.assign(NLAYERS * m_stride, 0);
+
+  m_etacenter.assign(neta, 0);
+  m_phicenter.assign(nphi, 0);
+  m_deta.assign(neta, 0);
+
+  for (auto &chindex : m_channel_index)
+  {
+    chindex.clear();
+  }
+}
+
+void CaloGrid::set_geometry(int layer, RawTowerGeomContainer *geom)
+{
+  if (!is_initialized())
+  {
+    allocate(geom->get_etabins(), geom->get_phibins());
+
+    for (int ieta = 0; ieta < m_neta; ieta++)
+    {
+      m_etacenter[ieta] = geom->get_etacenter(ieta);
+      std::pair<double, double> etabounds = geom->get_etabounds(ieta);
+      m_deta[ieta] = etabounds.second - etabounds.first;
+    }
+    for (int iphi = 0; iphi < m_nphi; iphi++)
+    {
+      m_phicenter[iphi] = geom->get_phicenter(iphi);
+    }
+    std::pair<double, double> phibounds = geom->get_phibounds(0);
+    m_dphi = phibounds.second - phibounds.first;
+  }
+
+  float *eta = column(layer, COL_ETA);
+  float *phi = column(layer, COL_PHI);
+  float *cosheta = column(layer, COL_COSHETA);
+  for (int ieta = 0; ieta < m_neta; ieta++)
+  {
+    for (int iphi = 0; iphi < m_nphi; iphi++)
+    {
+      int index = get_index(ieta, iphi);
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(geom->get_calorimeter_id(), ieta, iphi);
+      RawTowerGeom *tower_geom = geom->get_tower_geometry(key);
+      if (tower_geom)
+      {
+        eta[index] = tower_geom->get_eta();
+        phi[index] = tower_geom->get_phi();
+      }
+      else
+      {
+        eta[index] = m_etacenter[ieta];
+        phi[index] = m_phicenter[iphi];
+      }
+      cosheta[index] = std::cosh(eta[index]);
+    }
+  }
+}
+
+void CaloGrid::Reset()
+{
+  if (!is_initialized())
+  {
+    return;
+  }
+  for (int layer = 0; layer < NLAYERS; layer++)
+  {
+    std::fill_n(column(layer, COL_E), m_stride, 0);
+    std::fill_n(column(layer, COL_ET), m_stride, 0);
+  }
+  std::fill(m_status.begin(), m_status.end(), 0);
+}
+
+void CaloGrid::fill(int layer, TowerInfoContainer *towers)
+{
+  unsigned int nchannels = towers->size();
+
+  // the channel -> grid index map only depends on the container layout
+  std::vector<int> &chindex = m_channel_index[layer];
+  if (chindex.size() != nchannels)
+  {
+    chindex.resize(nchannels);
+    for (unsigned int channel = 0; channel < nchannels; channel++)
+    {
+      unsigned int key = towers->encode_key(channel);
+      chindex[channel] = get_index(towers->getTowerEtaBin(key), towers->getTowerPhiBin(key));
+    }
+  }
+
+  float *E = column(layer, COL_E);
+  uint8_t *status = m_status.data() + layer * m_stride;
+  for (unsigned int channel = 0; channel < nchannels; channel++)
+  {
+    TowerInfo *tower = towers->get_tower_at_channel(channel);
+    int index = chindex[channel];
+    E[index] += tower->get_energy();
+
+    uint8_t bits = 0;
+    if (tower->get_isHot())
+    {
+      bits |= ISHOT;
+    }
+    if (tower->get_isNoCalib())
+    {
+      bits |= ISNOCALIB;
+    }
+    if (tower->get_isNotInstr())
+    {
+      bits |= ISNOTINSTR;
+    }
+    if (tower->get_isBadChi2())
+    {
+      bits |= ISBADCHI2;
+    }
+    status[index] = bits;
+  }
+
+  // transverse energies in one flat pass
+  float *ET = column(layer, COL_ET);
+  const float *cosheta = column(layer, COL_COSHETA);
+  const int n = size();
+  for (int index = 0; index < n; index++)
+  {
+    ET[index] = E[index] / cosheta[index];
+  }
+}
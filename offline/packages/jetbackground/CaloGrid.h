@@ -0,0 +1,126 @@
+#ifndef JETBACKGROUND_CALOGRID_H
+#define JETBACKGROUND_CALOGRID_H
+
+//===========================================================
+/// \file CaloGrid.h
+/// \brief flat eta x phi tower grid shared by the jet background chain
+//===========================================================
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// forward declarations
+class RawTowerGeomContainer;
+class TowerInfoContainer;
+
+/// \class CaloGrid
+///
+/// \brief flat eta x phi tower grid shared by the jet background chain
+///
+/// Transient structure-of-arrays view of the (retowered) CEMC, IHCal
+/// and OHCal towers on the common HCal eta x phi grid. Every column
+/// (E, ET, eta, phi, cosh(eta), status) is a contiguous block starting
+/// on a 64-byte boundary, indexed by ieta * nphi + iphi. The tower
+/// geometry is resolved once per run; per event only the energies and
+/// status bits are refreshed. Built by CaloGridBuilder and consumed
+/// read-only by the modules in jetbackground.
+///
+class CaloGrid
+{
+ public:
+  enum LAYER
+  {
+    CEMC = 0,
+    HCALIN = 1,
+    HCALOUT = 2
+  };
+  static const int NLAYERS = 3;
+
+  enum STATUSBIT
+  {
+    ISHOT = 1U << 0U,
+    ISNOCALIB = 1U << 1U,
+    ISNOTINSTR = 1U << 2U,
+    ISBADCHI2 = 1U << 3U
+  };
+  static const uint8_t BADMASK = ISHOT | ISNOCALIB | ISNOTINSTR | ISBADCHI2;
+
+  CaloGrid() = default;
+  ~CaloGrid() = default;
+
+  // columns point into m_buffer, so the grid is not copyable
+  CaloGrid(const CaloGrid &) = delete;
+  CaloGrid &operator=(const CaloGrid &) = delete;
+
+  //! sets up the grid binning and per-tower geometry of one layer
+  //! (CEMC uses the retowered IHCal geometry)
+  void set_geometry(int layer, RawTowerGeomContainer *geom);
+
+  //! zero energies and status bits of all layers
+  void Reset();
+
+  //! unpack one layer from its TowerInfo container
+  void fill(int layer, TowerInfoContainer *towers);
+
+  bool is_initialized() const { return m_neta > 0; }
+  int get_neta() const { return m_neta; }
+  int get_nphi() const { return m_nphi; }
+  int size() const { return m_neta * m_nphi; }
+
+  int get_index(int ieta, int iphi) const { return ieta * m_nphi + iphi; }
+  int get_ieta(int index) const { return index / m_nphi; }
+  int get_iphi(int index) const { return index % m_nphi; }
+
+  //! grid index of a TowerInfo channel of a given layer (valid after fill())
+  int get_index_of_channel(int layer, unsigned int channel) const { return m_channel_index[layer][channel]; }
+
+  // bin centers of the (IHCal) grid
+  float get_etacenter(int ieta) const { return m_etacenter[ieta]; }
+  float get_phicenter(int iphi) const { return m_phicenter[iphi]; }
+  float get_deta(int ieta) const { return m_deta[ieta]; }
+  float get_dphi() const { return m_dphi; }
+
+  // contiguous columns of size() entries
+  const float *get_E(int layer) const { return column(layer, COL_E); }
+  const float *get_ET(int layer) const { return column(layer, COL_ET); }
+  const float *get_eta(int layer) const { return column(layer, COL_ETA); }
+  const float *get_phi(int layer) const { return column(layer, COL_PHI); }
+  const float *get_cosheta(int layer) const { return column(layer, COL_COSHETA); }
+  const uint8_t *get_status(int layer) const { return m_status.data() + layer * m_stride; }
+
+  bool is_bad(int layer, int index) const { return get_status(layer)[index] & BADMASK; }
+
+ private:
+  enum COLUMN
+  {
+    COL_E = 0,
+    COL_ET = 1,
+    COL_ETA = 2,
+    COL_PHI = 3,
+    COL_COSHETA = 4,
+    NCOLUMNS = 5
+  };
+
+  void allocate(int neta, int nphi);
+  const float *column(int layer, int col) const { return m_base + (layer * NCOLUMNS + col) * m_stride; }
+  float *column(int layer, int col) { return m_base + (layer * NCOLUMNS + col) * m_stride; }
+
+  int m_neta{-1};
+  int m_nphi{-1};
+  // column length in floats, padded to a full cache line
+  int m_stride{0};
+
+  std::vector<float> m_buffer;
+  float *m_base{nullptr};
+  std::vector<uint8_t> m_status;
+
+  std::vector<float> m_etacenter;
+  std::vector<float> m_phicenter;
+  std::vector<float> m_deta;
+  float m_dphi{0};
+
+  std::vector<int> m_channel_index[NLAYERS];
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "CaloGridBuilder.h"
+
+#include "CaloGrid.h"
+
+#include <calobase/RawTowerGeomContainer.h>
+#include <calobase/TowerInfoContainer.h>
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/SubsysReco.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHDataNode.h>
+#include <phool/PHNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/getClass.h>
+#include <phool/phool.h>
+
+// standard includes
+#include <cstdlib>
+#include <iostream>
+
+CaloGridBuilder::CaloGridBuilder(const std::string &name)
+  : SubsysReco(name)
+{
+}
+
+int CaloGridBuilder::InitRun(PHCompositeNode *topNode)
+{
+  return CreateNode(topNode);
+}
+
+int CaloGridBuilder::process_event(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 0)
+  {
+    std::cout << "CaloGridBuilder::process_event: entering" << std::endl;
+  }
+
+  CaloGrid *grid = findNode::getClass<CaloGrid>(topNode, m_gridName);
+  if (!grid)
+  {
+    std::cout << PHWHERE << "missing " << m_gridName << " node, doing nothing" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  EMTowerName = m_towerNodePrefix + "_CEMC_RETOWER";
+  IHTowerName = m_towerNodePrefix + "_HCALIN";
+  OHTowerName = m_towerNodePrefix + "_HCALOUT";
+  TowerInfoContainer *towerinfosEM3 = findNode::getClass<TowerInfoContainer>(topNode, EMTowerName);
+  TowerInfoContainer *towerinfosIH3 = findNode::getClass<TowerInfoContainer>(topNode, IHTowerName);
+  TowerInfoContainer *towerinfosOH3 = findNode::getClass<TowerInfoContainer>(topNode, OHTowerName);
+  if (!towerinfosEM3 || !towerinfosIH3 || !towerinfosOH3)
+  {
+    std::cout << PHWHERE << "missing tower info object, doing nothing" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  grid->Reset();
+  grid->fill(CaloGrid::CEMC, towerinfosEM3);
+  grid->fill(CaloGrid::HCALIN, towerinfosIH3);
+  grid->fill(CaloGrid::HCALOUT, towerinfosOH3);
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "CaloGridBuilder::process_event: exiting, filled " << m_gridName << " with " << grid->get_neta() << " x " << grid->get_nphi() << " towers per layer" << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int CaloGridBuilder::CreateNode(PHCompositeNode *topNode)
+{
+  PHNodeIterator iter(topNode);
+
+  // Looking for the DST node
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  if (!dstNode)
+  {
+    std::cout << PHWHERE << "DST Node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
+  RawTowerGeomContainer *geomOH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
+  if (!geomIH || !geomOH)
+  {
+    std::cout << PHWHERE << "missing HCal tower geometry, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // store the grid under the jet background sub-node directory
+  PHCompositeNode *bkgNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "JETBACKGROUND"));
+  if (!bkgNode)
+  {
+    bkgNode = new PHCompositeNode("JETBACKGROUND");
+    dstNode->addNode(bkgNode);
+  }
+
+  CaloGrid *grid = findNode::getClass<CaloGrid>(topNode, m_gridName);
+  if (!grid)
+  {
+    if (Verbosity() > 0)
+    {
+      std::cout << "CaloGridBuilder::CreateNode : creating " << m_gridName << " node " << std::endl;
+    }
+    grid = new CaloGrid();
+    // transient, the grid is rebuilt from the towers every event
+    PHDataNode<CaloGrid> *gridNode = new PHDataNode<CaloGrid>(grid, m_gridName);
+    bkgNode->addNode(gridNode);
+  }
+  else
+  {
+    std::cout << PHWHERE << "::ERROR - " << m_gridName << " pre-exists, but should not" << std::endl;
+    exit(-1);
+  }
+
+  // the retowered CEMC lives on the IHCal grid
+  grid->set_geometry(CaloGrid::CEMC, geomIH);
+  grid->set_geometry(CaloGrid::HCALIN, geomIH);
+  grid->set_geometry(CaloGrid::HCALOUT, geomOH);
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
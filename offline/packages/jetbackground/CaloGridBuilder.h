@@ -0,0 +1,53 @@
+#ifndef JETBACKGROUND_CALOGRIDBUILDER_H
+#define JETBACKGROUND_CALOGRIDBUILDER_H
+
+//===========================================================
+/// \file CaloGridBuilder.h
+/// \brief fills the shared CaloGrid once per event
+//===========================================================
+
+#include <fun4all/SubsysReco.h>
+
+// system includes
+#include <string>
+
+// forward declarations
+class PHCompositeNode;
+
+/// \class CaloGridBuilder
+///
+/// \brief fills the shared CaloGrid once per event
+///
+/// Unpacks the retowered CEMC, IHCal and OHCal TowerInfo containers
+/// into a single CaloGrid node, so that DetermineTowerBackground,
+/// SubtractTowers and CopyAndSubtractJets do not each re-read the
+/// towers and their geometry. Register it after RetowerCEMC and enable
+/// set_use_calogrid(true) on the consumers.
+///
+class CaloGridBuilder : public SubsysReco
+{
+ public:
+  CaloGridBuilder(const std::string &name = "CaloGridBuilder");
+  ~CaloGridBuilder() override {}
+
+  int InitRun(PHCompositeNode *topNode) override;
+  int process_event(PHCompositeNode *topNode) override;
+
+  void set_towerNodePrefix(const std::string &prefix)
+  {
+    m_towerNodePrefix = prefix;
+    return;
+  }
+  void set_gridName(const std::string &name) { m_gridName = name; }
+
+ private:
+  int CreateNode(PHCompositeNode *topNode);
+
+  std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
+  std::string m_gridName{"CaloGrid"};
+  std::string EMTowerName;
+  std::string IHTowerName;
+  std::string OHTowerName;
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "CopyAndSubtractJets.h"
 
+#include "CaloGrid.h"
 #include "TowerBackground.h"
 
 #include <calobase/RawTower.h>
@@ -26,6 +27,7 @@
 #include <phool/phool.h>
 
 // standard includes
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <utility>
@@ -38,6 +40,14 @@ CopyAndSubtractJets::CopyAndSubtractJets(const std::string &name)
 
 int CopyAndSubtractJets::InitRun(PHCompositeNode *topNode)
 {
+  if (m_use_channel_table && !m_use_towerinfo)
+  {
+    std::cout << PHWHERE << " the channel table is only available for tower info input, using the per-tower subtraction" << std::endl;
+    m_use_channel_table = false;
+  }
+  // the channel table is rebuilt on the first event of the run
+  _TABLE_OFFSET[3] = 0;
+
   CreateNode(topNode);
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -57,7 +67,17 @@ int CopyAndSubtractJets::process_event(PHCompositeNode *topNode)
   TowerInfoContainer *towerinfosEM3 = nullptr;
   TowerInfoContainer *towerinfosIH3 = nullptr;
   TowerInfoContainer *towerinfosOH3 = nullptr;
-  if (m_use_towerinfo)
+  CaloGrid *grid = nullptr;
+  if (m_use_towerinfo && m_use_calogrid)
+  {
+    grid = findNode::getClass<CaloGrid>(topNode, m_gridName);
+    if (!grid)
+    {
+      std::cout << "CopyAndSubtractJets::process_event: Cannot find node " << m_gridName << std::endl;
+      exit(1);
+    }
+  }
+  if (m_use_towerinfo && (!m_use_calogrid || m_use_channel_table))
   {
     EMTowerName = m_towerNodePrefix + "_CEMC_RETOWER";
     IHTowerName = m_towerNodePrefix + "_HCALIN";
@@ -81,7 +101,7 @@ int CopyAndSubtractJets::process_event(PHCompositeNode *topNode)
       exit(1);
     }
   }
-  else
+  else if (!m_use_towerinfo)
   {
     towersEM3 = findNode::getClass<RawTowerContainer>(topNode, "TOWER_CALIB_CEMC_RETOWER");
     towersIH3 = findNode::getClass<RawTowerContainer>(topNode, "TOWER_CALIB_HCALIN");
@@ -120,6 +140,22 @@ int CopyAndSubtractJets::process_event(PHCompositeNode *topNode)
     std::cout << "CopyAndSubtractJets::process_event: entering with # subtracted jets = " << sub_jets->size() << std::endl;
   }
 
+  if (m_use_towerinfo && m_use_channel_table)
+  {
+    TowerInfoContainer *towerinfos[3] = {towerinfosEM3, towerinfosIH3, towerinfosOH3};
+    if (_TABLE_OFFSET[3] == 0)
+    {
+      BuildChannelTable(geomIH, geomOH, towerinfos);
+    }
+    SubtractWithChannelTable(unsub_jets, sub_jets, background, towerinfos, grid);
+
+    if (Verbosity() > 0)
+    {
+      std::cout << "CopyAndSubtractJets::process_event: exiting with # subtracted jets = " << sub_jets->size() << std::endl;
+    }
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
   // iterate over old jets
   int ijet = 0;
   for (auto this_jet : *unsub_jets)
@@ -154,7 +190,32 @@ int CopyAndSubtractJets::process_event(PHCompositeNode *topNode)
 
       double comp_background = 0;
 
-      if (m_use_towerinfo)
+      if (grid)
+      {
+        int layer = -1;
+        if (comp.first == 5 || comp.first == 26)
+        {
+          layer = CaloGrid::HCALIN;
+        }
+        else if (comp.first == 7 || comp.first == 27)
+        {
+          layer = CaloGrid::HCALOUT;
+        }
+        else if (comp.first == 13 || comp.first == 28)
+        {
+          layer = CaloGrid::CEMC;
+        }
+        if (layer >= 0)
+        {
+          int index = grid->get_index_of_channel(layer, comp.second);
+          comp_ieta = grid->get_ieta(index);
+          comp_e = grid->get_E(layer)[index];
+          comp_eta = grid->get_eta(layer)[index];
+          comp_phi = grid->get_phi(layer)[index];
+          comp_background = (layer == CaloGrid::CEMC ? background_UE_0 : (layer == CaloGrid::HCALIN ? background_UE_1 : background_UE_2)).at(comp_ieta);
+        }
+      }
+      else if (m_use_towerinfo)
       {
         if (comp.first == 5 || comp.first == 26)
         {
@@ -286,6 +347,157 @@ int CopyAndSubtractJets::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void CopyAndSubtractJets::BuildChannelTable(RawTowerGeomContainer *geomIH, RawTowerGeomContainer *geomOH, TowerInfoContainer *towerinfos[3])
+{
+  // the retowered CEMC sits on the HCALIN geometry
+  RawTowerGeomContainer *geoms[3] = {geomIH, geomIH, geomOH};
+  RawTowerDefs::CalorimeterId caloids[3] = {RawTowerDefs::CalorimeterId::HCALIN, RawTowerDefs::CalorimeterId::HCALIN, RawTowerDefs::CalorimeterId::HCALOUT};
+
+  _UE_NETA = std::max(geomIH->get_etabins(), geomOH->get_etabins());
+
+  _TABLE_OFFSET[0] = 0;
+  for (int layer = 0; layer < 3; layer++)
+  {
+    _TABLE_OFFSET[layer + 1] = _TABLE_OFFSET[layer] + towerinfos[layer]->size();
+  }
+  unsigned int ntable = _TABLE_OFFSET[3];
+  _TABLE_COSPHI.assign(ntable, 1);
+  _TABLE_SINPHI.assign(ntable, 0);
+  _TABLE_INVCOSHETA.assign(ntable, 1);
+  _TABLE_TANHETA.assign(ntable, 0);
+  _TABLE_UEBIN.assign(ntable, 0);
+
+  for (int layer = 0; layer < 3; layer++)
+  {
+    unsigned int nchannels = towerinfos[layer]->size();
+    for (unsigned int channel = 0; channel < nchannels; channel++)
+    {
+      unsigned int towerkey = towerinfos[layer]->encode_key(channel);
+      int ieta = towerinfos[layer]->getTowerEtaBin(towerkey);
+      int iphi = towerinfos[layer]->getTowerPhiBin(towerkey);
+      unsigned int index = _TABLE_OFFSET[layer] + channel;
+      _TABLE_UEBIN[index] = layer * _UE_NETA + ieta;
+
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(caloids[layer], ieta, iphi);
+      RawTowerGeom *tower_geom = geoms[layer]->get_tower_geometry(key);
+      if (!tower_geom)
+      {
+        // same as the per-tower path, eta = phi = 0
+        continue;
+      }
+      double eta = tower_geom->get_eta();
+      double phi = tower_geom->get_phi();
+      _TABLE_COSPHI[index] = cos(phi);
+      _TABLE_SINPHI[index] = sin(phi);
+      _TABLE_INVCOSHETA[index] = 1. / cosh(eta);
+      _TABLE_TANHETA[index] = tanh(eta);
+    }
+  }
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "CopyAndSubtractJets::BuildChannelTable: " << ntable << " channels, " << _UE_NETA << " UE eta bins per layer" << std::endl;
+  }
+}
+
+void CopyAndSubtractJets::SubtractWithChannelTable(JetContainer *unsub_jets, JetContainer *sub_jets, TowerBackground *background, TowerInfoContainer *towerinfos[3], CaloGrid *grid)
+{
+  // UE per layer and eta bin in one array
+  _UE.assign(3 * _UE_NETA, 0);
+  for (int layer = 0; layer < 3; layer++)
+  {
+    std::vector<float> layer_UE = background->get_UE(layer);
+    for (int ieta = 0; ieta < _UE_NETA && ieta < (int) layer_UE.size(); ieta++)
+    {
+      _UE[layer * _UE_NETA + ieta] = layer_UE[ieta];
+    }
+  }
+
+  // 1 + 2 v2 cos(2 (phi - Psi2)) = 1 + 2 v2 (cos 2phi cos 2Psi2 + sin 2phi sin 2Psi2)
+  float v2 = _use_flow_modulation ? background->get_v2() : 0;
+  float cos2Psi2 = cos(2 * background->get_Psi2());
+  float sin2Psi2 = sin(2 * background->get_Psi2());
+
+  // gather the constituents of all jets
+  _COMP_INDEX.clear();
+  _COMP_E.clear();
+  _JET_OFFSET.assign(1, 0);
+  for (auto this_jet : *unsub_jets)
+  {
+    for (auto comp = this_jet->comp_begin(); comp != this_jet->comp_end(); ++comp)
+    {
+      int layer = -1;
+      if (comp->first == 5 || comp->first == 26)
+      {
+        layer = 1;
+      }
+      else if (comp->first == 7 || comp->first == 27)
+      {
+        layer = 2;
+      }
+      else if (comp->first == 13 || comp->first == 28)
+      {
+        layer = 0;
+      }
+      if (layer < 0 || comp->second >= _TABLE_OFFSET[layer + 1] - _TABLE_OFFSET[layer])
+      {
+        continue;
+      }
+      float comp_e;
+      if (grid)
+      {
+        // CaloGrid layers are CEMC = 0, HCALIN = 1, HCALOUT = 2 as here
+        comp_e = grid->get_E(layer)[grid->get_index_of_channel(layer, comp->second)];
+      }
+      else
+      {
+        comp_e = towerinfos[layer]->get_tower_at_channel(comp->second)->get_energy();
+      }
+      _COMP_INDEX.push_back(_TABLE_OFFSET[layer] + comp->second);
+      _COMP_E.push_back(comp_e);
+    }
+    _JET_OFFSET.push_back(_COMP_INDEX.size());
+  }
+
+  // subtract and sum up the constituents, jet by jet
+  unsigned int njets = _JET_OFFSET.size() - 1;
+  for (unsigned int ijet = 0; ijet < njets; ijet++)
+  {
+    float new_total_px = 0;
+    float new_total_py = 0;
+    float new_total_pz = 0;
+    float new_total_e = 0;
+    for (unsigned int k = _JET_OFFSET[ijet]; k < _JET_OFFSET[ijet + 1]; k++)
+    {
+      unsigned int index = _COMP_INDEX[k];
+      float cosphi = _TABLE_COSPHI[index];
+      float sinphi = _TABLE_SINPHI[index];
+      float cos2phi = cosphi * cosphi - sinphi * sinphi;
+      float sin2phi = 2 * sinphi * cosphi;
+      float comp_background = _UE[_TABLE_UEBIN[index]] * (1 + 2 * v2 * (cos2phi * cos2Psi2 + sin2phi * sin2Psi2));
+      float comp_sub_e = _COMP_E[k] - comp_background;
+      float comp_sub_pt = comp_sub_e * _TABLE_INVCOSHETA[index];
+
+      new_total_px += comp_sub_pt * cosphi;
+      new_total_py += comp_sub_pt * sinphi;
+      new_total_pz += comp_sub_e * _TABLE_TANHETA[index];
+      new_total_e += comp_sub_e;
+    }
+
+    auto new_jet = sub_jets->add_jet();
+    new_jet->set_px(new_total_px);
+    new_jet->set_py(new_total_py);
+    new_jet->set_pz(new_total_pz);
+    new_jet->set_e(new_total_e);
+    new_jet->set_id(ijet);
+
+    if (Verbosity() > 1 && new_jet->get_pt() > 5)
+    {
+      std::cout << "CopyAndSubtractJets::SubtractWithChannelTable: new jet #" << ijet << ", new px / py / pz / e = " << new_total_px << " / " << new_total_py << " / " << new_total_pz << " / " << new_total_e << std::endl;
+    }
+  }
+}
+
 int CopyAndSubtractJets::End(PHCompositeNode * /*topNode*/)
 {
   return Fun4AllReturnCodes::EVENT_OK;
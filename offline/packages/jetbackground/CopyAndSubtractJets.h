@@ -10,9 +10,15 @@
 #include <fun4all/SubsysReco.h>
 
 #include <string>
+#include <vector>
 
 // forward declarations
+class CaloGrid;
+class JetContainer;
 class PHCompositeNode;
+class RawTowerGeomContainer;
+class TowerBackground;
+class TowerInfoContainer;
 
 /// \class CopyAndSubtractJets
 ///
@@ -23,6 +29,10 @@ class PHCompositeNode;
 /// background (intended use is to create the set of jets used as
 /// seeds in the second part of UE determination procedure)
 ///
+/// With SetUseChannelTable (tower info only) the tower geometry is
+/// looked up once per run into per-channel tables, and the
+/// constituents of all jets are subtracted together in flat arrays
+///
 class CopyAndSubtractJets : public SubsysReco
 {
  public:
@@ -43,12 +53,43 @@ class CopyAndSubtractJets : public SubsysReco
     m_towerNodePrefix = prefix;
     return;
   }
+  // read constituent towers from the shared CaloGrid filled by CaloGridBuilder
+  void set_use_calogrid(bool use_calogrid)
+  {
+    m_use_calogrid = use_calogrid;
+  }
+  void set_gridName(const std::string &name) { m_gridName = name; }
+
+  // subtract using per-channel geometry tables built on the first event of the run
+  void SetUseChannelTable(bool use_channel_table) { m_use_channel_table = use_channel_table; }
 
  private:
   int CreateNode(PHCompositeNode *topNode);
 
+  void BuildChannelTable(RawTowerGeomContainer *geomIH, RawTowerGeomContainer *geomOH, TowerInfoContainer *towerinfos[3]);
+  void SubtractWithChannelTable(JetContainer *unsub_jets, JetContainer *sub_jets, TowerBackground *background, TowerInfoContainer *towerinfos[3], CaloGrid *grid);
+
   bool _use_flow_modulation{false};
   bool m_use_towerinfo{false};
+  bool m_use_calogrid{false};
+  bool m_use_channel_table{false};
+
+  // per-channel tables, layers (0 = CEMC retower, 1 = HCALIN, 2 = HCALOUT)
+  // follow each other starting at _TABLE_OFFSET[layer]
+  unsigned int _TABLE_OFFSET[4]{0, 0, 0, 0};
+  int _UE_NETA{0};
+  std::vector<float> _TABLE_COSPHI;
+  std::vector<float> _TABLE_SINPHI;
+  std::vector<float> _TABLE_INVCOSHETA;
+  std::vector<float> _TABLE_TANHETA;
+  std::vector<int> _TABLE_UEBIN;  // layer * _UE_NETA + ieta
+
+  // per event buffers, reused
+  std::vector<float> _UE;
+  std::vector<unsigned int> _COMP_INDEX;
+  std::vector<float> _COMP_E;
+  std::vector<unsigned int> _JET_OFFSET;
+  std::string m_gridName{"CaloGrid"};
   std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
   std::string EMTowerName;
   std::string IHTowerName;
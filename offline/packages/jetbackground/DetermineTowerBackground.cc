@@ -1,7 +1,8 @@
 #include "DetermineTowerBackground.h"
 
+#include "CaloGrid.h"
 #include "TowerBackground.h"
-#include "TowerBackgroundv1.h"
+#include "TowerBackgroundv2.h"
 
 #include <calobase/RawTower.h>
 #include <calobase/RawTowerContainer.h>
@@ -14,6 +15,7 @@
 
 #include <jetbase/Jet.h>
 #include <jetbase/JetContainer.h>
+#include <jetbase/Jetv2.h>
 
 #include <g4main/PHG4Particle.h>
 #include <g4main/PHG4TruthInfoContainer.h>
@@ -34,6 +36,7 @@
 // standard includes
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
@@ -50,7 +53,18 @@ DetermineTowerBackground::DetermineTowerBackground(const std::string &name)
 
 int DetermineTowerBackground::InitRun(PHCompositeNode *topNode)
 {
-  return CreateNode(topNode);
+  if (_do_second_iteration && (_seed_type != 0 || !m_use_towerinfo))
+  {
+    std::cout << PHWHERE << " the second iteration needs seed type 0 and TowerInfo input, doing nothing" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  int status = CreateNode(topNode, _backgroundName);
+  if (status == Fun4AllReturnCodes::EVENT_OK && _do_second_iteration)
+  {
+    status = CreateNode(topNode, _secondBackgroundName);
+  }
+  return status;
 }
 
 int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
@@ -83,7 +97,17 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
   TowerInfoContainer *towerinfosEM3 = nullptr;
   TowerInfoContainer *towerinfosIH3 = nullptr;
   TowerInfoContainer *towerinfosOH3 = nullptr;
-  if (m_use_towerinfo)
+  CaloGrid *grid = nullptr;
+  if (m_use_towerinfo && m_use_calogrid)
+  {
+    grid = findNode::getClass<CaloGrid>(topNode, m_gridName);
+    if (!grid)
+    {
+      std::cout << "DetermineTowerBackground::process_event: Cannot find node " << m_gridName << std::endl;
+      exit(1);
+    }
+  }
+  else if (m_use_towerinfo)
   {
     EMTowerName = m_towerNodePrefix + "_CEMC_RETOWER";
     IHTowerName = m_towerNodePrefix + "_HCALIN";
@@ -176,7 +200,31 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
         TowerInfo *towerinfo;
         RawTowerGeom *tower_geom;
 
-        if (m_use_towerinfo)
+        if (grid)
+        {
+          int layer = -1;
+          if (comp.first == 5 || comp.first == 26)
+          {
+            layer = CaloGrid::HCALIN;
+          }
+          else if (comp.first == 7 || comp.first == 27)
+          {
+            layer = CaloGrid::HCALOUT;
+          }
+          else if (comp.first == 13 || comp.first == 28)
+          {
+            layer = CaloGrid::CEMC;
+          }
+          if (layer >= 0)
+          {
+            int index = grid->get_index_of_channel(layer, comp.second);
+            comp_ieta = grid->get_ieta(index);
+            comp_iphi = grid->get_iphi(index);
+            comp_ET = grid->get_ET(layer)[index];
+            comp_isBad = grid->is_bad(layer, index);
+          }
+        }
+        else if (m_use_towerinfo)
         {
           if (comp.first == 5 || comp.first == 26)
           {
@@ -398,6 +446,28 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
     _FULLCALOFLOW_PHI_E.resize(_HCAL_NPHI, 0);
     _FULLCALOFLOW_PHI_VAL.resize(_HCAL_NPHI, 0);
 
+    _STRIP_FLOWOK.resize(3, std::vector<int>(_HCAL_NETA, 0));
+    _STRIP_NTOWERS.resize(3, std::vector<int>(_HCAL_NETA, 0));
+
+    // one bit per phi bin, packed in 64-bit words per eta strip
+    _PHI_WORDS = (_HCAL_NPHI + 63) / 64;
+    _SEED_MASK.resize(_HCAL_NETA * _PHI_WORDS, 0);
+    _BAD_MASK.resize(3 * _HCAL_NETA * _PHI_WORDS, 0);
+
+    // the phi bin centers never change, tabulate the harmonics once
+    _FLOW_COS.resize(NHARMONICS, std::vector<float>(_HCAL_NPHI, 0));
+    _FLOW_SIN.resize(NHARMONICS, std::vector<float>(_HCAL_NPHI, 0));
+    _FLOW_MOD.resize(_HCAL_NPHI, 1);
+    for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
+    {
+      _FULLCALOFLOW_PHI_VAL[iphi] = geomIH->get_phicenter(iphi);
+      for (int ih = 0; ih < NHARMONICS; ih++)
+      {
+        _FLOW_COS[ih][iphi] = cos((ih + 2) * _FULLCALOFLOW_PHI_VAL[iphi]);
+        _FLOW_SIN[ih][iphi] = sin((ih + 2) * _FULLCALOFLOW_PHI_VAL[iphi]);
+      }
+    }
+
     if (Verbosity() > 0)
     {
       std::cout << "DetermineTowerBackground::process_event: setting number of towers in eta / phi: " << _HCAL_NETA << " / " << _HCAL_NPHI << std::endl;
@@ -418,13 +488,25 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
     }
   }
 
-  for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
+  if (grid)
   {
-    _FULLCALOFLOW_PHI_E[iphi] = 0;
-    _FULLCALOFLOW_PHI_VAL[iphi] = 0;
+    // the shared grid is already unpacked, copy out the eta strips
+    const int nphi = grid->get_nphi();
+    for (int ieta = 0; ieta < _HCAL_NETA; ieta++)
+    {
+      const int offset = grid->get_index(ieta, 0);
+      std::copy(grid->get_E(CaloGrid::CEMC) + offset, grid->get_E(CaloGrid::CEMC) + offset + nphi, _EMCAL_E[ieta].begin());
+      std::copy(grid->get_E(CaloGrid::HCALIN) + offset, grid->get_E(CaloGrid::HCALIN) + offset + nphi, _IHCAL_E[ieta].begin());
+      std::copy(grid->get_E(CaloGrid::HCALOUT) + offset, grid->get_E(CaloGrid::HCALOUT) + offset + nphi, _OHCAL_E[ieta].begin());
+      for (int iphi = 0; iphi < nphi; iphi++)
+      {
+        _EMCAL_ISBAD[ieta][iphi] = grid->is_bad(CaloGrid::CEMC, offset + iphi);
+        _IHCAL_ISBAD[ieta][iphi] = grid->is_bad(CaloGrid::HCALIN, offset + iphi);
+        _OHCAL_ISBAD[ieta][iphi] = grid->is_bad(CaloGrid::HCALOUT, offset + iphi);
+      }
+    }
   }
-
-  if (m_use_towerinfo)
+  else if (m_use_towerinfo)
   {
     // iterate over EMCal towerinfos
     if (!towerinfosEM3 || !towerinfosIH3 || !towerinfosOH3)
@@ -539,309 +621,555 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
       }
     }
   }
-  // first, calculate flow: Psi2 & v2, if enabled
+  // first, calculate flow: Psi2 & v2, if enabled, then the energy
+  // densities. Seed exclusion is shared by all layers and all strips
+  // are evaluated in the first (or only) iteration
+  FillBadMask();
 
-  _Psi2 = 0;
-  _v2 = 0;
-  _nStrips = 0;
+  std::vector<int> update_strips(_HCAL_NETA, 1);
+  FillSeedExclusion(geomIH, update_strips);
+  std::fill(update_strips.begin(), update_strips.end(), 1);
 
-  if (_do_flow == 0)
+  int flow_status = CalculateFlow(topNode, update_strips);
+  if (flow_status != Fun4AllReturnCodes::EVENT_OK)
   {
-    if (Verbosity() > 0)
-    {
-      std::cout << "DetermineTowerBackground::process_event: flow not enabled, setting Psi2 = " << _Psi2 << " ( " << _Psi2 / M_PI << " * pi ) , v2 = " << _v2 << std::endl;
-    }
+    return flow_status;
   }
+  CalculateUE(geomIH, update_strips);
 
-  if (_do_flow >= 1)
+  FillNode(topNode, _backgroundName);
+
+  if (_do_second_iteration)
   {
-    // check for the case when every tower is excluded
-    int nStripsAvailableForFlow = 0;
-    int nStripsUnavailableForFlow = 0;
+    // second iteration seeds are the first iteration seed candidates
+    // after subtracting the first iteration background, exactly as
+    // CopyAndSubtractJets + seed type 1 would select them
+    JetContainer *reco2_jets = findNode::getClass<JetContainer>(topNode, "AntiKt_TowerInfo_HIRecoSeedsRaw_r02");
+    if (!reco2_jets)
+    {
+      std::cout << "DetermineTowerBackground::process_event: Cannot find node AntiKt_TowerInfo_HIRecoSeedsRaw_r02" << std::endl;
+      exit(1);
+    }
 
-    for (int layer = 0; layer < 3; layer++)
+    if (Verbosity() > 1)
     {
-      int local_max_eta = _HCAL_NETA;
-      int local_max_phi = _HCAL_NPHI;
+      std::cout << "DetermineTowerBackground::process_event: examining possible seeds (2nd iteration) ... " << std::endl;
+    }
 
-      for (int eta = 0; eta < local_max_eta; eta++)
+    unsigned int nseeds_1st = _seed_eta.size();
+    _seed_eta.resize(0);
+    _seed_phi.resize(0);
+
+    for (auto this_jet : *reco2_jets)
+    {
+      float new_total_px = 0;
+      float new_total_py = 0;
+      float new_total_pz = 0;
+      float new_total_e = 0;
+
+      for (const auto &comp : this_jet->get_comp_vec())
       {
-        bool isAnyTowerExcluded = false;
+        int layer = -1;
+        if (comp.first == 5 || comp.first == 26)
+        {
+          layer = 1;
+        }
+        else if (comp.first == 7 || comp.first == 27)
+        {
+          layer = 2;
+        }
+        else if (comp.first == 13 || comp.first == 28)
+        {
+          layer = 0;
+        }
+        if (layer < 0)
+        {
+          continue;
+        }
 
-        for (int phi = 0; phi < local_max_phi; phi++)
+        double comp_e = 0;
+        double comp_eta = 0;
+        double comp_phi = 0;
+        int comp_ieta = 0;
+
+        if (grid)
+        {
+          int grid_layer = (layer == 0 ? CaloGrid::CEMC : (layer == 1 ? CaloGrid::HCALIN : CaloGrid::HCALOUT));
+          int index = grid->get_index_of_channel(grid_layer, comp.second);
+          comp_ieta = grid->get_ieta(index);
+          comp_e = grid->get_E(grid_layer)[index];
+          comp_eta = grid->get_eta(grid_layer)[index];
+          comp_phi = grid->get_phi(grid_layer)[index];
+        }
+        else
         {
-          float this_eta = geomIH->get_etacenter(eta);
-          float this_phi = geomIH->get_phicenter(phi);
+          TowerInfoContainer *towerinfos = (layer == 0 ? towerinfosEM3 : (layer == 1 ? towerinfosIH3 : towerinfosOH3));
+          unsigned int towerkey = towerinfos->encode_key(comp.second);
+          comp_ieta = towerinfos->getTowerEtaBin(towerkey);
+          int comp_iphi = towerinfos->getTowerPhiBin(towerkey);
+          const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid((layer == 2 ? RawTowerDefs::CalorimeterId::HCALOUT : RawTowerDefs::CalorimeterId::HCALIN), comp_ieta, comp_iphi);
+          RawTowerGeom *tower_geom = (layer == 2 ? geomOH : geomIH)->get_tower_geometry(key);
+          comp_e = towerinfos->get_tower_at_channel(comp.second)->get_energy();
+          comp_eta = tower_geom->get_eta();
+          comp_phi = tower_geom->get_phi();
+        }
 
-          bool isExcluded = false;
+        double comp_background = _UE[layer].at(comp_ieta);
+        if (_do_flow >= 1)
+        {
+          comp_background = comp_background * (1 + 2 * _v2 * cos(2 * (comp_phi - _Psi2)));
+        }
+        double comp_sub_e = comp_e - comp_background;
 
-          // if the tower is masked, exclude it
-          int this_isBad = (layer == 0 ? _EMCAL_ISBAD[eta][phi] : (layer == 1 ? _IHCAL_ISBAD[eta][phi] : _OHCAL_ISBAD[eta][phi]));
-          if (this_isBad)
-          {
-            isExcluded = true;
-          }
-          for (unsigned int iseed = 0; iseed < _seed_eta.size(); iseed++)
-          {
-            float deta = this_eta - _seed_eta[iseed];
-            float dphi = this_phi - _seed_phi[iseed];
-            if (dphi > M_PI)
-            {
-              dphi -= 2 * M_PI;
-            }
-            if (dphi < -M_PI)
-            {
-              dphi += 2 * M_PI;
-            }
-            float dR = sqrt(pow(deta, 2) + pow(dphi, 2));
-            if (dR < 0.4)
-            {
-              isExcluded = true;
-              if (Verbosity() > 10)
-              {
-                float my_E = (layer == 0 ? _EMCAL_E[eta][phi] : (layer == 1 ? _IHCAL_E[eta][phi] : _OHCAL_E[eta][phi]));
-                std::cout << " setting excluded mark for tower with E / eta / phi = " << my_E << " / " << this_eta << " / " << this_phi << " from seed at eta / phi = " << _seed_eta[iseed] << " / " << _seed_phi[iseed] << std::endl;
-              }
-            }
-          }
+        new_total_px += comp_sub_e / cosh(comp_eta) * cos(comp_phi);
+        new_total_py += comp_sub_e / cosh(comp_eta) * sin(comp_phi);
+        new_total_pz += comp_sub_e * tanh(comp_eta);
+        new_total_e += comp_sub_e;
+      }
 
-          // if even a single tower in this eta strip is excluded, we
-          // can't use the strip for flow determination
-          if (isExcluded)
-          {
-            isAnyTowerExcluded = true;
-          }
-        }  // close phi loop
+      Jetv2 sub_jet;
+      sub_jet.set_px(new_total_px);
+      sub_jet.set_py(new_total_py);
+      sub_jet.set_pz(new_total_pz);
+      sub_jet.set_e(new_total_e);
+
+      if (sub_jet.get_pt() < _seed_jet_pt)
+      {
+        continue;
+      }
+
+      _seed_eta.push_back(sub_jet.get_eta());
+      _seed_phi.push_back(sub_jet.get_phi());
+
+      if (Verbosity() > 1)
+      {
+        std::cout << "DetermineTowerBackground::process_event: --> adding seed at eta / phi = " << sub_jet.get_eta() << " / " << sub_jet.get_phi() << " ( R=0.2 jet with pt = " << sub_jet.get_pt() << " ) " << std::endl;
+      }
+    }
+
+    // only the eta strips whose seed exclusion changed need a new UE,
+    // unless the flow modulation changed as well
+    float v2_1st = _v2;
+    float Psi2_1st = _Psi2;
+    FillSeedExclusion(geomIH, update_strips);
+
+    flow_status = CalculateFlow(topNode, update_strips);
+    if (flow_status != Fun4AllReturnCodes::EVENT_OK)
+    {
+      return flow_status;
+    }
+    if (_v2 != v2_1st || _Psi2 != Psi2_1st)
+    {
+      std::fill(update_strips.begin(), update_strips.end(), 1);
+    }
+
+    if (Verbosity() > 0)
+    {
+      std::cout << "DetermineTowerBackground::process_event: 2nd iteration with " << _seed_eta.size() << " seeds ( " << nseeds_1st << " in 1st iteration ), updating " << std::count(update_strips.begin(), update_strips.end(), 1) << " / " << _HCAL_NETA << " eta strips" << std::endl;
+    }
 
-        // if this eta strip can be used for flow determination, fill it now
-        if (!isAnyTowerExcluded)
+    CalculateUE(geomIH, update_strips);
+
+    FillNode(topNode, _secondBackgroundName);
+  }
+
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "DetermineTowerBackground::process_event: exiting" << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int DetermineTowerBackground::CreateNode(PHCompositeNode *topNode, const std::string &backgroundName)
+{
+  PHNodeIterator iter(topNode);
+
+  // Looking for the DST node
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  if (!dstNode)
+  {
+    std::cout << PHWHERE << "DST Node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // store the jet background stuff under a sub-node directory
+  PHCompositeNode *bkgNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "JETBACKGROUND"));
+  if (!bkgNode)
+  {
+    bkgNode = new PHCompositeNode("JETBACKGROUND");
+    dstNode->addNode(bkgNode);
+  }
+
+  // create the TowerBackground node...
+  TowerBackground *towerbackground = findNode::getClass<TowerBackground>(topNode, backgroundName);
+  if (!towerbackground)
+  {
+    towerbackground = new TowerBackgroundv2();
+    PHIODataNode<PHObject> *bkgDataNode = new PHIODataNode<PHObject>(towerbackground, backgroundName, "PHObject");
+    bkgNode->addNode(bkgDataNode);
+  }
+  else
+  {
+    std::cout << PHWHERE << "::ERROR - " << backgroundName << " pre-exists, but should not" << std::endl;
+    exit(-1);
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void DetermineTowerBackground::FillNode(PHCompositeNode *topNode, const std::string &backgroundName)
+{
+  TowerBackground *towerbackground = findNode::getClass<TowerBackground>(topNode, backgroundName);
+  if (!towerbackground)
+  {
+    std::cout << " ERROR -- can't find TowerBackground node after it should have been created" << std::endl;
+    return;
+  }
+  else
+  {
+    towerbackground->set_UE(0, _UE[0]);
+    towerbackground->set_UE(1, _UE[1]);
+    towerbackground->set_UE(2, _UE[2]);
+
+    towerbackground->set_v2(_v2);
+
+    towerbackground->set_Psi2(_Psi2);
+
+    towerbackground->set_v3(_v3);
+    towerbackground->set_Psi3(_Psi3);
+    towerbackground->set_v4(_v4);
+    towerbackground->set_Psi4(_Psi4);
+
+    towerbackground->set_nStripsUsedForFlow(_nStrips);
+
+    towerbackground->set_nTowersUsedForBkg(_nTowers);
+  }
+
+  return;
+}
+
+void DetermineTowerBackground::FillBadMask()
+{
+  std::fill(_BAD_MASK.begin(), _BAD_MASK.end(), 0);
+  for (int layer = 0; layer < 3; layer++)
+  {
+    const std::vector<std::vector<int> > &isbad = (layer == 0 ? _EMCAL_ISBAD : (layer == 1 ? _IHCAL_ISBAD : _OHCAL_ISBAD));
+    for (int eta = 0; eta < _HCAL_NETA; eta++)
+    {
+      uint64_t *mask = &_BAD_MASK[(layer * _HCAL_NETA + eta) * _PHI_WORDS];
+      for (int phi = 0; phi < _HCAL_NPHI; phi++)
+      {
+        if (isbad[eta][phi])
         {
-          if (Verbosity() > 4)
-          {
-            std::cout << " strip at layer " << layer << ", eta " << eta << " has no excluded towers and can be used for flow determination " << std::endl;
-          }
-          nStripsAvailableForFlow++;
+          mask[phi / 64] |= uint64_t(1) << (phi % 64);
+        }
+      }
+    }
+  }
 
-          for (int phi = 0; phi < local_max_phi; phi++)
-          {
-            float this_phi = geomIH->get_phicenter(phi);
-
-            if (layer == 0)
-            {
-              _FULLCALOFLOW_PHI_E[phi] += _EMCAL_E[eta][phi];
-            }
-            if (layer == 1)
-            {
-              _FULLCALOFLOW_PHI_E[phi] += _IHCAL_E[eta][phi];
-            }
-            if (layer == 2)
-            {
-              _FULLCALOFLOW_PHI_E[phi] += _OHCAL_E[eta][phi];
-            }
-
-            _FULLCALOFLOW_PHI_VAL[phi] = this_phi;  // should really set this globally only one time
-          }
+  return;
+}
+
+void DetermineTowerBackground::FillSeedExclusion(RawTowerGeomContainer *geomIH, std::vector<int> &changed_strips)
+{
+  const float dphi_bin = 2 * M_PI / _HCAL_NPHI;
+  std::vector<uint64_t> new_mask(_SEED_MASK.size(), 0);
+
+  // only visit the towers in the eta x phi box around each seed,
+  // comparing dR^2 avoids the sqrt per tower
+  for (unsigned int iseed = 0; iseed < _seed_eta.size(); iseed++)
+  {
+    const int nphi_window = std::min(_HCAL_NPHI / 2, static_cast<int>(std::ceil(0.4 / dphi_bin)) + 1);
+    const int seed_iphi = static_cast<int>(std::floor((_seed_phi[iseed] - _FULLCALOFLOW_PHI_VAL[0]) / dphi_bin + 0.5));
+
+    for (int eta = 0; eta < _HCAL_NETA; eta++)
+    {
+      float deta = geomIH->get_etacenter(eta) - _seed_eta[iseed];
+      if (fabs(deta) >= 0.4)
+      {
+        continue;
+      }
+
+      for (int jphi = seed_iphi - nphi_window; jphi <= seed_iphi + nphi_window; jphi++)
+      {
+        int phi = ((jphi % _HCAL_NPHI) + _HCAL_NPHI) % _HCAL_NPHI;
+        float dphi = _FULLCALOFLOW_PHI_VAL[phi] - _seed_phi[iseed];
+        if (dphi > M_PI)
+        {
+          dphi -= 2 * M_PI;
         }
-        else
+        if (dphi < -M_PI)
         {
-          if (Verbosity() > 4)
+          dphi += 2 * M_PI;
+        }
+        if (deta * deta + dphi * dphi < 0.16)
+        {
+          new_mask[eta * _PHI_WORDS + phi / 64] |= uint64_t(1) << (phi % 64);
+          if (Verbosity() > 10)
           {
-            std::cout << " strip at layer " << layer << ", eta " << eta << " DOES have excluded towers and CANNOT be used for flow determination " << std::endl;
+            std::cout << " setting excluded mark for tower at eta / phi = " << geomIH->get_etacenter(eta) << " / " << _FULLCALOFLOW_PHI_VAL[phi] << " from seed at eta / phi = " << _seed_eta[iseed] << " / " << _seed_phi[iseed] << std::endl;
           }
-          nStripsUnavailableForFlow++;
         }
+      }
+    }
+  }
 
-      }  // close eta loop
-    }    // close layer loop
+  for (int eta = 0; eta < _HCAL_NETA; eta++)
+  {
+    changed_strips[eta] = 0;
+    for (int word = 0; word < _PHI_WORDS; word++)
+    {
+      if (new_mask[eta * _PHI_WORDS + word] != _SEED_MASK[eta * _PHI_WORDS + word])
+      {
+        changed_strips[eta] = 1;
+      }
+    }
+  }
+  _SEED_MASK.swap(new_mask);
 
-    // flow determination
+  return;
+}
 
-    float Q_x = 0;
-    float Q_y = 0;
-    float E = 0;
+int DetermineTowerBackground::CalculateFlow(PHCompositeNode *topNode, const std::vector<int> &update_strips)
+{
+  _Psi2 = 0;
+  _v2 = 0;
+  _Psi3 = 0;
+  _v3 = 0;
+  _Psi4 = 0;
+  _v4 = 0;
+  _nStrips = 0;
 
+  if (_do_flow == 0)
+  {
     if (Verbosity() > 0)
     {
-      std::cout << "DetermineTowerBackground::process_event: # of strips (summed over layers) available / unavailable for flow determination: " << nStripsAvailableForFlow << " / " << nStripsUnavailableForFlow << std::endl;
+      std::cout << "DetermineTowerBackground::process_event: flow not enabled, setting Psi2 = " << _Psi2 << " ( " << _Psi2 / M_PI << " * pi ) , v2 = " << _v2 << std::endl;
     }
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
+  std::fill(_FULLCALOFLOW_PHI_E.begin(), _FULLCALOFLOW_PHI_E.end(), 0);
+
+  // check for the case when every tower is excluded
+  int nStripsAvailableForFlow = 0;
+  int nStripsUnavailableForFlow = 0;
+
+  for (int layer = 0; layer < 3; layer++)
+  {
+    const std::vector<std::vector<float> > &layer_E = (layer == 0 ? _EMCAL_E : (layer == 1 ? _IHCAL_E : _OHCAL_E));
 
-    if (nStripsAvailableForFlow > 0)
+    for (int eta = 0; eta < _HCAL_NETA; eta++)
     {
-      for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
+      // if even a single tower in this eta strip is masked or excluded,
+      // we can't use the strip for flow determination
+      if (update_strips[eta])
       {
-        E += _FULLCALOFLOW_PHI_E[iphi];
-        Q_x += _FULLCALOFLOW_PHI_E[iphi] * cos(2 * _FULLCALOFLOW_PHI_VAL[iphi]);
-        Q_y += _FULLCALOFLOW_PHI_E[iphi] * sin(2 * _FULLCALOFLOW_PHI_VAL[iphi]);
+        const uint64_t *bad = &_BAD_MASK[(layer * _HCAL_NETA + eta) * _PHI_WORDS];
+        const uint64_t *seed = &_SEED_MASK[eta * _PHI_WORDS];
+        uint64_t excluded = 0;
+        for (int word = 0; word < _PHI_WORDS; word++)
+        {
+          excluded |= bad[word] | seed[word];
+        }
+        _STRIP_FLOWOK[layer][eta] = (excluded == 0);
       }
 
-      if (_do_flow == 1)
+      // if this eta strip can be used for flow determination, fill it now
+      if (_STRIP_FLOWOK[layer][eta])
       {
-        _Psi2 = atan2(Q_y, Q_x) / 2.0;
+        if (Verbosity() > 4)
+        {
+          std::cout << " strip at layer " << layer << ", eta " << eta << " has no excluded towers and can be used for flow determination " << std::endl;
+        }
+        nStripsAvailableForFlow++;
+
+        const float *strip_E = layer_E[eta].data();
+        float *phi_E = _FULLCALOFLOW_PHI_E.data();
+        for (int phi = 0; phi < _HCAL_NPHI; phi++)
+        {
+          phi_E[phi] += strip_E[phi];
+        }
       }
-      else if (_do_flow == 2)
+      else
       {
-        PHG4TruthInfoContainer *truthinfo = findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
-
-        if (!truthinfo)
+        if (Verbosity() > 4)
         {
-          std::cout << "DetermineTowerBackground::process_event: FATAL , G4TruthInfo does not exist , cannot extract truth flow with do_flow = " << _do_flow << std::endl;
-          return -1;
+          std::cout << " strip at layer " << layer << ", eta " << eta << " DOES have excluded towers and CANNOT be used for flow determination " << std::endl;
         }
+        nStripsUnavailableForFlow++;
+      }
 
-        PHG4TruthInfoContainer::Range range = truthinfo->GetPrimaryParticleRange();
+    }  // close eta loop
+  }    // close layer loop
 
-        float Hijing_Qx = 0, Hijing_Qy = 0;
+  // flow determination: Q_n vectors of the summed phi distribution
+  // for n = 2, 3, 4 from the tabulated harmonics
 
-        for (PHG4TruthInfoContainer::ConstIterator iter = range.first; iter != range.second; ++iter)
-        {
-          PHG4Particle *g4particle = iter->second;
+  float Q_x[NHARMONICS] = {0};
+  float Q_y[NHARMONICS] = {0};
+  float E = 0;
 
-          if (truthinfo->isEmbeded(g4particle->get_track_id()) != 0)
-          {
-            continue;
-          }
+  if (Verbosity() > 0)
+  {
+    std::cout << "DetermineTowerBackground::process_event: # of strips (summed over layers) available / unavailable for flow determination: " << nStripsAvailableForFlow << " / " << nStripsUnavailableForFlow << std::endl;
+  }
+
+  if (nStripsAvailableForFlow > 0)
+  {
+    const float *phi_E = _FULLCALOFLOW_PHI_E.data();
+    for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
+    {
+      E += phi_E[iphi];
+    }
+    for (int ih = 0; ih < NHARMONICS; ih++)
+    {
+      const float *cos_n = _FLOW_COS[ih].data();
+      const float *sin_n = _FLOW_SIN[ih].data();
+      float qx = 0;
+      float qy = 0;
+      for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
+      {
+        qx += phi_E[iphi] * cos_n[iphi];
+        qy += phi_E[iphi] * sin_n[iphi];
+      }
+      Q_x[ih] = qx;
+      Q_y[ih] = qy;
+    }
 
-          TLorentzVector t;
-          t.SetPxPyPzE(g4particle->get_px(), g4particle->get_py(), g4particle->get_pz(), g4particle->get_e());
+    if (_do_flow == 1)
+    {
+      _Psi2 = atan2(Q_y[0], Q_x[0]) / 2.0;
+    }
+    else if (_do_flow == 2)
+    {
+      PHG4TruthInfoContainer *truthinfo = findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
 
-          float truth_pt = t.Pt();
-          if (truth_pt < 0.4)
-          {
-            continue;
-          }
-          float truth_eta = t.Eta();
-          if (fabs(truth_eta) > 1.1)
-          {
-            continue;
-          }
-          float truth_phi = t.Phi();
-          int truth_pid = g4particle->get_pid();
+      if (!truthinfo)
+      {
+        std::cout << "DetermineTowerBackground::process_event: FATAL , G4TruthInfo does not exist , cannot extract truth flow with do_flow = " << _do_flow << std::endl;
+        return -1;
+      }
 
-          if (Verbosity() > 10)
-          {
-            std::cout << "DetermineTowerBackground::process_event: determining truth flow, using particle w/ pt / eta / phi " << truth_pt << " / " << truth_eta << " / " << truth_phi << " , embed / PID = " << truthinfo->isEmbeded(g4particle->get_track_id()) << " / " << truth_pid << std::endl;
-          }
+      PHG4TruthInfoContainer::Range range = truthinfo->GetPrimaryParticleRange();
+
+      float Hijing_Qx = 0, Hijing_Qy = 0;
+
+      for (PHG4TruthInfoContainer::ConstIterator iter = range.first; iter != range.second; ++iter)
+      {
+        PHG4Particle *g4particle = iter->second;
 
-          Hijing_Qx += truth_pt * cos(2 * truth_phi);
-          Hijing_Qy += truth_pt * sin(2 * truth_phi);
+        if (truthinfo->isEmbeded(g4particle->get_track_id()) != 0)
+        {
+          continue;
         }
 
-        _Psi2 = atan2(Hijing_Qy, Hijing_Qx) / 2.0;
+        TLorentzVector t;
+        t.SetPxPyPzE(g4particle->get_px(), g4particle->get_py(), g4particle->get_pz(), g4particle->get_e());
 
-        if (Verbosity() > 0)
+        float truth_pt = t.Pt();
+        if (truth_pt < 0.4)
         {
-          std::cout << "DetermineTowerBackground::process_event: flow extracted from Hijing truth particles, setting Psi2 = " << _Psi2 << " ( " << _Psi2 / M_PI << " * pi ) " << std::endl;
+          continue;
         }
-      }
+        float truth_eta = t.Eta();
+        if (fabs(truth_eta) > 1.1)
+        {
+          continue;
+        }
+        float truth_phi = t.Phi();
+        int truth_pid = g4particle->get_pid();
 
-      // determine v2 from calo regardless of origin of Psi2
-      double sum_cos2dphi = 0;
-      for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
-      {
-        sum_cos2dphi += _FULLCALOFLOW_PHI_E[iphi] * cos(2 * (_FULLCALOFLOW_PHI_VAL[iphi] - _Psi2));
+        if (Verbosity() > 10)
+        {
+          std::cout << "DetermineTowerBackground::process_event: determining truth flow, using particle w/ pt / eta / phi " << truth_pt << " / " << truth_eta << " / " << truth_phi << " , embed / PID = " << truthinfo->isEmbeded(g4particle->get_track_id()) << " / " << truth_pid << std::endl;
+        }
+
+        Hijing_Qx += truth_pt * cos(2 * truth_phi);
+        Hijing_Qy += truth_pt * sin(2 * truth_phi);
       }
 
-      _v2 = sum_cos2dphi / E;
+      _Psi2 = atan2(Hijing_Qy, Hijing_Qx) / 2.0;
 
-      _nStrips = nStripsAvailableForFlow;
-    }
-    else
-    {
-      _Psi2 = 0;
-      _v2 = 0;
-      _nStrips = 0;
       if (Verbosity() > 0)
       {
-        std::cout << "DetermineTowerBackground::process_event: no full strips available for flow modulation, setting v2 and Psi = 0" << std::endl;
+        std::cout << "DetermineTowerBackground::process_event: flow extracted from Hijing truth particles, setting Psi2 = " << _Psi2 << " ( " << _Psi2 / M_PI << " * pi ) " << std::endl;
       }
     }
 
+    // the higher order planes always come from the calo
+    _Psi3 = atan2(Q_y[1], Q_x[1]) / 3.0;
+    _Psi4 = atan2(Q_y[2], Q_x[2]) / 4.0;
+
+    // determine v_n from calo regardless of origin of Psi_n, using
+    // sum E cos(n (phi - Psi_n)) = Q_x cos(n Psi_n) + Q_y sin(n Psi_n)
+    _v2 = (Q_x[0] * cos(2 * _Psi2) + Q_y[0] * sin(2 * _Psi2)) / E;
+    _v3 = (Q_x[1] * cos(3 * _Psi3) + Q_y[1] * sin(3 * _Psi3)) / E;
+    _v4 = (Q_x[2] * cos(4 * _Psi4) + Q_y[2] * sin(4 * _Psi4)) / E;
+
+    _nStrips = nStripsAvailableForFlow;
+  }
+  else
+  {
     if (Verbosity() > 0)
     {
-      std::cout << "DetermineTowerBackground::process_event: unnormalized Q vector (Qx, Qy) = ( " << Q_x << ", " << Q_y << " ) with Sum E_i = " << E << std::endl;
-      std::cout << "DetermineTowerBackground::process_event: Psi2 = " << _Psi2 << " ( " << _Psi2 / M_PI << " * pi " << (_do_flow == 2 ? "from Hijing " : "") << ") , v2 = " << _v2 << " ( using " << _nStrips << " ) " << std::endl;
+      std::cout << "DetermineTowerBackground::process_event: no full strips available for flow modulation, setting v2 and Psi = 0" << std::endl;
     }
-  }  // if do flow
+  }
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "DetermineTowerBackground::process_event: unnormalized Q vector (Qx, Qy) = ( " << Q_x[0] << ", " << Q_y[0] << " ) with Sum E_i = " << E << std::endl;
+    std::cout << "DetermineTowerBackground::process_event: Psi2 = " << _Psi2 << " ( " << _Psi2 / M_PI << " * pi " << (_do_flow == 2 ? "from Hijing " : "") << ") , v2 = " << _v2 << " ( using " << _nStrips << " ) " << std::endl;
+    std::cout << "DetermineTowerBackground::process_event: Psi3 = " << _Psi3 << " , v3 = " << _v3 << " , Psi4 = " << _Psi4 << " , v4 = " << _v4 << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
 
-  // now calculate energy densities...
-  _nTowers = 0;  // store how many towers were used to determine bkg
+void DetermineTowerBackground::CalculateUE(RawTowerGeomContainer *geomIH, const std::vector<int> &update_strips)
+{
+  // the flow modulation only depends on phi
+  for (int phi = 0; phi < _HCAL_NPHI; phi++)
+  {
+    _FLOW_MOD[phi] = 1 + 2 * _v2 * cos(2 * (_FULLCALOFLOW_PHI_VAL[phi] - _Psi2));
+  }
 
   // starting with the EMCal first...
   for (int layer = 0; layer < 3; layer++)
   {
-    int local_max_eta = _HCAL_NETA;
-    int local_max_phi = _HCAL_NPHI;
+    const std::vector<std::vector<float> > &layer_E = (layer == 0 ? _EMCAL_E : (layer == 1 ? _IHCAL_E : _OHCAL_E));
 
-    for (int eta = 0; eta < local_max_eta; eta++)
+    for (int eta = 0; eta < _HCAL_NETA; eta++)
     {
+      if (!update_strips[eta])
+      {
+        continue;
+      }
+
+      const uint64_t *bad = &_BAD_MASK[(layer * _HCAL_NETA + eta) * _PHI_WORDS];
+      const uint64_t *seed = &_SEED_MASK[eta * _PHI_WORDS];
+
       float total_E = 0;
       int total_tower = 0;
 
-      for (int phi = 0; phi < local_max_phi; phi++)
+      for (int phi = 0; phi < _HCAL_NPHI; phi++)
       {
-        float this_eta = geomIH->get_etacenter(eta);
-        float this_phi = geomIH->get_phicenter(phi);
-
-        bool isExcluded = false;
-
-        float my_E = (layer == 0 ? _EMCAL_E[eta][phi] : (layer == 1 ? _IHCAL_E[eta][phi] : _OHCAL_E[eta][phi]));
-        int this_isBad = (layer == 0 ? _EMCAL_ISBAD[eta][phi] : (layer == 1 ? _IHCAL_ISBAD[eta][phi] : _OHCAL_ISBAD[eta][phi]));
-        // if the tower is masked (energy identically zero), exclude it
-        if (this_isBad)
+        // masked towers and towers near a seed are excluded
+        uint64_t bit = uint64_t(1) << (phi % 64);
+        if ((bad[phi / 64] | seed[phi / 64]) & bit)
         {
-          isExcluded = true;
           if (Verbosity() > 10)
           {
-            std::cout << " tower in layer " << layer << " at eta / phi = " << this_eta << " / " << this_phi << " with E = " << my_E << " excluded due to masking" << std::endl;
-          }
-        }
-        for (unsigned int iseed = 0; iseed < _seed_eta.size(); iseed++)
-        {
-          float deta = this_eta - _seed_eta[iseed];
-          float dphi = this_phi - _seed_phi[iseed];
-          if (dphi > M_PI)
-          {
-            dphi -= 2 * M_PI;
-          }
-          if (dphi < -M_PI)
-          {
-            dphi += 2 * M_PI;
-          }
-          float dR = sqrt(pow(deta, 2) + pow(dphi, 2));
-          if (dR < 0.4)
-          {
-            isExcluded = true;
-            if (Verbosity() > 10)
-            {
-              std::cout << " setting excluded mark from seed at eta / phi = " << _seed_eta[iseed] << " / " << _seed_phi[iseed] << std::endl;
-            }
+            std::cout << " tower in layer " << layer << " at eta / phi = " << geomIH->get_etacenter(eta) << " / " << _FULLCALOFLOW_PHI_VAL[phi] << " with E = " << layer_E[eta][phi] << " excluded due to " << ((bad[phi / 64] & bit) ? "masking" : "seed") << std::endl;
           }
+          continue;
         }
 
-        if (!isExcluded)
-        {
-          if (layer == 0)
-          {
-            total_E += _EMCAL_E[eta][phi] / (1 + 2 * _v2 * cos(2 * (this_phi - _Psi2)));
-          }
-          if (layer == 1)
-          {
-            total_E += _IHCAL_E[eta][phi] / (1 + 2 * _v2 * cos(2 * (this_phi - _Psi2)));
-          }
-          if (layer == 2)
-          {
-            total_E += _OHCAL_E[eta][phi] / (1 + 2 * _v2 * cos(2 * (this_phi - _Psi2)));
-          }
-          total_tower++;  // towers in this eta range & layer
-          _nTowers++;     // towers in entire calorimeter
-        }
-        else
-        {
-          if (Verbosity() > 10)
-          {
-            std::cout << " tower at eta / phi = " << this_eta << " / " << this_phi << " with E = " << total_E << " excluded due to seed " << std::endl;
-          }
-        }
+        total_E += layer_E[eta][phi] / _FLOW_MOD[phi];
+        total_tower++;  // towers in this eta range & layer
       }
 
       std::pair<float, float> etabounds = geomIH->get_etabounds(eta);
@@ -852,6 +1180,7 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
       float total_area = total_tower * deta * dphi;
 
       _UE[layer].at(eta) = total_E / total_tower;
+      _STRIP_NTOWERS[layer][eta] = total_tower;
 
       if (Verbosity() > 3)
       {
@@ -860,6 +1189,16 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
     }
   }
 
+  // store how many towers were used to determine bkg
+  _nTowers = 0;
+  for (int layer = 0; layer < 3; layer++)
+  {
+    for (int eta = 0; eta < _HCAL_NETA; eta++)
+    {
+      _nTowers += _STRIP_NTOWERS[layer][eta];
+    }
+  }
+
   if (Verbosity() > 0)
   {
     for (int layer = 0; layer < 3; layer++)
@@ -873,77 +1212,5 @@ int DetermineTowerBackground::process_event(PHCompositeNode *topNode)
     }
   }
 
-  //
-
-  FillNode(topNode);
-
-  if (Verbosity() > 0)
-  {
-    std::cout << "DetermineTowerBackground::process_event: exiting" << std::endl;
-  }
-
-  return Fun4AllReturnCodes::EVENT_OK;
-}
-
-int DetermineTowerBackground::CreateNode(PHCompositeNode *topNode)
-{
-  PHNodeIterator iter(topNode);
-
-  // Looking for the DST node
-  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
-  if (!dstNode)
-  {
-    std::cout << PHWHERE << "DST Node missing, doing nothing." << std::endl;
-    return Fun4AllReturnCodes::ABORTRUN;
-  }
-
-  // store the jet background stuff under a sub-node directory
-  PHCompositeNode *bkgNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "JETBACKGROUND"));
-  if (!bkgNode)
-  {
-    bkgNode = new PHCompositeNode("JETBACKGROUND");
-    dstNode->addNode(bkgNode);
-  }
-
-  // create the TowerBackground node...
-  TowerBackground *towerbackground = findNode::getClass<TowerBackground>(topNode, _backgroundName);
-  if (!towerbackground)
-  {
-    towerbackground = new TowerBackgroundv1();
-    PHIODataNode<PHObject> *bkgDataNode = new PHIODataNode<PHObject>(towerbackground, _backgroundName, "PHObject");
-    bkgNode->addNode(bkgDataNode);
-  }
-  else
-  {
-    std::cout << PHWHERE << "::ERROR - " << _backgroundName << " pre-exists, but should not" << std::endl;
-    exit(-1);
-  }
-
-  return Fun4AllReturnCodes::EVENT_OK;
-}
-
-void DetermineTowerBackground::FillNode(PHCompositeNode *topNode)
-{
-  TowerBackground *towerbackground = findNode::getClass<TowerBackground>(topNode, _backgroundName);
-  if (!towerbackground)
-  {
-    std::cout << " ERROR -- can't find TowerBackground node after it should have been created" << std::endl;
-    return;
-  }
-  else
-  {
-    towerbackground->set_UE(0, _UE[0]);
-    towerbackground->set_UE(1, _UE[1]);
-    towerbackground->set_UE(2, _UE[2]);
-
-    towerbackground->set_v2(_v2);
-
-    towerbackground->set_Psi2(_Psi2);
-
-    towerbackground->set_nStripsUsedForFlow(_nStrips);
-
-    towerbackground->set_nTowersUsedForBkg(_nTowers);
-  }
-
   return;
 }
@@ -11,11 +11,13 @@
 
 // system includes
 #include <jetbase/Jet.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 // forward declarations
 class PHCompositeNode;
+class RawTowerGeomContainer;
 
 /// \class DetermineTowerBackground
 ///
@@ -38,6 +40,14 @@ class DetermineTowerBackground : public SubsysReco
   void SetSeedType(int seed_type) { _seed_type = seed_type; }
   void SetFlow(int do_flow) { _do_flow = do_flow; };
 
+  // run both background iterations in this module: the seed type 0
+  // background is written to the first output, the second iteration
+  // takes the seeds after subtracting it (as CopyAndSubtractJets and a
+  // seed type 1 module would) and only re-evaluates the eta strips
+  // touched by the changed exclusion regions. TowerInfo input only
+  void SetDoSecondIteration(bool do_second_iteration) { _do_second_iteration = do_second_iteration; }
+  void SetSecondBackgroundOutputName(const std::string &name) { _secondBackgroundName = name; }
+
   void SetSeedJetD(float D) { _seed_jet_D = D; };
   void SetSeedJetPt(float pt) { _seed_jet_pt = pt; };
   void set_towerinfo(bool use_towerinfo)
@@ -49,14 +59,33 @@ class DetermineTowerBackground : public SubsysReco
     m_towerNodePrefix = prefix;
     return;
   }
+  // read towers from the shared CaloGrid filled by CaloGridBuilder
+  void set_use_calogrid(bool use_calogrid)
+  {
+    m_use_calogrid = use_calogrid;
+  }
+  void set_gridName(const std::string &name) { m_gridName = name; }
 
  private:
-  int CreateNode(PHCompositeNode *topNode);
-  void FillNode(PHCompositeNode *topNode);
+  int CreateNode(PHCompositeNode *topNode, const std::string &backgroundName);
+  void FillNode(PHCompositeNode *topNode, const std::string &backgroundName);
+
+  void FillBadMask();
+  // flags the eta strips whose seed exclusion changed
+  void FillSeedExclusion(RawTowerGeomContainer *geomIH, std::vector<int> &changed_strips);
+  int CalculateFlow(PHCompositeNode *topNode, const std::vector<int> &update_strips);
+  void CalculateUE(RawTowerGeomContainer *geomIH, const std::vector<int> &update_strips);
+
+  // flow harmonics n = 2, 3, 4
+  static const int NHARMONICS = 3;
 
   int _do_flow{0};
   float _v2{0};
   float _Psi2{0};
+  float _v3{0};
+  float _Psi3{0};
+  float _v4{0};
+  float _Psi4{0};
   std::vector<std::vector<float> > _UE;
   int _nStrips{0};
   int _nTowers{0};
@@ -77,7 +106,26 @@ class DetermineTowerBackground : public SubsysReco
   std::vector<float> _FULLCALOFLOW_PHI_E;
   std::vector<float> _FULLCALOFLOW_PHI_VAL;
 
+  // cos(n phi), sin(n phi) of the phi bin centers for each harmonic,
+  // and the v2 modulation 1 + 2 v2 cos(2 (phi - Psi2)) per phi bin
+  std::vector<std::vector<float> > _FLOW_COS;
+  std::vector<std::vector<float> > _FLOW_SIN;
+  std::vector<double> _FLOW_MOD;
+
+  // bit masks with one bit per phi bin, _PHI_WORDS words per eta strip:
+  // towers within dR < 0.4 of a seed (same for all layers) and masked
+  // towers per layer
+  int _PHI_WORDS{0};
+  std::vector<uint64_t> _SEED_MASK;
+  std::vector<uint64_t> _BAD_MASK;
+
+  // per layer and eta strip the flow usability and # of towers in the UE
+  std::vector<std::vector<int> > _STRIP_FLOWOK;
+  std::vector<std::vector<int> > _STRIP_NTOWERS;
+
   std::string _backgroundName{"TestTowerBackground"};
+  std::string _secondBackgroundName{"TestTowerBackground_Sub2"};
+  bool _do_second_iteration{false};
 
   int _seed_type{0};
   float _seed_jet_D{3.0};
@@ -90,7 +138,9 @@ class DetermineTowerBackground : public SubsysReco
   Jet::PROPERTY _index_SeedItr{};
 
   bool m_use_towerinfo{false};
+  bool m_use_calogrid{false};
 
+  std::string m_gridName{"CaloGrid"};
   std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
   std::string EMTowerName;
   std::string IHTowerName;
@@ -1,9 +1,11 @@
 #include "DetermineTowerRho.h"
 
+#include "TowerBackground.h"
 #include "TowerRho.h"
 #include "TowerRhov1.h"
 
 #include <jetbase/Jet.h>
+#include <jetbase/JetContainer.h>
 #include <jetbase/JetInput.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
@@ -31,8 +33,10 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>  // for exit
+#include <functional>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 DetermineTowerRho::DetermineTowerRho(const std::string &name)
@@ -76,27 +80,137 @@ int DetermineTowerRho::process_event(PHCompositeNode *topNode)
     m_abs_ghost_eta = m_abs_tower_eta_range;
   }
 
-  // get fastjet input from tower nodes
-  std::vector<fastjet::PseudoJet> calo_pseudojets = get_pseudojets(topNode);
+  bool do_area = false;
+  bool do_mult = false;
+  bool do_grid = false;
+  bool do_grid_flow = false;
+  for (auto &_rho_method : _rho_methods)
+  {
+    do_area |= (_rho_method == TowerRho::Method::AREA);
+    do_mult |= (_rho_method == TowerRho::Method::MULT);
+    do_grid |= (_rho_method == TowerRho::Method::GRID);
+    do_grid_flow |= (_rho_method == TowerRho::Method::GRID_FLOW);
+  }
 
-  // fastjet definitions
-  fastjet::JetAlgorithm _fj_algo = get_fj_algo();  // get fastjet algorithm
+  float rho_area = 0;
+  float sigma_area = 0;
+  float rho_mult = 0;
+  float sigma_mult = 0;
+  float rho_grid = 0;
+  float sigma_grid = 0;
+  float rho_grid_flow = 0;
+  float sigma_grid_flow = 0;
+
+  // the tower inputs are fetched once for the clustering and the grid
+  bool do_cluster = m_jet_input_name.empty() && (do_area || do_mult);
+  if (do_cluster || do_grid || do_grid_flow)
+  {
+    get_input_particles(topNode);
+  }
 
-  // jet definition
-  fastjet::JetDefinition jet_def(_fj_algo,
-                                 m_par,
-                                 fastjet::E_scheme,
-                                 fastjet::Best);
+  if (do_grid)
+  {
+    _rho_grid(false, 0, 0, rho_grid, sigma_grid);
+  }
+  if (do_grid_flow)
+  {
+    TowerBackground *towerbackground = findNode::getClass<TowerBackground>(topNode, m_flow_background_name);
+    if (!towerbackground)
+    {
+      std::cout << PHWHERE << " missing " << m_flow_background_name << " node for flow modulated grid rho, doing nothing" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+    _rho_grid(true, towerbackground->get_v2(), towerbackground->get_Psi2(), rho_grid_flow, sigma_grid_flow);
+  }
 
-  // area definition
-  fastjet::AreaDefinition area_def(fastjet::active_area_explicit_ghosts,
-                                   fastjet::GhostedAreaSpec(m_abs_ghost_eta, 1, m_ghost_area));
+  m_bkgd_jet_pt.clear();
+  m_bkgd_jet_area.clear();
+  m_bkgd_jet_ncomp.clear();
+  m_bkgd_n_empty_jets = 0;
 
-  fastjet::Selector jet_selector = ((!fastjet::SelectorNHardest(m_omit_nhardest)) *
-                                    (fastjet::SelectorAbsEtaMax(m_abs_jet_eta_range) && fastjet::SelectorPtMin(m_jet_min_pT)));
+  if (!m_jet_input_name.empty())
+  {
+    // background jets were already clustered by JetReco
+    JetContainer *bkgd_jets = findNode::getClass<JetContainer>(topNode, m_jet_input_name);
+    if (!bkgd_jets)
+    {
+      std::cout << PHWHERE << " missing background jet node " << m_jet_input_name << ", doing nothing" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+    int ret = select_container_jets(bkgd_jets);
+    if (ret != Fun4AllReturnCodes::EVENT_OK)
+    {
+      return ret;
+    }
+    if (do_area)
+    {
+      _rho_area(rho_area, sigma_area);
+      if (Verbosity() > 2 && !_inputs.empty())
+      {
+        // cross check against clustering the towers here on the same event
+        if (!do_cluster && !do_grid && !do_grid_flow)
+        {
+          get_input_particles(topNode);
+        }
+        float rho_check = 0;
+        float sigma_check = 0;
+        _rho_area_clustered(rho_check, sigma_check);
+        std::cout << "DetermineTowerRho::process_event - rho area from " << m_jet_input_name << " = " << rho_area << " +- " << sigma_area
+                  << ", from clustering the towers = " << rho_check << " +- " << sigma_check << std::endl;
+      }
+    }
+  }
+  else if (do_cluster)
+  {
+    // get fastjet input from tower nodes
+    std::vector<fastjet::PseudoJet> calo_pseudojets = get_pseudojets();
 
-  // Not pure ghost function
-  fastjet::Selector not_pure_ghost = (!fastjet::SelectorIsPureGhost());
+    // fastjet definitions
+    fastjet::JetAlgorithm _fj_algo = get_fj_algo();  // get fastjet algorithm
+
+    // jet definition
+    fastjet::JetDefinition jet_def(_fj_algo,
+                                   m_par,
+                                   fastjet::E_scheme,
+                                   fastjet::Best);
+
+    // area definition
+    fastjet::AreaDefinition area_def(fastjet::active_area_explicit_ghosts,
+                                     fastjet::GhostedAreaSpec(m_abs_ghost_eta, 1, m_ghost_area));
+
+    fastjet::Selector jet_selector = ((!fastjet::SelectorNHardest(m_omit_nhardest)) *
+                                      (fastjet::SelectorAbsEtaMax(m_abs_jet_eta_range) && fastjet::SelectorPtMin(m_jet_min_pT)));
+
+    // Not pure ghost function
+    fastjet::Selector not_pure_ghost = (!fastjet::SelectorIsPureGhost());
+
+    // reconstruct the background jets once for all methods
+    fastjet::ClusterSequenceArea cs(calo_pseudojets, jet_def, area_def);
+
+    if (do_area)
+    {
+      fastjet::JetMedianBackgroundEstimator bge{jet_selector, cs};
+      rho_area = bge.rho();
+      sigma_area = bge.sigma();
+    }
+
+    if (do_mult)
+    {
+      std::vector<fastjet::PseudoJet> jets = fastjet::sorted_by_pt(jet_selector(cs.inclusive_jets()));
+      for (auto &jet : jets)
+      {
+        std::vector<fastjet::PseudoJet> constituents = not_pure_ghost(jet.constituents());
+        m_bkgd_jet_pt.push_back(jet.pt());
+        m_bkgd_jet_area.push_back(jet.area());
+        m_bkgd_jet_ncomp.push_back(constituents.size());
+      }
+    }
+  }
+
+  if (do_mult)
+  {
+    _rho_mult(rho_mult, sigma_mult);
+  }
 
   for (unsigned int ipos = 0; ipos < _rho_methods.size(); ipos++)
   {
@@ -106,121 +220,270 @@ int DetermineTowerRho::process_event(PHCompositeNode *topNode)
 
     if (_rho_method == TowerRho::Method::AREA)
     {
-      fastjet::JetMedianBackgroundEstimator bge{jet_selector, jet_def, area_def};
-      bge.set_particles(calo_pseudojets);
-      rho = bge.rho();
-      sigma = bge.sigma();
+      rho = rho_area;
+      sigma = sigma_area;
     }
     else if (_rho_method == TowerRho::Method::MULT)
     {
-      // reconstruct the background jets
-      fastjet::ClusterSequenceArea cs(calo_pseudojets, jet_def, area_def);
-      std::vector<fastjet::PseudoJet> jets = fastjet::sorted_by_pt(jet_selector(cs.inclusive_jets()));
+      rho = rho_mult;
+      sigma = sigma_mult;
+    }
+    else if (_rho_method == TowerRho::Method::GRID)
+    {
+      rho = rho_grid;
+      sigma = sigma_grid;
+    }
+    else if (_rho_method == TowerRho::Method::GRID_FLOW)
+    {
+      rho = rho_grid_flow;
+      sigma = sigma_grid_flow;
+    }
 
-      std::vector<float> pt_over_nConstituents;
-      int nfj_jets = 0;
-      int n_empty_jets = 0;
-      float total_constituents = 0;
-      for (auto &jet : jets)
-      {
-        float jet_pt = jet.pt();
+    FillNode(topNode, ipos, rho, sigma);
+  }
 
-        std::vector<fastjet::PseudoJet> constituents = not_pure_ghost(jet.constituents());
+  return Fun4AllReturnCodes::EVENT_OK;
+}
 
-        int jet_size = constituents.size();
+int DetermineTowerRho::select_container_jets(JetContainer *jets)
+{
+  if (!jets->has_property(Jet::PROPERTY::prop_area))
+  {
+    std::cout << PHWHERE << " background jets in " << m_jet_input_name << " have no area, run JetReco with calc_area" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+  Jet::PROPERTY area_index = jets->property_index(Jet::PROPERTY::prop_area);
 
-        total_constituents += jet_size;
-        if (jet_size == 0)
-        {
-          n_empty_jets++;
-          continue;  // only consider jets with constituents
-        }
-        pt_over_nConstituents.push_back(jet_pt / jet_size);
-        nfj_jets++;
-      }
+  // same selection as for the clustered jets: eta and pt cuts, then omit the n hardest
+  std::vector<std::pair<float, unsigned int> > selected;
+  float covered_area = 0;
+  for (unsigned int ijet = 0; ijet < jets->size(); ijet++)
+  {
+    Jet *jet = jets->get_UncheckedAt(ijet);
+    if (std::fabs(jet->get_eta()) > m_abs_jet_eta_range)
+    {
+      continue;
+    }
+    covered_area += jet->get_property(area_index);
+    if (jet->get_pt() < m_jet_min_pT)
+    {
+      continue;
+    }
+    selected.emplace_back(jet->get_pt(), ijet);
+  }
 
-      int total_jets = nfj_jets + n_empty_jets;
-      float mean_N = total_constituents / total_jets;
-      if (mean_N < 0)
+  // JetReco drops the pure ghost jets, which the clustering here keeps
+  // (pt = 0, they pass the pt cut unless it is above 0) and which enter
+  // the medians as zeros. Count the area of the acceptance not covered by
+  // jets as empty jets, as ClusterSequenceAreaBase::n_empty_jets does
+  // (kt pure ghost jets have on average 0.55 pi R^2)
+  if (m_jet_min_pT <= 0)
+  {
+    float empty_area = 2 * m_abs_jet_eta_range * 2 * M_PI - covered_area;
+    if (empty_area > 0)
+    {
+      m_bkgd_n_empty_jets = empty_area / (0.55 * M_PI * m_par * m_par);
+    }
+  }
+  std::sort(selected.begin(), selected.end(), std::greater<std::pair<float, unsigned int> >());
+
+  for (unsigned int isel = m_omit_nhardest; isel < selected.size(); isel++)
+  {
+    Jet *jet = jets->get_UncheckedAt(selected[isel].second);
+    m_bkgd_jet_pt.push_back(selected[isel].first);
+    m_bkgd_jet_area.push_back(jet->get_property(area_index));
+    m_bkgd_jet_ncomp.push_back(jet->size_comp());
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void DetermineTowerRho::_rho_grid(bool flow_modulated, float v2, float Psi2, float &rho, float &sigma)
+{
+  // rectangular patches tiling |eta| < m_abs_tower_eta_range and 2pi in phi,
+  // as in fastjet::GridMedianBackgroundEstimator but without any clustering
+  int n_eta = std::max(1, int(std::lround(2 * m_abs_tower_eta_range / m_grid_size)));
+  int n_phi = std::max(1, int(std::lround(2 * M_PI / m_grid_size)));
+  float d_eta = 2 * m_abs_tower_eta_range / n_eta;
+  float d_phi = 2 * M_PI / n_phi;
+  float cell_area = d_eta * d_phi;
+
+  m_grid_pt.assign(n_eta * n_phi, 0);
+  for (auto &part : m_input_particles)
+  {
+    if (part.e <= 0)
+    {
+      continue;
+    }
+    float pt = std::sqrt(part.px * part.px + part.py * part.py);
+    if (pt <= 0 || pt < m_tower_min_pT)
+    {
+      continue;
+    }
+    float eta = std::asinh(part.pz / pt);
+    if (std::fabs(eta) > m_abs_tower_eta_range)
+    {
+      continue;
+    }
+    float phi = std::atan2(part.py, part.px);
+    if (flow_modulated)
+    {
+      // rescale to the phi-averaged density
+      float modulation = 1 + 2 * v2 * std::cos(2 * (phi - Psi2));
+      if (modulation > 0)
       {
-        std::cout << "WARNING: mean_N = " << mean_N << " is negative, setting to 0" << std::endl;
-        mean_N = 0;
+        pt /= modulation;
       }
+    }
+    int ieta = std::min(n_eta - 1, int((eta + m_abs_tower_eta_range) / d_eta));
+    int iphi = std::min(n_phi - 1, int((phi + M_PI) / d_phi));
+    m_grid_pt[ieta * n_phi + iphi] += pt;
+  }
 
-      float med_tmp, std_tmp;
-      _median_stddev(pt_over_nConstituents, n_empty_jets, med_tmp, std_tmp);
-      sigma = float(std_tmp * std::sqrt(mean_N));
-      rho = med_tmp;
+  // empty patches are part of the median
+  for (auto &cell_pt : m_grid_pt)
+  {
+    cell_pt /= cell_area;
+  }
+
+  float med_tmp, std_tmp;
+  _median_stddev(m_grid_pt, 0, med_tmp, std_tmp);
+  rho = med_tmp;
+  sigma = float(std_tmp * std::sqrt(cell_area));
+}
+
+void DetermineTowerRho::_rho_area(float &rho, float &sigma) const
+{
+  // median of pt / area, as in fastjet::JetMedianBackgroundEstimator
+  std::vector<float> pt_over_area;
+  pt_over_area.reserve(m_bkgd_jet_pt.size());
+  float total_area = 0;
+  for (unsigned int ijet = 0; ijet < m_bkgd_jet_pt.size(); ijet++)
+  {
+    if (m_bkgd_jet_area[ijet] <= 0)
+    {
+      continue;
     }
-    else
+    pt_over_area.push_back(m_bkgd_jet_pt[ijet] / m_bkgd_jet_area[ijet]);
+    total_area += m_bkgd_jet_area[ijet];
+  }
+  if (pt_over_area.empty())
+  {
+    rho = 0;
+    sigma = 0;
+    return;
+  }
+  // empty jets (JetContainer input only) have pt / area = 0
+  total_area += m_bkgd_n_empty_jets * 0.55 * M_PI * m_par * m_par;
+  float mean_area = total_area / (pt_over_area.size() + m_bkgd_n_empty_jets);
+
+  float med_tmp, std_tmp;
+  _median_stddev(pt_over_area, m_bkgd_n_empty_jets, med_tmp, std_tmp);
+  rho = med_tmp;
+  sigma = float(std_tmp * std::sqrt(mean_area));
+}
+
+void DetermineTowerRho::_rho_area_clustered(float &rho, float &sigma)
+{
+  // same as the clustered path of process_event
+  std::vector<fastjet::PseudoJet> calo_pseudojets = get_pseudojets();
+  fastjet::JetDefinition jet_def(get_fj_algo(), m_par, fastjet::E_scheme, fastjet::Best);
+  fastjet::AreaDefinition area_def(fastjet::active_area_explicit_ghosts,
+                                   fastjet::GhostedAreaSpec(m_abs_ghost_eta, 1, m_ghost_area));
+  fastjet::Selector jet_selector = ((!fastjet::SelectorNHardest(m_omit_nhardest)) *
+                                    (fastjet::SelectorAbsEtaMax(m_abs_jet_eta_range) && fastjet::SelectorPtMin(m_jet_min_pT)));
+  fastjet::ClusterSequenceArea cs(calo_pseudojets, jet_def, area_def);
+  fastjet::JetMedianBackgroundEstimator bge{jet_selector, cs};
+  rho = bge.rho();
+  sigma = bge.sigma();
+}
+
+void DetermineTowerRho::_rho_mult(float &rho, float &sigma) const
+{
+  std::vector<float> pt_over_nConstituents;
+  int nfj_jets = 0;
+  int n_empty_jets = 0;
+  float total_constituents = 0;
+  for (unsigned int ijet = 0; ijet < m_bkgd_jet_pt.size(); ijet++)
+  {
+    float jet_pt = m_bkgd_jet_pt[ijet];
+
+    int jet_size = m_bkgd_jet_ncomp[ijet];
+
+    total_constituents += jet_size;
+    if (jet_size == 0)
     {
-      rho = 0;
-      sigma = 0;
+      n_empty_jets++;
+      continue;  // only consider jets with constituents
     }
+    pt_over_nConstituents.push_back(jet_pt / jet_size);
+    nfj_jets++;
+  }
 
-    FillNode(topNode, ipos, rho, sigma);
+  // pure ghost jets missing from a JetContainer input have no constituents
+  float n_empty = n_empty_jets + m_bkgd_n_empty_jets;
+  float total_jets = nfj_jets + n_empty;
+  float mean_N = (total_jets > 0) ? total_constituents / total_jets : 0;
+  if (mean_N < 0)
+  {
+    std::cout << "WARNING: mean_N = " << mean_N << " is negative, setting to 0" << std::endl;
+    mean_N = 0;
   }
 
-  return Fun4AllReturnCodes::EVENT_OK;
+  float med_tmp, std_tmp;
+  _median_stddev(pt_over_nConstituents, n_empty, med_tmp, std_tmp);
+  sigma = float(std_tmp * std::sqrt(mean_N));
+  rho = med_tmp;
 }
 
-std::vector<fastjet::PseudoJet> DetermineTowerRho::get_pseudojets(PHCompositeNode *topNode)
+void DetermineTowerRho::get_input_particles(PHCompositeNode *topNode)
+{
+  m_input_particles.clear();
+  for (auto &_input : _inputs)
+  {
+    _input->get_input_particles(topNode, m_input_particles);
+  }
+}
+
+std::vector<fastjet::PseudoJet> DetermineTowerRho::get_pseudojets()
 {
   // get fastjet input from tower nodes
   std::vector<fastjet::PseudoJet> calo_pseudojets;
-  for (auto &_input : _inputs)
+  calo_pseudojets.reserve(m_input_particles.size());
+
+  for (auto &part : m_input_particles)
   {
-    std::vector<Jet *> parts = _input->get_input(topNode);
-    // for (unsigned int i = 0; i < parts.size(); ++i)
-    // {
-    for (auto &part : parts)
+    float this_e = part.e;
+    if (this_e == 0.)
     {
-      // auto& part = parts[i];
-      float this_e = part->get_e();
-      if (this_e == 0.)
-      {
-        continue;
-      }
-      float this_px = part->get_px();
-      float this_py = part->get_py();
-      float this_pz = part->get_pz();
-
-      // float this_px = parts[i]->get_px();
-      // float this_py = parts[i]->get_py();
-      // float this_pz = parts[i]->get_pz();
-
-      // if(m_do_tower_cut)
-      // {
-      // if(this_e < m_tower_threshold) continue;
-      if (this_e < 0)
-      {
-        // make energy = +1 MeV for purposes of clustering
-        float e_ratio = 0.001 / this_e;
-        this_e = this_e * e_ratio;
-        this_px = this_px * e_ratio;
-        this_py = this_py * e_ratio;
-        this_pz = this_pz * e_ratio;
-      }
+      continue;
+    }
+    float this_px = part.px;
+    float this_py = part.py;
+    float this_pz = part.pz;
 
-      // }
-      fastjet::PseudoJet pseudojet(this_px, this_py, this_pz, this_e);
+    if (this_e < 0)
+    {
+      // make energy = +1 MeV for purposes of clustering
+      float e_ratio = 0.001 / this_e;
+      this_e = this_e * e_ratio;
+      this_px = this_px * e_ratio;
+      this_py = this_py * e_ratio;
+      this_pz = this_pz * e_ratio;
+    }
 
-      if (pseudojet.perp() < m_tower_min_pT)
-      {
-        continue;
-      }
-      if (fabs(pseudojet.eta()) > m_abs_tower_eta_range)
-      {
-        continue;
-      }
+    fastjet::PseudoJet pseudojet(this_px, this_py, this_pz, this_e);
 
-      calo_pseudojets.push_back(pseudojet);
+    if (pseudojet.perp() < m_tower_min_pT)
+    {
+      continue;
     }
-    for (auto &p : parts)
+    if (fabs(pseudojet.eta()) > m_abs_tower_eta_range)
     {
-      delete p;
+      continue;
     }
-    parts.clear();
+
+    calo_pseudojets.push_back(pseudojet);
   }
 
   return calo_pseudojets;
@@ -428,6 +691,11 @@ void DetermineTowerRho::print_settings(std::ostream &os) const
   os << "Tower min pT: " << m_tower_min_pT << std::endl;
   os << "Jet min pT: " << m_jet_min_pT << std::endl;
   os << "Ghost eta: " << m_abs_ghost_eta << std::endl;
+  os << "Grid size: " << m_grid_size << std::endl;
+  if (!m_jet_input_name.empty())
+  {
+    os << "Background jets from: " << m_jet_input_name << std::endl;
+  }
   os << "-----------------------------------" << std::endl;
   return;
 }
@@ -27,6 +27,7 @@
 
 // forward declarations
 class PHCompositeNode;
+class JetContainer;
 
 /// \class DetermineTowerRho
 ///
@@ -34,6 +35,20 @@ class PHCompositeNode;
 ///
 /// This module estimates rho for the area and multiplicty methods using kt jets
 ///
+/// The background jets are clustered once per event and shared by all
+/// requested methods. Alternatively the kt jets can be taken from a
+/// JetContainer filled by JetReco (see set_jet_input), which must have
+/// been clustered with areas (and components for the MULT method) and
+/// the same algorithm and R. JetReco drops the pure ghost jets, so the
+/// acceptance |eta| < jet_abs_eta not covered by the jets is counted as
+/// empty jets of 0.55 pi R^2 each (as fastjet does for areas without
+/// explicit ghosts). This follows the clustered path on average, the
+/// values of single events differ slightly near the acceptance edges.
+/// With Verbosity > 2 and tower inputs both values are printed per event
+///
+/// The GRID methods take the median pt density of rectangular eta-phi
+/// patches of the towers and need no clustering at all
+///
 
 class DetermineTowerRho : public SubsysReco
 {
@@ -45,7 +60,7 @@ class DetermineTowerRho : public SubsysReco
   int InitRun(PHCompositeNode *topNode) override;
   int process_event(PHCompositeNode *topNode) override;
 
-  // add rho method (Area or Multiplicity)
+  // add rho method (Area, Multiplicity, Grid or Grid with flow modulation)
   void add_method(TowerRho::Method rho_method, std::string output = "")
   {
     // get method name
@@ -76,6 +91,10 @@ class DetermineTowerRho : public SubsysReco
   // inputs for background jets
   void add_tower_input(JetInput *input) { _inputs.push_back(input); }
 
+  // use already clustered background jets (with areas) instead of the tower inputs
+  void set_jet_input(const std::string &jet_node) { m_jet_input_name = jet_node; }
+  const std::string &get_jet_input() const { return m_jet_input_name; }
+
   void set_algo(Jet::ALGO algo) { m_bkgd_jet_algo = algo; }
   Jet::ALGO get_algo() { return m_bkgd_jet_algo; }
 
@@ -107,6 +126,14 @@ class DetermineTowerRho : public SubsysReco
   void set_ghost_area(float ghost_area) { m_ghost_area = ghost_area; }  // default is 0.01
   float get_ghost_area() const { return m_ghost_area; }
 
+  // set the size of the eta-phi patches for the GRID methods, adjusted so the patches tile the acceptance
+  void set_grid_size(float grid_size) { m_grid_size = grid_size; }  // default is 0.5
+  float get_grid_size() const { return m_grid_size; }
+
+  // TowerBackground node providing v2 and Psi2 for the GRID_FLOW method
+  void set_flow_background_node(const std::string &name) { m_flow_background_name = name; }
+  const std::string &get_flow_background_node() const { return m_flow_background_name; }
+
   // print settings
   void print_settings(std::ostream &os = std::cout) const;
 
@@ -156,7 +183,30 @@ class DetermineTowerRho : public SubsysReco
   fastjet::JetAlgorithm get_fj_algo();
   std::string get_fj_algo_name();
   std::string m_fj_algo_name;
-  std::vector<fastjet::PseudoJet> get_pseudojets(PHCompositeNode *topNode);
+  void get_input_particles(PHCompositeNode *topNode);
+  std::vector<fastjet::PseudoJet> get_pseudojets();
+  std::vector<JetInputParticle> m_input_particles;  // reused event to event
+
+  // background jets from JetReco
+  std::string m_jet_input_name{""};
+  int select_container_jets(JetContainer *jets);
+
+  // selected background jets, shared by the rho methods
+  std::vector<float> m_bkgd_jet_pt;
+  std::vector<float> m_bkgd_jet_area;
+  std::vector<int> m_bkgd_jet_ncomp;
+  // estimated number of pure ghost jets missing from a JetContainer input
+  float m_bkgd_n_empty_jets{0};
+
+  // grid estimate, no clustering
+  float m_grid_size{0.5};
+  std::string m_flow_background_name{"TowerInfoBackground_Sub2"};
+  std::vector<float> m_grid_pt;  // reused event to event
+  void _rho_grid(bool flow_modulated, float v2, float Psi2, float &rho, float &sigma);
+
+  void _rho_area(float &rho, float &sigma) const;
+  void _rho_area_clustered(float &rho, float &sigma);  // cross check of the JetContainer input
+  void _rho_mult(float &rho, float &sigma) const;
 
   float _percentile(const std::vector<float> &sorted_vec,
                     const float percentile,
@@ -0,0 +1,133 @@
+#include "GridConstituentSubtractor.h"
+
+#include <calobase/RawTowerDefs.h>
+#include <calobase/RawTowerGeom.h>
+#include <calobase/RawTowerGeomContainer.h>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+
+void GridConstituentSubtractor::initialize(RawTowerGeomContainer *geom)
+{
+  m_neta = geom->get_etabins();
+  m_nphi = geom->get_phibins();
+
+  m_eta.assign(size(), 0);
+  m_phi.assign(size(), 0);
+  m_cosheta.assign(size(), 0);
+  for (int ieta = 0; ieta < m_neta; ieta++)
+  {
+    for (int iphi = 0; iphi < m_nphi; iphi++)
+    {
+      int index = ieta * m_nphi + iphi;
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(geom->get_calorimeter_id(), ieta, iphi);
+      RawTowerGeom *tower_geom = geom->get_tower_geometry(key);
+      if (tower_geom)
+      {
+        m_eta[index] = tower_geom->get_eta();
+        m_phi[index] = tower_geom->get_phi();
+      }
+      else
+      {
+        m_eta[index] = geom->get_etacenter(ieta);
+        m_phi[index] = geom->get_phicenter(iphi);
+      }
+      m_cosheta[index] = std::cosh(m_eta[index]);
+    }
+  }
+
+  // pairs are only kept within the maximal distance; this runs once
+  // per run, so a plain scan with an eta pre-check is good enough
+  m_pairs.clear();
+  const float maxdR2 = m_max_distance * m_max_distance;
+  for (int particle = 0; particle < size(); particle++)
+  {
+    for (int ghost = 0; ghost < size(); ghost++)
+    {
+      float deta = m_eta[particle] - m_eta[ghost];
+      if (std::fabs(deta) > m_max_distance)
+      {
+        continue;
+      }
+      float dphi = m_phi[particle] - m_phi[ghost];
+      if (dphi > M_PI)
+      {
+        dphi -= 2 * M_PI;
+      }
+      if (dphi < -M_PI)
+      {
+        dphi += 2 * M_PI;
+      }
+      float dR2 = deta * deta + dphi * dphi;
+      if (dR2 > maxdR2)
+      {
+        continue;
+      }
+      m_pairs.push_back({particle, ghost, std::sqrt(dR2)});
+    }
+  }
+  std::stable_sort(m_pairs.begin(), m_pairs.end(), [](const Pair &a, const Pair &b)
+                   { return a.deltaR < b.deltaR; });
+
+  m_particle_weight.assign(size(), 1);
+  m_order.reserve(m_pairs.size());
+}
+
+void GridConstituentSubtractor::subtract(std::vector<float> &pt, std::vector<float> &ghost_pt)
+{
+  // transfers pt between one particle and one ghost, whichever is
+  // smaller is used up
+  auto transfer = [&pt, &ghost_pt](const Pair &pair)
+  {
+    float &particle_pt = pt[pair.particle];
+    float &background_pt = ghost_pt[pair.ghost];
+    if (particle_pt <= 0 || background_pt <= 0)
+    {
+      return;
+    }
+    if (particle_pt >= background_pt)
+    {
+      particle_pt -= background_pt;
+      background_pt = 0;
+    }
+    else
+    {
+      background_pt -= particle_pt;
+      particle_pt = 0;
+    }
+  };
+
+  if (m_alpha == 0)
+  {
+    // distance is Delta R alone, the initialize() order holds
+    for (const auto &pair : m_pairs)
+    {
+      transfer(pair);
+    }
+    return;
+  }
+
+  // distance pt^alpha * Delta R, with the weight evaluated before any
+  // subtraction
+  for (int particle = 0; particle < size(); particle++)
+  {
+    m_particle_weight[particle] = (pt[particle] > 0 ? std::pow(pt[particle], m_alpha) : 0);
+  }
+  m_order.clear();
+  for (unsigned int ipair = 0; ipair < m_pairs.size(); ipair++)
+  {
+    const Pair &pair = m_pairs[ipair];
+    if (pt[pair.particle] <= 0 || ghost_pt[pair.ghost] <= 0)
+    {
+      continue;
+    }
+    m_order.emplace_back(m_particle_weight[pair.particle] * pair.deltaR, ipair);
+  }
+  std::sort(m_order.begin(), m_order.end());
+
+  for (const auto &order : m_order)
+  {
+    transfer(m_pairs[order.second]);
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef JETBACKGROUND_GRIDCONSTITUENTSUBTRACTOR_H
+#define JETBACKGROUND_GRIDCONSTITUENTSUBTRACTOR_H
+
+//===========================================================
+/// \file GridConstituentSubtractor.h
+/// \brief constituent subtraction on a fixed calorimeter grid
+//===========================================================
+
+#include <utility>
+#include <vector>
+
+// forward declarations
+class RawTowerGeomContainer;
+
+/// \class GridConstituentSubtractor
+///
+/// \brief constituent subtraction on a fixed calorimeter grid
+///
+/// Event-wide constituent subtraction (as in
+/// fastjet::contrib::ConstituentSubtractor::do_subtraction with one
+/// background proxy per tower) specialized to the towers of one
+/// calorimeter grid. The ghosts sit on the tower centers, so all
+/// particle-ghost pairs within the maximal distance and their Delta R
+/// are found once in initialize(). Per event only the pairs are ordered
+/// by pt^alpha * Delta R (not even that for alpha = 0) and the pt is
+/// transferred between particles and ghosts. Towers are addressed by
+/// ieta * nphi + iphi.
+///
+class GridConstituentSubtractor
+{
+ public:
+  GridConstituentSubtractor() = default;
+  ~GridConstituentSubtractor() = default;
+
+  void set_alpha(float alpha) { m_alpha = alpha; }
+  void set_max_distance(float max_distance) { m_max_distance = max_distance; }
+
+  //! builds the particle-ghost pair list from the tower centers
+  void initialize(RawTowerGeomContainer *geom);
+
+  bool is_initialized() const { return m_neta > 0; }
+  int get_neta() const { return m_neta; }
+  int get_nphi() const { return m_nphi; }
+  int size() const { return m_neta * m_nphi; }
+  unsigned int get_npairs() const { return m_pairs.size(); }
+
+  // tower center and cosh(eta), used to convert E <-> pt
+  float get_eta(int index) const { return m_eta[index]; }
+  float get_phi(int index) const { return m_phi[index]; }
+  float get_cosheta(int index) const { return m_cosheta[index]; }
+
+  //! subtracts the ghost pt from the particle pt in place. Both vectors
+  //! have size() entries; on return ghost_pt holds the unused background.
+  //! Particles with pt <= 0 do not take part
+  void subtract(std::vector<float> &pt, std::vector<float> &ghost_pt);
+
+ private:
+  struct Pair
+  {
+    int particle;
+    int ghost;
+    float deltaR;
+  };
+
+  float m_alpha{0};
+  float m_max_distance{0};
+
+  int m_neta{-1};
+  int m_nphi{-1};
+
+  std::vector<float> m_eta;
+  std::vector<float> m_phi;
+  std::vector<float> m_cosheta;
+
+  // all pairs within m_max_distance, ordered by Delta R
+  std::vector<Pair> m_pairs;
+
+  // per event ordering for alpha != 0, kept to avoid reallocation
+  std::vector<float> m_particle_weight;
+  std::vector<std::pair<float, unsigned int> > m_order;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef JETBACKGROUND_RANDOMCONE_H
+#define JETBACKGROUND_RANDOMCONE_H
+
+//===========================================================
+/// \file RandomCone.h
+/// \brief PHObject to store random / perpendicular cone delta pT on an event-by-event basis
+//===========================================================
+
+#include <phool/PHObject.h>
+
+#include <iostream>
+
+/// \class RandomCone
+///
+/// \brief PHObject to store random / perpendicular cone delta pT on an event-by-event basis
+///
+/// One entry per cone thrown by RandomConeReco (cone type, axis, delta pT
+/// and number of towers in the cone), plus the cone radius and the
+/// centrality of the event
+
+class RandomCone : public PHObject
+{
+ public:
+  // enum for how the cone axis was chosen
+  enum ConeType
+  {
+    RANDOM = 0,
+    PERPENDICULAR = 1
+  };
+
+  ~RandomCone() override{};
+
+  void identify(std::ostream &os = std::cout) const override { os << "RandomCone base class" << std::endl; };
+  int isValid() const override { return 0; }
+
+  // event
+  virtual void set_R(float /*R*/) {}
+  virtual void set_centile(float /*centile*/) {}
+  virtual void set_centrality_bin(int /*bin*/) {}
+
+  virtual float get_R() const { return 0; }
+  virtual float get_centile() const { return -99; }
+  virtual int get_centrality_bin() const { return -99; }
+
+  // cones
+  virtual void add_cone(RandomCone::ConeType /*type*/, float /*eta*/, float /*phi*/, float /*dpt*/, int /*ntowers*/) {}
+
+  virtual unsigned int size() const { return 0; }
+  virtual RandomCone::ConeType get_type(unsigned int /*icone*/) const { return ConeType::RANDOM; }
+  virtual float get_eta(unsigned int /*icone*/) const { return 0; }
+  virtual float get_phi(unsigned int /*icone*/) const { return 0; }
+  virtual float get_dpt(unsigned int /*icone*/) const { return 0; }
+  virtual int get_ntowers(unsigned int /*icone*/) const { return 0; }
+
+ protected:
+  RandomCone() {}  // ctor
+
+ private:
+  ClassDefOverride(RandomCone, 1);
+};
+
+#endif  // JETBACKGROUND_RANDOMCONE_H
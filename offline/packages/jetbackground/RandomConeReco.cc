@@ -0,0 +1,309 @@
+#include "RandomConeReco.h"
+
+#include "RandomCone.h"
+#include "RandomConev1.h"
+#include "TowerBackground.h"
+
+// sPHENIX includes
+#include <calobase/RawTowerGeomContainer.h>
+#include <calobase/TowerInfo.h>
+#include <calobase/TowerInfoContainer.h>
+
+#include <centrality/CentralityInfo.h>
+
+#include <jetbase/Jet.h>
+#include <jetbase/JetContainer.h>
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/SubsysReco.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
+#include <phool/PHNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/PHObject.h>
+#include <phool/PHRandomSeed.h>
+#include <phool/getClass.h>
+#include <phool/phool.h>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+RandomConeReco::RandomConeReco(const std::string &name)
+  : SubsysReco(name)
+{
+  // initialize rng
+  const uint seed = PHRandomSeed();
+  m_rng.reset(gsl_rng_alloc(gsl_rng_mt19937));
+  gsl_rng_set(m_rng.get(), seed);
+}
+
+int RandomConeReco::InitRun(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 0)
+  {
+    std::cout << "RandomConeReco::InitRun: " << m_ncones << " random cones of R = " << m_R
+              << " within |eta| < " << m_abs_eta - m_R << " from " << m_towerNodePrefix
+              << (m_use_raw_towers ? " towers minus " + m_background_node : " subtracted towers") << std::endl;
+    if (!m_jet_node.empty())
+    {
+      std::cout << "RandomConeReco::InitRun: perpendicular cones to the leading jet of " << m_jet_node << std::endl;
+    }
+  }
+
+  // geometry is resolved with the first event
+  m_neta = -1;
+
+  return CreateNode(topNode);
+}
+
+int RandomConeReco::process_event(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 1)
+  {
+    std::cout << "RandomConeReco::process_event -- entered" << std::endl;
+  }
+
+  std::string suffix = (m_use_raw_towers ? "" : "_SUB1");
+  TowerInfoContainer *towersEM = findNode::getClass<TowerInfoContainer>(topNode, m_towerNodePrefix + "_CEMC_RETOWER" + suffix);
+  TowerInfoContainer *towersIH = findNode::getClass<TowerInfoContainer>(topNode, m_towerNodePrefix + "_HCALIN" + suffix);
+  TowerInfoContainer *towersOH = findNode::getClass<TowerInfoContainer>(topNode, m_towerNodePrefix + "_HCALOUT" + suffix);
+  if (!towersEM || !towersIH || !towersOH)
+  {
+    std::cout << PHWHERE << " missing " << m_towerNodePrefix << " tower nodes, exiting" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  if (m_neta < 0)
+  {
+    RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
+    if (!geomIH)
+    {
+      std::cout << PHWHERE << " missing TOWERGEOM_HCALIN node, exiting" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+    init_grid(geomIH);
+  }
+
+  std::vector<float> no_UE;
+  float v2 = 0;
+  float Psi2 = 0;
+  TowerBackground *towerbackground = nullptr;
+  if (m_use_raw_towers)
+  {
+    towerbackground = findNode::getClass<TowerBackground>(topNode, m_background_node);
+    if (!towerbackground)
+    {
+      std::cout << PHWHERE << " missing " << m_background_node << " node, exiting" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+    if (m_use_flow_modulation)
+    {
+      v2 = towerbackground->get_v2();
+      Psi2 = towerbackground->get_Psi2();
+    }
+  }
+
+  // ET per tower, all layers summed
+  std::fill(m_et.begin(), m_et.end(), 0);
+  add_layer(towersEM, (towerbackground ? towerbackground->get_UE(0) : no_UE), v2, Psi2);
+  add_layer(towersIH, (towerbackground ? towerbackground->get_UE(1) : no_UE), v2, Psi2);
+  add_layer(towersOH, (towerbackground ? towerbackground->get_UE(2) : no_UE), v2, Psi2);
+
+  // running sums along phi for every eta row
+  for (int ieta = 0; ieta < m_neta; ++ieta)
+  {
+    const float *et = &m_et[ieta * m_nphi];
+    float *rowsum = &m_rowsum[ieta * (2 * m_nphi + 1)];
+    rowsum[0] = 0;
+    for (int k = 0; k < 2 * m_nphi; ++k)
+    {
+      rowsum[k + 1] = rowsum[k] + et[k % m_nphi];
+    }
+  }
+
+  RandomCone *cones = findNode::getClass<RandomCone>(topNode, m_output_node);
+  if (!cones)
+  {
+    std::cout << " ERROR -- can't find RandomCone node after it should have been created" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+  cones->Reset();
+  cones->set_R(m_R);
+
+  CentralityInfo *centrality = findNode::getClass<CentralityInfo>(topNode, m_centrality_node);
+  if (centrality)
+  {
+    cones->set_centile(centrality->get_centile(CentralityInfo::PROP::mbd_NS));
+    cones->set_centrality_bin(centrality->get_centrality_bin(CentralityInfo::PROP::mbd_NS));
+  }
+
+  // random cones
+  float eta_range = m_abs_eta - m_R;
+  for (int icone = 0; icone < m_ncones; ++icone)
+  {
+    float eta = eta_range * (2. * gsl_rng_uniform(m_rng.get()) - 1.);
+    float phi = M_PI * (2. * gsl_rng_uniform(m_rng.get()) - 1.);
+    int ntowers = 0;
+    float dpt = cone_sum(eta, phi, ntowers);
+    cones->add_cone(RandomCone::ConeType::RANDOM, eta, phi, dpt, ntowers);
+  }
+
+  // cones perpendicular to the leading jet
+  if (!m_jet_node.empty())
+  {
+    JetContainer *jets = findNode::getClass<JetContainer>(topNode, m_jet_node);
+    if (!jets)
+    {
+      std::cout << PHWHERE << " missing " << m_jet_node << " node, no perpendicular cones" << std::endl;
+    }
+    else
+    {
+      Jet *leading = nullptr;
+      for (auto jet : *jets)
+      {
+        if (std::fabs(jet->get_eta()) < eta_range && jet->get_pt() > m_leading_jet_min_pt && (!leading || jet->get_pt() > leading->get_pt()))
+        {
+          leading = jet;
+        }
+      }
+      if (leading)
+      {
+        for (float side : {-1.F, 1.F})
+        {
+          float phi = std::remainder(leading->get_phi() + side * M_PI / 2., 2. * M_PI);
+          int ntowers = 0;
+          float dpt = cone_sum(leading->get_eta(), phi, ntowers);
+          cones->add_cone(RandomCone::ConeType::PERPENDICULAR, leading->get_eta(), phi, dpt, ntowers);
+        }
+      }
+    }
+  }
+
+  if (Verbosity() > 2)
+  {
+    cones->identify();
+  }
+
+  if (Verbosity() > 1)
+  {
+    std::cout << "RandomConeReco::process_event -- exited" << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void RandomConeReco::init_grid(RawTowerGeomContainer *geom)
+{
+  m_neta = geom->get_etabins();
+  m_nphi = geom->get_phibins();
+  m_etacenter.resize(m_neta);
+  m_cosheta.resize(m_neta);
+  for (int ieta = 0; ieta < m_neta; ++ieta)
+  {
+    m_etacenter[ieta] = geom->get_etacenter(ieta);
+    m_cosheta[ieta] = std::cosh(m_etacenter[ieta]);
+  }
+  m_phicenter.resize(m_nphi);
+  for (int iphi = 0; iphi < m_nphi; ++iphi)
+  {
+    m_phicenter[iphi] = geom->get_phicenter(iphi);
+  }
+  m_phi0 = m_phicenter[0];
+  m_dphi = 2 * M_PI / m_nphi;
+
+  m_et.assign(m_neta * m_nphi, 0);
+  m_rowsum.assign(m_neta * (2 * m_nphi + 1), 0);
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "RandomConeReco::init_grid: " << m_neta << " x " << m_nphi << " towers" << std::endl;
+  }
+}
+
+void RandomConeReco::add_layer(TowerInfoContainer *towers, const std::vector<float> &UE, float v2, float Psi2)
+{
+  unsigned int nchannels = towers->size();
+  for (unsigned int channel = 0; channel < nchannels; channel++)
+  {
+    TowerInfo *tower = towers->get_tower_at_channel(channel);
+    unsigned int towerkey = towers->encode_key(channel);
+    int ieta = towers->getTowerEtaBin(towerkey);
+    int iphi = towers->getTowerPhiBin(towerkey);
+    float energy = tower->get_energy();
+    if (!UE.empty())
+    {
+      // if a tower is masked, leave it at zero as SubtractTowers does
+      if (tower->get_isHot() || tower->get_isNoCalib() || tower->get_isNotInstr() || tower->get_isBadChi2())
+      {
+        continue;
+      }
+      energy -= UE.at(ieta) * (1 + 2 * v2 * std::cos(2 * (m_phicenter[iphi] - Psi2)));
+    }
+    m_et[ieta * m_nphi + iphi] += energy / m_cosheta[ieta];
+  }
+}
+
+float RandomConeReco::cone_sum(float eta, float phi, int &ntowers) const
+{
+  // eta rows with their center within R of the cone axis
+  auto row_begin = std::lower_bound(m_etacenter.begin(), m_etacenter.end(), eta - m_R);
+  auto row_end = std::upper_bound(m_etacenter.begin(), m_etacenter.end(), eta + m_R);
+
+  float sum = 0;
+  ntowers = 0;
+  for (auto row = row_begin; row != row_end; ++row)
+  {
+    int ieta = row - m_etacenter.begin();
+    float deta = *row - eta;
+    float half_width = std::sqrt(std::max(0.f, m_R * m_R - deta * deta));
+
+    // towers k with phi0 + k * dphi within the half width, k taken mod nphi
+    int k_lo = std::ceil((phi - half_width - m_phi0) / m_dphi);
+    int k_hi = std::floor((phi + half_width - m_phi0) / m_dphi);
+    int n = std::min(k_hi - k_lo + 1, m_nphi);
+    if (n <= 0)
+    {
+      continue;
+    }
+    int start = ((k_lo % m_nphi) + m_nphi) % m_nphi;
+    const float *rowsum = &m_rowsum[ieta * (2 * m_nphi + 1)];
+    sum += rowsum[start + n] - rowsum[start];
+    ntowers += n;
+  }
+  return sum;
+}
+
+int RandomConeReco::CreateNode(PHCompositeNode *topNode)
+{
+  PHNodeIterator iter(topNode);
+
+  // Looking for the DST node
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  if (!dstNode)
+  {
+    std::cout << PHWHERE << "DST Node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // store the jet background stuff under a sub-node directory
+  PHCompositeNode *bkgNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "JETBACKGROUND"));
+  if (!bkgNode)
+  {
+    bkgNode = new PHCompositeNode("JETBACKGROUND");
+    dstNode->addNode(bkgNode);
+  }
+
+  RandomCone *cones = findNode::getClass<RandomCone>(topNode, m_output_node);
+  if (!cones)
+  {
+    cones = new RandomConev1();
+    PHIODataNode<PHObject> *coneDataNode = new PHIODataNode<PHObject>(cones, m_output_node, "PHObject");
+    bkgNode->addNode(coneDataNode);
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
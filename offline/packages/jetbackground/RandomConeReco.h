@@ -0,0 +1,117 @@
+#ifndef JETBACKGROUND_RANDOMCONERECO_H
+#define JETBACKGROUND_RANDOMCONERECO_H
+
+//===========================================================
+/// \file RandomConeReco.h
+/// \brief random / perpendicular cone delta pT from the calorimeter towers
+//===========================================================
+
+#include <fun4all/SubsysReco.h>
+
+#include <gsl/gsl_rng.h>
+
+// system includes
+#include <memory>  // for unique_ptr
+#include <string>
+#include <vector>
+
+// forward declarations
+class PHCompositeNode;
+class RawTowerGeomContainer;
+class TowerInfoContainer;
+
+/// \class RandomConeReco
+///
+/// \brief random / perpendicular cone delta pT from the calorimeter towers
+///
+/// Sums the ET of the UE-subtracted CEMC (retowered), IHCal and OHCal
+/// towers in cones of radius R and stores the sums as delta pT in a
+/// RandomCone node, together with the event centrality.
+///
+/// The towers are summed into one eta x phi grid per event, from which
+/// running sums along phi are built for every eta row. A cone is then
+/// a handful of eta rows with a contiguous phi range each, so every cone
+/// costs a few lookups independent of R and any number of cones can be
+/// thrown per event.
+///
+/// Random cones are thrown uniformly within |eta| < abs_eta - R. If a
+/// jet node is given, two cones perpendicular in phi to the leading jet
+/// are added. With set_use_raw_towers(true) the unsubtracted towers are
+/// used and the TowerBackground UE (with flow modulation if enabled) is
+/// subtracted on the fly.
+///
+class RandomConeReco : public SubsysReco
+{
+ public:
+  RandomConeReco(const std::string &name = "RandomConeReco");
+  ~RandomConeReco() override {}
+
+  int InitRun(PHCompositeNode *topNode) override;
+  int process_event(PHCompositeNode *topNode) override;
+
+  void set_cone_R(float R) { m_R = R; }
+  void set_n_cones(int n) { m_ncones = n; }
+  void set_abs_eta(float abseta) { m_abs_eta = abseta; }  // default is 1.1
+
+  // add two cones perpendicular to the leading jet of this node
+  void set_perpendicular_cones(const std::string &jet_node) { m_jet_node = jet_node; }
+  void set_leading_jet_min_pt(float pt) { m_leading_jet_min_pt = pt; }
+
+  void set_towerNodePrefix(const std::string &prefix)
+  {
+    m_towerNodePrefix = prefix;
+    return;
+  }
+  void set_use_raw_towers(bool b) { m_use_raw_towers = b; }
+  void set_background_node(const std::string &name) { m_background_node = name; }
+  void SetFlowModulation(bool use_flow_modulation) { m_use_flow_modulation = use_flow_modulation; }
+
+  void set_centrality_node(const std::string &name) { m_centrality_node = name; }
+  void set_output_node(const std::string &name) { m_output_node = name; }
+
+ private:
+  int CreateNode(PHCompositeNode *topNode);
+  void init_grid(RawTowerGeomContainer *geom);
+  void add_layer(TowerInfoContainer *towers, const std::vector<float> &UE, float v2, float Psi2);
+  float cone_sum(float eta, float phi, int &ntowers) const;
+
+  class Deleter
+  {
+   public:
+    //! delection operation
+    void operator()(gsl_rng *rng) const { gsl_rng_free(rng); }
+  };
+  std::unique_ptr<gsl_rng, Deleter> m_rng;
+
+  float m_R{0.4};
+  int m_ncones{1};
+  float m_abs_eta{1.1};
+
+  std::string m_jet_node{""};
+  float m_leading_jet_min_pt{5.0};
+
+  std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
+  bool m_use_raw_towers{false};
+  std::string m_background_node{"TowerInfoBackground_Sub2"};
+  bool m_use_flow_modulation{false};
+
+  std::string m_centrality_node{"CentralityInfo"};
+  std::string m_output_node{"RandomCone"};
+
+  // tower grid, set up once per run from the IHCal geometry
+  int m_neta{-1};
+  int m_nphi{-1};
+  std::vector<float> m_etacenter;
+  std::vector<float> m_cosheta;
+  std::vector<float> m_phicenter;
+  float m_phi0{0};
+  float m_dphi{0};
+
+  // per event: ET per tower (ieta * nphi + iphi), and per eta row the running
+  // sum over phi, twice around: m_rowsum[ieta * (2 * nphi + 1) + k] = sum of
+  // the ET of iphi = 0 .. k-1 (mod nphi)
+  std::vector<float> m_et;
+  std::vector<float> m_rowsum;
+};
+
+#endif  // JETBACKGROUND_RANDOMCONERECO_H
@@ -0,0 +1,39 @@
+#include "RandomConev1.h"
+
+#include <ostream>
+
+void RandomConev1::identify(std::ostream& os) const
+{
+  os << "RandomConev1: " << std::endl;
+  os << "\tR = " << m_R << ", centile = " << m_centile << ", centrality bin = " << m_centrality_bin << std::endl;
+  for (unsigned int icone = 0; icone < size(); ++icone)
+  {
+    os << "\tcone " << icone << (m_type[icone] == ConeType::PERPENDICULAR ? " (perpendicular)" : " (random)")
+       << ": eta = " << m_eta[icone] << ", phi = " << m_phi[icone]
+       << ", delta pT = " << m_dpt[icone] << ", towers = " << m_ntowers[icone] << std::endl;
+  }
+  os << "===============================";
+  return;
+}
+
+void RandomConev1::Reset()
+{
+  m_centile = -99;
+  m_centrality_bin = -99;
+  m_type.clear();
+  m_eta.clear();
+  m_phi.clear();
+  m_dpt.clear();
+  m_ntowers.clear();
+  return;
+}
+
+void RandomConev1::add_cone(RandomCone::ConeType type, float eta, float phi, float dpt, int ntowers)
+{
+  m_type.push_back(type);
+  m_eta.push_back(eta);
+  m_phi.push_back(phi);
+  m_dpt.push_back(dpt);
+  m_ntowers.push_back(ntowers);
+  return;
+}
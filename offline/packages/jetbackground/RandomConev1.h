@@ -0,0 +1,58 @@
+#ifndef JETBACKGROUND_RANDOMCONEV1_H
+#define JETBACKGROUND_RANDOMCONEV1_H
+
+//===========================================================
+/// \file RandomConev1.h
+/// \brief cones stored as flat per-cone arrays
+//===========================================================
+
+#include "RandomCone.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+class RandomConev1 : public RandomCone
+{
+ public:
+  RandomConev1() = default;
+  ~RandomConev1() override {}
+
+  void identify(std::ostream &os = std::cout) const override;
+  void Reset() override;
+  int isValid() const override { return 1; }
+
+  // event
+  void set_R(float R) override { m_R = R; }
+  void set_centile(float centile) override { m_centile = centile; }
+  void set_centrality_bin(int bin) override { m_centrality_bin = bin; }
+
+  float get_R() const override { return m_R; }
+  float get_centile() const override { return m_centile; }
+  int get_centrality_bin() const override { return m_centrality_bin; }
+
+  // cones
+  void add_cone(RandomCone::ConeType type, float eta, float phi, float dpt, int ntowers) override;
+
+  unsigned int size() const override { return m_dpt.size(); }
+  RandomCone::ConeType get_type(unsigned int icone) const override { return static_cast<RandomCone::ConeType>(m_type.at(icone)); }
+  float get_eta(unsigned int icone) const override { return m_eta.at(icone); }
+  float get_phi(unsigned int icone) const override { return m_phi.at(icone); }
+  float get_dpt(unsigned int icone) const override { return m_dpt.at(icone); }
+  int get_ntowers(unsigned int icone) const override { return m_ntowers.at(icone); }
+
+ private:
+  float m_R{0};
+  float m_centile{-99};
+  int m_centrality_bin{-99};
+
+  std::vector<uint8_t> m_type;
+  std::vector<float> m_eta;
+  std::vector<float> m_phi;
+  std::vector<float> m_dpt;
+  std::vector<uint16_t> m_ntowers;
+
+  ClassDefOverride(RandomConev1, 1);
+};
+
+#endif  // JETBACKGROUND_RANDOMCONEV1_H
@@ -22,6 +22,8 @@
 #include <phool/phool.h>
 
 // standard includes
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <map>
 #include <utility>
@@ -34,6 +36,10 @@ RetowerCEMC::RetowerCEMC(const std::string &name)
 
 int RetowerCEMC::InitRun(PHCompositeNode *topNode)
 {
+  // the retowering matrix is rebuilt on the first event of each run
+  _NETA = -1;
+  _NPHI = -1;
+
   CreateNode(topNode);
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -71,166 +77,65 @@ int RetowerCEMC::process_event(PHCompositeNode *topNode)
   RawTowerGeomContainer *geomEM = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_CEMC");
   RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
 
-  // setup grid
+  // setup grid and retowering matrix
 
   if (_NETA < 0)
   {
-    _NETA = geomIH->get_etabins();
-    _NPHI = geomIH->get_phibins();
-
-    _EMCAL_RETOWER_E.resize(_NETA, std::vector<float>(_NPHI, 0));
-    _EMCAL_RETOWER_MASKED_A.resize(_NETA, std::vector<float>(_NPHI, 0));
-    _EMCAL_RETOWER_TOTAL_A.resize(_NETA, std::vector<float>(_NPHI, 0));
+    BuildRetowerMatrix(geomEM, geomIH, towerinfosEM3);
   }
 
-  for (int eta = 0; eta < _NETA; eta++)
-  {
-    for (int phi = 0; phi < _NPHI; phi++)
-    {
-      _EMCAL_RETOWER_E[eta][phi] = 0;
-      _EMCAL_RETOWER_MASKED_A[eta][phi] = 0;
-      _EMCAL_RETOWER_TOTAL_A[eta][phi] = 0;
-    }
-  }
+  // fill the CEMC energies (and bad tower flags) by column
+  std::fill(_EMCAL_E.begin(), _EMCAL_E.end(), 0);
+  std::fill(_EMCAL_ISBAD.begin(), _EMCAL_ISBAD.end(), 0);
 
-  // partition existing CEMC energies among grid
   if (m_use_towerinfo)
   {
-    if (!towerinfosEM3)
-    {
-      std::cout << PHWHERE << "no emcal tower info object, doing nothing" << std::endl;
-      return Fun4AllReturnCodes::ABORTRUN;
-    }
-    unsigned int nchannels = towerinfosEM3->size();
+    unsigned int nchannels = std::min<unsigned int>(towerinfosEM3->size(), _NCOLUMNS);
     for (unsigned int channel = 0; channel < nchannels; channel++)
     {
       TowerInfo *tower = towerinfosEM3->get_tower_at_channel(channel);
-      unsigned int channelkey = towerinfosEM3->encode_key(channel);
-      int ieta = towerinfosEM3->getTowerEtaBin(channelkey);
-      int iphi = towerinfosEM3->getTowerPhiBin(channelkey);
-      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ieta, iphi);
-      RawTowerGeom *tower_geom = geomEM->get_tower_geometry(key);
-      int this_IHetabin = geomIH->get_etabin(tower_geom->get_eta());
-      double fractionalcontribution[3] = {0};
-
-      if (_WEIGHTED_ENERGY_DISTRIBUTION == 1)
+      int this_isBad = tower->get_isHot() || tower->get_isNoCalib() || tower->get_isNotInstr() || tower->get_isBadChi2();
+      if (!this_isBad)
       {
-        std::pair<double, double> range_embin = geomEM->get_etabounds(tower_geom->get_bineta());
-        for (int etabin_iter = -1; etabin_iter <= 1; etabin_iter++)
-        {
-          if (this_IHetabin + etabin_iter < 0 || this_IHetabin + etabin_iter >= _NETA)
-          {
-            continue;
-          }
-          std::pair<double, double> range_ihbin = geomIH->get_etabounds(this_IHetabin + etabin_iter);
-          if (range_ihbin.first <= range_embin.first && range_ihbin.second >= range_embin.second)
-          {
-            fractionalcontribution[etabin_iter + 1] = 1;
-          }
-          else if (range_ihbin.first <= range_embin.first && range_ihbin.second < range_embin.second && range_embin.first < range_ihbin.second)
-          {
-            fractionalcontribution[etabin_iter + 1] = (range_ihbin.second - range_embin.first) / (range_embin.second - range_embin.first);
-          }
-          else if (range_ihbin.first > range_embin.first && range_ihbin.second >= range_embin.second && range_embin.second > range_ihbin.first)
-          {
-            fractionalcontribution[etabin_iter + 1] = (range_embin.second - range_ihbin.first) / (range_embin.second - range_embin.first);
-          }
-          else
-          {
-            fractionalcontribution[etabin_iter + 1] = 0;
-          }
-        }
+        _EMCAL_E[channel] = tower->get_energy();
       }
       else
       {
-        fractionalcontribution[0] = 0;
-        fractionalcontribution[1] = 1;
-        fractionalcontribution[2] = 0;
-      }
-
-      int this_IHphibin = geomIH->get_phibin(tower_geom->get_phi());
-      float this_E = tower->get_energy();
-      int this_isBad = tower->get_isHot() || tower->get_isNoCalib() || tower->get_isNotInstr() || tower->get_isBadChi2();
-      for (int etabin_iter = -1; etabin_iter <= 1; etabin_iter++)
-      {
-        if (this_IHetabin + etabin_iter < 0 || this_IHetabin + etabin_iter >= _NETA)
-        {
-          continue;
-        }
-        if (!this_isBad)
-        {
-          _EMCAL_RETOWER_E[this_IHetabin + etabin_iter][this_IHphibin] += this_E * fractionalcontribution[etabin_iter + 1];
-        }
-        else
-        {
-          // if the tower is bad, don't add its energy to the retower and keep track of how much is masked
-          _EMCAL_RETOWER_MASKED_A[this_IHetabin + etabin_iter][this_IHphibin] += fractionalcontribution[etabin_iter + 1];
-        }
-        // also keep track of the total area going into the retower
-        _EMCAL_RETOWER_TOTAL_A[this_IHetabin + etabin_iter][this_IHphibin] += fractionalcontribution[etabin_iter + 1];
+        // if the tower is bad, don't add its energy to the retower and keep track of how much is masked
+        _EMCAL_ISBAD[channel] = 1;
       }
     }
   }
-
   else
   {
+    int nphiEM = geomEM->get_phibins();
     RawTowerContainer::ConstRange begin_end_EM = towersEM3->getTowers();
     for (RawTowerContainer::ConstIterator rtiter = begin_end_EM.first; rtiter != begin_end_EM.second; ++rtiter)
     {
       RawTower *tower = rtiter->second;
-      RawTowerGeom *tower_geom = geomEM->get_tower_geometry(tower->get_key());
-
-      int this_IHetabin = geomIH->get_etabin(tower_geom->get_eta());
-      double fractionalcontribution[3] = {0};
-
-      // distribute energy based on shadowing of the inner hcal geometry
-      if (_WEIGHTED_ENERGY_DISTRIBUTION == 1)
-      {
-        std::pair<double, double> range_embin = geomEM->get_etabounds(tower_geom->get_bineta());
-        for (int etabin_iter = -1; etabin_iter <= 1; etabin_iter++)
-        {
-          if (this_IHetabin + etabin_iter < 0 || this_IHetabin + etabin_iter >= _NETA)
-          {
-            continue;
-          }
-          std::pair<double, double> range_ihbin = geomIH->get_etabounds(this_IHetabin + etabin_iter);
-          if (range_ihbin.first <= range_embin.first && range_ihbin.second >= range_embin.second)
-          {
-            fractionalcontribution[etabin_iter + 1] = 1;
-          }
-          else if (range_ihbin.first <= range_embin.first && range_ihbin.second < range_embin.second && range_embin.first < range_ihbin.second)
-          {
-            fractionalcontribution[etabin_iter + 1] = (range_ihbin.second - range_embin.first) / (range_embin.second - range_embin.first);
-          }
-          else if (range_ihbin.first > range_embin.first && range_ihbin.second >= range_embin.second && range_embin.second > range_ihbin.first)
-          {
-            fractionalcontribution[etabin_iter + 1] = (range_embin.second - range_ihbin.first) / (range_embin.second - range_embin.first);
-          }
-          else
-          {
-            fractionalcontribution[etabin_iter + 1] = 0;
-          }
-        }
-      }
-      else
+      int column = tower->get_bineta() * nphiEM + tower->get_binphi();
+      if (column < 0 || column >= _NCOLUMNS)
       {
-        fractionalcontribution[0] = 0;
-        fractionalcontribution[1] = 1;
-        fractionalcontribution[2] = 0;
+        continue;
       }
+      _EMCAL_E[column] += tower->get_energy();
+    }
+  }
 
-      int this_IHphibin = geomIH->get_phibin(tower_geom->get_phi());
-      float this_E = tower->get_energy();
-
-      for (int etabin_iter = -1; etabin_iter <= 1; etabin_iter++)
-      {
-        if (this_IHetabin + etabin_iter < 0 || this_IHetabin + etabin_iter >= _NETA)
-        {
-          continue;
-        }
-        _EMCAL_RETOWER_E[this_IHetabin + etabin_iter][this_IHphibin] += this_E * fractionalcontribution[etabin_iter + 1];
-      }
+  // partition existing CEMC energies among grid
+  unsigned int nrows = _NETA * _NPHI;
+  for (unsigned int row = 0; row < nrows; row++)
+  {
+    float sumE = 0;
+    float masked_A = 0;
+    for (unsigned int entry = _RETOWER_ROW_OFFSET[row]; entry < _RETOWER_ROW_OFFSET[row + 1]; entry++)
+    {
+      unsigned int column = _RETOWER_COLUMN[entry];
+      sumE += _RETOWER_WEIGHT[entry] * _EMCAL_E[column];
+      masked_A += _RETOWER_WEIGHT[entry] * _EMCAL_ISBAD[column];
     }
+    _EMCAL_RETOWER_E[row] = sumE;
+    _EMCAL_RETOWER_MASKED_A[row] = masked_A;
   }
 
   if (m_use_towerinfo)
@@ -249,8 +154,11 @@ int RetowerCEMC::process_event(PHCompositeNode *topNode)
         unsigned int towerkey = (((unsigned int) eta) << 16U) + phi;
         unsigned int towerindex = emcal_retower->decode_key(towerkey);
         TowerInfo *towerinfo = emcal_retower->get_tower_at_channel(towerindex);
-        towerinfo->set_energy(_EMCAL_RETOWER_E[eta][phi]);
-        if (_EMCAL_RETOWER_MASKED_A[eta][phi] / _EMCAL_RETOWER_TOTAL_A[eta][phi] > _FRAC_CUT)
+        int row = eta * _NPHI + phi;
+        // bins without any CEMC coverage have nothing masked
+        float masked_frac = (_EMCAL_RETOWER_TOTAL_A[row] > 0) ? _EMCAL_RETOWER_MASKED_A[row] / _EMCAL_RETOWER_TOTAL_A[row] : 0;
+        towerinfo->set_energy(_EMCAL_RETOWER_E[row]);
+        if (masked_frac > _FRAC_CUT)
         {
           towerinfo->set_energy(0);
           towerinfo->set_isHot(true);
@@ -258,9 +166,9 @@ int RetowerCEMC::process_event(PHCompositeNode *topNode)
         else
         {
           // scale up the total energy to account for the amount that's been masked
-          towerinfo->set_energy(_EMCAL_RETOWER_E[eta][phi] * 1. / (1. - _EMCAL_RETOWER_MASKED_A[eta][phi] / _EMCAL_RETOWER_TOTAL_A[eta][phi]));
+          towerinfo->set_energy(_EMCAL_RETOWER_E[row] * 1. / (1. - masked_frac));
           // set the chi2 to be the masked fraction
-          towerinfo->set_chi2(_EMCAL_RETOWER_MASKED_A[eta][phi] / _EMCAL_RETOWER_TOTAL_A[eta][phi]);
+          towerinfo->set_chi2(masked_frac);
         }
       }
     }
@@ -279,7 +187,7 @@ int RetowerCEMC::process_event(PHCompositeNode *topNode)
       {
         RawTower *new_tower = new RawTowerv1();
 
-        new_tower->set_energy(_EMCAL_RETOWER_E[eta][phi]);
+        new_tower->set_energy(_EMCAL_RETOWER_E[eta * _NPHI + phi]);
         emcal_retower->AddTower(eta, phi, new_tower);
       }
     }
@@ -296,6 +204,146 @@ int RetowerCEMC::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void RetowerCEMC::BuildRetowerMatrix(RawTowerGeomContainer *geomEM, RawTowerGeomContainer *geomIH, TowerInfoContainer *towerinfosEM)
+{
+  _NETA = geomIH->get_etabins();
+  _NPHI = geomIH->get_phibins();
+
+  _RETOWER_ENTRIES.clear();
+
+  if (towerinfosEM)
+  {
+    _NCOLUMNS = towerinfosEM->size();
+    for (int channel = 0; channel < _NCOLUMNS; channel++)
+    {
+      unsigned int channelkey = towerinfosEM->encode_key(channel);
+      int ieta = towerinfosEM->getTowerEtaBin(channelkey);
+      int iphi = towerinfosEM->getTowerPhiBin(channelkey);
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ieta, iphi);
+      RawTowerGeom *tower_geom = geomEM->get_tower_geometry(key);
+      if (!tower_geom)
+      {
+        continue;
+      }
+      AddRetowerWeights(geomEM, geomIH, tower_geom, channel);
+    }
+  }
+  else
+  {
+    int netaEM = geomEM->get_etabins();
+    int nphiEM = geomEM->get_phibins();
+    _NCOLUMNS = netaEM * nphiEM;
+    for (int ieta = 0; ieta < netaEM; ieta++)
+    {
+      for (int iphi = 0; iphi < nphiEM; iphi++)
+      {
+        const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ieta, iphi);
+        RawTowerGeom *tower_geom = geomEM->get_tower_geometry(key);
+        if (!tower_geom)
+        {
+          continue;
+        }
+        AddRetowerWeights(geomEM, geomIH, tower_geom, ieta * nphiEM + iphi);
+      }
+    }
+  }
+
+  // sort the entries into CSR rows
+  unsigned int nrows = _NETA * _NPHI;
+  _RETOWER_ROW_OFFSET.assign(nrows + 1, 0);
+  for (const auto &entry : _RETOWER_ENTRIES)
+  {
+    _RETOWER_ROW_OFFSET[entry.first + 1]++;
+  }
+  for (unsigned int row = 0; row < nrows; row++)
+  {
+    _RETOWER_ROW_OFFSET[row + 1] += _RETOWER_ROW_OFFSET[row];
+  }
+
+  _RETOWER_COLUMN.resize(_RETOWER_ENTRIES.size());
+  _RETOWER_WEIGHT.resize(_RETOWER_ENTRIES.size());
+  _EMCAL_RETOWER_TOTAL_A.assign(nrows, 0);
+  std::vector<unsigned int> fill(_RETOWER_ROW_OFFSET.begin(), _RETOWER_ROW_OFFSET.end() - 1);
+  for (const auto &entry : _RETOWER_ENTRIES)
+  {
+    unsigned int row = entry.first;
+    _RETOWER_COLUMN[fill[row]] = entry.second.first;
+    _RETOWER_WEIGHT[fill[row]] = entry.second.second;
+    fill[row]++;
+    // also keep track of the total area going into the retower
+    _EMCAL_RETOWER_TOTAL_A[row] += entry.second.second;
+  }
+  _RETOWER_ENTRIES.clear();
+  _RETOWER_ENTRIES.shrink_to_fit();
+
+  _EMCAL_E.assign(_NCOLUMNS, 0);
+  _EMCAL_ISBAD.assign(_NCOLUMNS, 0);
+  _EMCAL_RETOWER_E.assign(nrows, 0);
+  _EMCAL_RETOWER_MASKED_A.assign(nrows, 0);
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "RetowerCEMC::BuildRetowerMatrix: " << nrows << " x " << _NCOLUMNS << " retowering matrix with " << _RETOWER_WEIGHT.size() << " entries" << std::endl;
+  }
+}
+
+void RetowerCEMC::AddRetowerWeights(RawTowerGeomContainer *geomEM, RawTowerGeomContainer *geomIH, RawTowerGeom *tower_geom, unsigned int column)
+{
+  int this_IHetabin = geomIH->get_etabin(tower_geom->get_eta());
+  int this_IHphibin = geomIH->get_phibin(tower_geom->get_phi());
+  double fractionalcontribution[3] = {0};
+
+  // distribute energy based on shadowing of the inner hcal geometry
+  if (_WEIGHTED_ENERGY_DISTRIBUTION == 1)
+  {
+    std::pair<double, double> range_embin = geomEM->get_etabounds(tower_geom->get_bineta());
+    for (int etabin_iter = -1; etabin_iter <= 1; etabin_iter++)
+    {
+      if (this_IHetabin + etabin_iter < 0 || this_IHetabin + etabin_iter >= _NETA)
+      {
+        continue;
+      }
+      std::pair<double, double> range_ihbin = geomIH->get_etabounds(this_IHetabin + etabin_iter);
+      if (range_ihbin.first <= range_embin.first && range_ihbin.second >= range_embin.second)
+      {
+        fractionalcontribution[etabin_iter + 1] = 1;
+      }
+      else if (range_ihbin.first <= range_embin.first && range_ihbin.second < range_embin.second && range_embin.first < range_ihbin.second)
+      {
+        fractionalcontribution[etabin_iter + 1] = (range_ihbin.second - range_embin.first) / (range_embin.second - range_embin.first);
+      }
+      else if (range_ihbin.first > range_embin.first && range_ihbin.second >= range_embin.second && range_embin.second > range_ihbin.first)
+      {
+        fractionalcontribution[etabin_iter + 1] = (range_embin.second - range_ihbin.first) / (range_embin.second - range_embin.first);
+      }
+      else
+      {
+        fractionalcontribution[etabin_iter + 1] = 0;
+      }
+    }
+  }
+  else
+  {
+    fractionalcontribution[0] = 0;
+    fractionalcontribution[1] = 1;
+    fractionalcontribution[2] = 0;
+  }
+
+  for (int etabin_iter = -1; etabin_iter <= 1; etabin_iter++)
+  {
+    if (this_IHetabin + etabin_iter < 0 || this_IHetabin + etabin_iter >= _NETA)
+    {
+      continue;
+    }
+    if (fractionalcontribution[etabin_iter + 1] <= 0)
+    {
+      continue;
+    }
+    unsigned int row = (this_IHetabin + etabin_iter) * _NPHI + this_IHphibin;
+    _RETOWER_ENTRIES.push_back(std::make_pair(row, std::make_pair(column, (float) fractionalcontribution[etabin_iter + 1])));
+  }
+}
+
 int RetowerCEMC::CreateNode(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
@@ -11,10 +11,14 @@
 
 // system includes
 #include <string>
+#include <utility>
 #include <vector>
 
 // forward declarations
 class PHCompositeNode;
+class RawTowerGeom;
+class RawTowerGeomContainer;
+class TowerInfoContainer;
 
 /// \class RetowerCEMC
 ///
@@ -23,6 +27,12 @@ class PHCompositeNode;
 /// Using the existing CEMC tower collection, creates a new
 /// 0.1x0.1-towerized version appropriate for HI jet reconstruction
 ///
+/// The fractional overlaps of the CEMC towers with the IHCal eta bins
+/// only depend on the geometry, so they are stored once per run as a
+/// sparse (CSR) matrix with one row per retowered bin and one column
+/// per CEMC tower. Per event the retowered energies and masked areas
+/// are a single matrix-vector product over the CEMC energies.
+///
 class RetowerCEMC : public SubsysReco
 {
  public:
@@ -48,15 +58,34 @@ class RetowerCEMC : public SubsysReco
 
  private:
   int CreateNode(PHCompositeNode *topNode);
+  void BuildRetowerMatrix(RawTowerGeomContainer *geomEM, RawTowerGeomContainer *geomIH, TowerInfoContainer *towerinfosEM);
+  void AddRetowerWeights(RawTowerGeomContainer *geomEM, RawTowerGeomContainer *geomIH, RawTowerGeom *tower_geom, unsigned int column);
   int _WEIGHTED_ENERGY_DISTRIBUTION{1};
   int _NETA{-1};
   int _NPHI{-1};
   float _FRAC_CUT{0.5};
   bool m_use_towerinfo{false};
-  std::vector<std::vector<float> > _EMCAL_RETOWER_E;
-  std::vector<std::vector<int> > _EMCAL_RETOWER_T;
-  std::vector<std::vector<float> > _EMCAL_RETOWER_MASKED_A;
-  std::vector<std::vector<float> > _EMCAL_RETOWER_TOTAL_A;
+  int _NCOLUMNS{0};
+
+  // retowering matrix in CSR format, rows are retowered bins
+  // (ieta * _NPHI + iphi), columns are CEMC towers (the channel for
+  // tower info, ieta * nphi + iphi of the CEMC geometry otherwise)
+  std::vector<unsigned int> _RETOWER_ROW_OFFSET;
+  std::vector<unsigned int> _RETOWER_COLUMN;
+  std::vector<float> _RETOWER_WEIGHT;
+
+  // per event input, indexed by column
+  std::vector<float> _EMCAL_E;
+  std::vector<float> _EMCAL_ISBAD;
+
+  // per event output, indexed by row
+  std::vector<float> _EMCAL_RETOWER_E;
+  std::vector<float> _EMCAL_RETOWER_MASKED_A;
+  // geometric, filled with the matrix
+  std::vector<float> _EMCAL_RETOWER_TOTAL_A;
+
+  // (row, column, weight) entries collected while building the matrix
+  std::vector<std::pair<unsigned int, std::pair<unsigned int, float> > > _RETOWER_ENTRIES;
   std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
   std::string EMTowerName;
   std::string IHTowerName;
@@ -1,5 +1,6 @@
 #include "SubtractTowers.h"
 
+#include "CaloGrid.h"
 #include "TowerBackground.h"
 
 // sPHENIX includes
@@ -141,10 +142,25 @@ int SubtractTowers::process_event(PHCompositeNode *topNode)
   float background_v2 = towerbackground->get_v2();
   float background_Psi2 = towerbackground->get_Psi2();
 
+  CaloGrid *grid = nullptr;
+  if (m_use_towerinfo && m_use_calogrid)
+  {
+    grid = findNode::getClass<CaloGrid>(topNode, m_gridName);
+    if (!grid)
+    {
+      std::cout << "SubtractTowers::process_event: Cannot find node " << m_gridName << std::endl;
+      exit(1);
+    }
+  }
+
   // EMCal
 
   // replicate existing towers
-  if (m_use_towerinfo)
+  if (grid)
+  {
+    SubtractGridLayer(CaloGrid::CEMC, grid, towerinfosEM3, emcal_towerinfos, towerbackground->get_UE(0), background_v2, background_Psi2);
+  }
+  else if (m_use_towerinfo)
   {
     unsigned int nchannels_em = towerinfosEM3->size();
     for (unsigned int channel = 0; channel < nchannels_em; channel++)
@@ -232,7 +248,11 @@ int SubtractTowers::process_event(PHCompositeNode *topNode)
   }
   // IHCal
   // replicate existing towers
-  if (m_use_towerinfo)
+  if (grid)
+  {
+    SubtractGridLayer(CaloGrid::HCALIN, grid, towerinfosIH3, ihcal_towerinfos, towerbackground->get_UE(1), background_v2, background_Psi2);
+  }
+  else if (m_use_towerinfo)
   {
     unsigned int nchannels_ih = towerinfosIH3->size();
     for (unsigned int channel = 0; channel < nchannels_ih; channel++)
@@ -318,7 +338,11 @@ int SubtractTowers::process_event(PHCompositeNode *topNode)
   // OHCal
 
   // replicate existing towers
-  if (m_use_towerinfo)
+  if (grid)
+  {
+    SubtractGridLayer(CaloGrid::HCALOUT, grid, towerinfosOH3, ohcal_towerinfos, towerbackground->get_UE(2), background_v2, background_Psi2);
+  }
+  else if (m_use_towerinfo)
   {
     unsigned int nchannels_oh = towerinfosOH3->size();
     for (unsigned int channel = 0; channel < nchannels_oh; channel++)
@@ -425,6 +449,41 @@ int SubtractTowers::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void SubtractTowers::SubtractGridLayer(int layer, CaloGrid *grid, TowerInfoContainer *input, TowerInfoContainer *output, const std::vector<float> &UE, float v2, float Psi2)
+{
+  const float *grid_E = grid->get_E(layer);
+  const float *grid_phi = grid->get_phi(layer);
+
+  unsigned int nchannels = output->size();
+  for (unsigned int channel = 0; channel < nchannels; channel++)
+  {
+    int index = grid->get_index_of_channel(layer, channel);
+    int ieta = grid->get_ieta(index);
+
+    float raw_energy = grid_E[index];
+    float this_UE = UE.at(ieta);
+    if (_use_flow_modulation)
+    {
+      this_UE = this_UE * (1 + 2 * v2 * std::cos(2 * (grid_phi[index] - Psi2)));
+    }
+    float new_energy = raw_energy - this_UE;
+    // if a tower is masked, leave it at zero
+    if (grid->is_bad(layer, index))
+    {
+      new_energy = 0;
+    }
+
+    TowerInfo *tower = output->get_tower_at_channel(channel);
+    tower->set_time(input->get_tower_at_channel(channel)->get_time());
+    tower->set_energy(new_energy);
+
+    if (Verbosity() > 5)
+    {
+      std::cout << "SubtractTowers::process_event : layer " << layer << " tower at ieta / iphi = " << ieta << " / " << grid->get_iphi(index) << ", pre-sub / after-sub E = " << raw_energy << " / " << new_energy << std::endl;
+    }
+  }
+}
+
 int SubtractTowers::CreateNode(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
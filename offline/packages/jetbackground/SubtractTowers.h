@@ -10,9 +10,12 @@
 #include <fun4all/SubsysReco.h>
 
 #include <string>
+#include <vector>
 
 // forward declarations
+class CaloGrid;
 class PHCompositeNode;
+class TowerInfoContainer;
 
 /// \class SubtractTowers
 ///
@@ -41,12 +44,21 @@ class SubtractTowers : public SubsysReco
     m_towerNodePrefix = prefix;
     return;
   }
+  // read raw towers from the shared CaloGrid filled by CaloGridBuilder
+  void set_use_calogrid(bool use_calogrid)
+  {
+    m_use_calogrid = use_calogrid;
+  }
+  void set_gridName(const std::string &name) { m_gridName = name; }
 
  private:
   int CreateNode(PHCompositeNode *topNode);
+  void SubtractGridLayer(int layer, CaloGrid *grid, TowerInfoContainer *input, TowerInfoContainer *output, const std::vector<float> &UE, float v2, float Psi2);
 
   bool m_use_towerinfo{false};
+  bool m_use_calogrid{false};
   bool _use_flow_modulation{false};
+  std::string m_gridName{"CaloGrid"};
   std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
   std::string EMTowerName;
   std::string IHTowerName;
@@ -8,6 +8,8 @@
 #include <calobase/RawTowerGeom.h>
 #include <calobase/RawTowerGeomContainer.h>
 #include <calobase/RawTowerv1.h>
+#include <calobase/TowerInfo.h>
+#include <calobase/TowerInfoContainer.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/SubsysReco.h>
@@ -25,6 +27,7 @@
 
 // standard includes
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -40,6 +43,36 @@ int SubtractTowersCS::InitRun(PHCompositeNode *topNode)
 {
   CreateNode(topNode);
 
+  // the TowerInfo path always uses the grid constituent subtraction
+  if (_use_grid_cs || m_use_towerinfo)
+  {
+    if (std::isnan(_alpha) || !(_DeltaRmax > 0))
+    {
+      std::cout << PHWHERE << " grid constituent subtraction needs SetAlpha() and SetDeltaRmax(), doing nothing" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+
+    RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
+    RawTowerGeomContainer *geomOH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
+    if (!geomIH || !geomOH)
+    {
+      std::cout << PHWHERE << " missing HCal tower geometry, doing nothing" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+
+    _cs_IH.set_alpha(_alpha);
+    _cs_IH.set_max_distance(_DeltaRmax);
+    _cs_IH.initialize(geomIH);
+    _cs_OH.set_alpha(_alpha);
+    _cs_OH.set_max_distance(_DeltaRmax);
+    _cs_OH.initialize(geomOH);
+
+    if (Verbosity() > 0)
+    {
+      std::cout << "SubtractTowersCS::InitRun: grid constituent subtraction with " << _cs_IH.get_npairs() << " / " << _cs_OH.get_npairs() << " particle-ghost pairs in the IHCal / OHCal grid" << std::endl;
+    }
+  }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -50,6 +83,43 @@ int SubtractTowersCS::process_event(PHCompositeNode *topNode)
     std::cout << "SubtractTowersCS::process_event: entering, with _use_flow_modulation = " << _use_flow_modulation << std::endl;
   }
 
+  if (m_use_towerinfo)
+  {
+    EMTowerName = m_towerNodePrefix + "_CEMC_RETOWER";
+    IHTowerName = m_towerNodePrefix + "_HCALIN";
+    OHTowerName = m_towerNodePrefix + "_HCALOUT";
+    TowerInfoContainer *towerinfosEM3 = findNode::getClass<TowerInfoContainer>(topNode, EMTowerName);
+    TowerInfoContainer *towerinfosIH3 = findNode::getClass<TowerInfoContainer>(topNode, IHTowerName);
+    TowerInfoContainer *towerinfosOH3 = findNode::getClass<TowerInfoContainer>(topNode, OHTowerName);
+
+    // these should have already been created during InitRun()
+    TowerInfoContainer *emcal_towerinfos = findNode::getClass<TowerInfoContainer>(topNode, EMTowerName + "_SUB1CS");
+    TowerInfoContainer *ihcal_towerinfos = findNode::getClass<TowerInfoContainer>(topNode, IHTowerName + "_SUB1CS");
+    TowerInfoContainer *ohcal_towerinfos = findNode::getClass<TowerInfoContainer>(topNode, OHTowerName + "_SUB1CS");
+
+    TowerBackground *towerbackground = findNode::getClass<TowerBackground>(topNode, "TowerInfoBackground_Sub2");
+
+    if (!towerinfosEM3 || !towerinfosIH3 || !towerinfosOH3 || !emcal_towerinfos || !ihcal_towerinfos || !ohcal_towerinfos || !towerbackground)
+    {
+      std::cout << PHWHERE << "missing tower info or background object, doing nothing" << std::endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+
+    float background_v2 = towerbackground->get_v2();
+    float background_Psi2 = towerbackground->get_Psi2();
+
+    SubtractLayerGridCS(0, _cs_IH, towerinfosEM3, emcal_towerinfos, towerbackground->get_UE(0), background_v2, background_Psi2);
+    SubtractLayerGridCS(1, _cs_IH, towerinfosIH3, ihcal_towerinfos, towerbackground->get_UE(1), background_v2, background_Psi2);
+    SubtractLayerGridCS(2, _cs_OH, towerinfosOH3, ohcal_towerinfos, towerbackground->get_UE(2), background_v2, background_Psi2);
+
+    if (Verbosity() > 0)
+    {
+      std::cout << "SubtractTowersCS::process_event: exiting" << std::endl;
+    }
+
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
   // pull out the tower containers and geometry objects at the start
   RawTowerContainer *towersEM3 = findNode::getClass<RawTowerContainer>(topNode, "TOWER_CALIB_CEMC_RETOWER");
   RawTowerContainer *towersIH3 = findNode::getClass<RawTowerContainer>(topNode, "TOWER_CALIB_HCALIN");
@@ -84,6 +154,20 @@ int SubtractTowersCS::process_event(PHCompositeNode *topNode)
   float background_v2 = towerbackground->get_v2();
   float background_Psi2 = towerbackground->get_Psi2();
 
+  if (_use_grid_cs)
+  {
+    SubtractLayerGridCS(_cs_IH, towersEM3, emcal_towers, towerbackground->get_UE(0), background_v2, background_Psi2);
+    SubtractLayerGridCS(_cs_IH, towersIH3, ihcal_towers, towerbackground->get_UE(1), background_v2, background_Psi2);
+    SubtractLayerGridCS(_cs_OH, towersOH3, ohcal_towers, towerbackground->get_UE(2), background_v2, background_Psi2);
+
+    if (Verbosity() > 0)
+    {
+      std::cout << "SubtractTowersCS::process_event: exiting" << std::endl;
+    }
+
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
   // set up constituent subtraction
   fastjet::contrib::ConstituentSubtractor subtractor;
 
@@ -536,6 +620,144 @@ int SubtractTowersCS::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void SubtractTowersCS::RunGridCS(GridConstituentSubtractor &cs, const std::vector<float> &UE, float v2, float Psi2)
+{
+  const int nphi = cs.get_nphi();
+
+  // particles are the towers with positive energy, as pt on the grid
+  _pt.assign(cs.size(), 0);
+  for (int index = 0; index < cs.size(); index++)
+  {
+    if (_raw_E[index] > 0)
+    {
+      _pt[index] = _raw_E[index] / cs.get_cosheta(index);
+    }
+  }
+
+  // one ghost per tower carrying the (modulated) background
+  _ghost_pt.assign(cs.size(), 0);
+  for (int index = 0; index < cs.size(); index++)
+  {
+    double this_UE = UE.at(index / nphi);
+    if (_use_flow_modulation)
+    {
+      this_UE = this_UE * (1 + 2 * v2 * cos(2 * (cs.get_phi(index) - Psi2)));
+    }
+    _ghost_pt[index] = this_UE / cs.get_cosheta(index);
+  }
+
+  cs.subtract(_pt, _ghost_pt);
+
+  // back to energies; towers without positive energy did not take part
+  // and keep it
+  for (int index = 0; index < cs.size(); index++)
+  {
+    if (_raw_E[index] > 0)
+    {
+      _pt[index] *= cs.get_cosheta(index);
+    }
+    else
+    {
+      _pt[index] = _raw_E[index];
+    }
+  }
+
+  if (Verbosity() > 0)
+  {
+    float old_E = 0;
+    float new_E = 0;
+    float remaining_bkg = 0;
+    for (int index = 0; index < cs.size(); index++)
+    {
+      old_E += _raw_E[index];
+      new_E += _pt[index];
+      remaining_bkg += _ghost_pt[index] * cs.get_cosheta(index);
+    }
+    std::cout << "SubtractTowersCS::RunGridCS: old / new total E = " << old_E << " / " << new_E << " , remaining background E = " << remaining_bkg << std::endl;
+  }
+}
+
+void SubtractTowersCS::SubtractLayerGridCS(GridConstituentSubtractor &cs, RawTowerContainer *input, RawTowerContainer *output, const std::vector<float> &UE, float v2, float Psi2)
+{
+  const int nphi = cs.get_nphi();
+
+  _raw_E.assign(cs.size(), 0);
+  RawTowerContainer::ConstRange begin_end = input->getTowers();
+  for (RawTowerContainer::ConstIterator rtiter = begin_end.first; rtiter != begin_end.second; ++rtiter)
+  {
+    RawTower *tower = rtiter->second;
+    int index = tower->get_bineta() * nphi + tower->get_binphi();
+    _raw_E[index] += tower->get_energy();
+  }
+
+  RunGridCS(cs, UE, v2, Psi2);
+
+  for (int index = 0; index < cs.size(); index++)
+  {
+    RawTower *new_tower = new RawTowerv1();
+    new_tower->set_energy(_pt[index]);
+    output->AddTower(index / nphi, index % nphi, new_tower);
+
+    if (Verbosity() > 5)
+    {
+      std::cout << " SubtractTowersCS::SubtractLayerGridCS : subtracted tower at eta / phi = " << cs.get_eta(index) << " / " << cs.get_phi(index) << " , unsub. E = " << _raw_E[index] << " , sub. E = " << _pt[index] << std::endl;
+    }
+  }
+
+  return;
+}
+
+void SubtractTowersCS::SubtractLayerGridCS(int layer, GridConstituentSubtractor &cs, TowerInfoContainer *input, TowerInfoContainer *output, const std::vector<float> &UE, float v2, float Psi2)
+{
+  unsigned int nchannels = input->size();
+
+  // the channel -> grid index map only depends on the container layout
+  std::vector<int> &chindex = _channel_index[layer];
+  if (chindex.size() != nchannels)
+  {
+    chindex.resize(nchannels);
+    for (unsigned int channel = 0; channel < nchannels; channel++)
+    {
+      unsigned int key = input->encode_key(channel);
+      chindex[channel] = input->getTowerEtaBin(key) * cs.get_nphi() + input->getTowerPhiBin(key);
+    }
+  }
+
+  // masked towers do not enter the subtraction
+  _raw_E.assign(cs.size(), 0);
+  for (unsigned int channel = 0; channel < nchannels; channel++)
+  {
+    TowerInfo *tower = input->get_tower_at_channel(channel);
+    if (tower->get_isHot() || tower->get_isNoCalib() || tower->get_isNotInstr() || tower->get_isBadChi2())
+    {
+      continue;
+    }
+    _raw_E[chindex[channel]] += tower->get_energy();
+  }
+
+  RunGridCS(cs, UE, v2, Psi2);
+
+  // write in place into the preallocated output container, masked
+  // towers are left at zero as in SubtractTowers
+  for (unsigned int channel = 0; channel < nchannels; channel++)
+  {
+    TowerInfo *tower = input->get_tower_at_channel(channel);
+    bool isBad = tower->get_isHot() || tower->get_isNoCalib() || tower->get_isNotInstr() || tower->get_isBadChi2();
+    float new_energy = (isBad ? 0 : _pt[chindex[channel]]);
+
+    TowerInfo *new_tower = output->get_tower_at_channel(channel);
+    new_tower->set_time(tower->get_time());
+    new_tower->set_energy(new_energy);
+
+    if (Verbosity() > 5)
+    {
+      std::cout << " SubtractTowersCS::SubtractLayerGridCS : layer " << layer << " channel " << channel << ", pre-sub / after-sub E = " << tower->get_energy() << " / " << new_energy << std::endl;
+    }
+  }
+
+  return;
+}
+
 int SubtractTowersCS::CreateNode(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
@@ -548,6 +770,49 @@ int SubtractTowersCS::CreateNode(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTRUN;
   }
 
+  if (m_use_towerinfo)
+  {
+    // all three outputs live on the HCal grid, clone its layout once
+    IHTowerName = m_towerNodePrefix + "_HCALIN";
+    TowerInfoContainer *hcal_towers = findNode::getClass<TowerInfoContainer>(topNode, IHTowerName);
+    if (!hcal_towers)
+    {
+      std::cout << PHWHERE << "Cannot find " << IHTowerName << " for creating new tower containers. Exiting" << std::endl;
+      exit(1);
+    }
+
+    const std::string detectors[3] = {"CEMC", "HCALIN", "HCALOUT"};
+    const std::string names[3] = {m_towerNodePrefix + "_CEMC_RETOWER_SUB1CS", m_towerNodePrefix + "_HCALIN_SUB1CS", m_towerNodePrefix + "_HCALOUT_SUB1CS"};
+    for (int layer = 0; layer < 3; layer++)
+    {
+      PHCompositeNode *detNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", detectors[layer]));
+      if (!detNode)
+      {
+        std::cout << PHWHERE << detectors[layer] << " Node note found, doing nothing." << std::endl;
+        continue;
+      }
+
+      TowerInfoContainer *test_towers = findNode::getClass<TowerInfoContainer>(topNode, names[layer]);
+      if (!test_towers)
+      {
+        if (Verbosity() > 0)
+        {
+          std::cout << "SubtractTowersCS::CreateNode : creating " << names[layer] << " node " << std::endl;
+        }
+
+        TowerInfoContainer *towers = dynamic_cast<TowerInfoContainer *>(hcal_towers->CloneMe());
+        PHIODataNode<PHObject> *towerNode = new PHIODataNode<PHObject>(towers, names[layer], "PHObject");
+        detNode->addNode(towerNode);
+      }
+      else
+      {
+        std::cout << "SubtractTowersCS::CreateNode : " << names[layer] << " already exists! " << std::endl;
+      }
+    }
+
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
   // store the new EMCal towers
   PHCompositeNode *emcalNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "CEMC"));
   if (!emcalNode)
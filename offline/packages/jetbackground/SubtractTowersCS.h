@@ -7,13 +7,18 @@
 /// \author Dennis V. Perepelitsa
 //===========================================================
 
+#include "GridConstituentSubtractor.h"
+
 #include <fun4all/SubsysReco.h>
 
 #include <limits>
 #include <string>
+#include <vector>
 
 // forward declarations
 class PHCompositeNode;
+class RawTowerContainer;
+class TowerInfoContainer;
 
 /// \class SubtractTowersCS
 ///
@@ -36,13 +41,47 @@ class SubtractTowersCS : public SubsysReco
   void SetAlpha(float alpha) { _alpha = alpha; }
   void SetDeltaRmax(float DeltaRmax) { _DeltaRmax = DeltaRmax; }
 
+  // use the native grid constituent subtraction (tower centers as
+  // ghosts, pairs precomputed at InitRun) instead of fastjet
+  void SetUseGridCS(bool use_grid_cs) { _use_grid_cs = use_grid_cs; }
+
+  // read and write TowerInfo containers (always with the grid CS), the
+  // *_SUB1CS outputs are filled in place every event
+  void set_towerinfo(bool use_towerinfo)
+  {
+    m_use_towerinfo = use_towerinfo;
+  }
+  void set_towerNodePrefix(const std::string &prefix)
+  {
+    m_towerNodePrefix = prefix;
+    return;
+  }
+
  private:
   int CreateNode(PHCompositeNode *topNode);
+  void RunGridCS(GridConstituentSubtractor &cs, const std::vector<float> &UE, float v2, float Psi2);
+  void SubtractLayerGridCS(GridConstituentSubtractor &cs, RawTowerContainer *input, RawTowerContainer *output, const std::vector<float> &UE, float v2, float Psi2);
+  void SubtractLayerGridCS(int layer, GridConstituentSubtractor &cs, TowerInfoContainer *input, TowerInfoContainer *output, const std::vector<float> &UE, float v2, float Psi2);
 
   bool _use_flow_modulation{false};
+  bool _use_grid_cs{false};
+  bool m_use_towerinfo{false};
 
   float _alpha{std::numeric_limits<float>::quiet_NaN()};
   float _DeltaRmax{std::numeric_limits<float>::quiet_NaN()};
+
+  // CEMC (retowered) and IHCal share the IHCal grid
+  GridConstituentSubtractor _cs_IH;
+  GridConstituentSubtractor _cs_OH;
+  std::vector<float> _raw_E;
+  std::vector<float> _pt;
+  std::vector<float> _ghost_pt;
+  std::vector<int> _channel_index[3];
+
+  std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
+  std::string EMTowerName;
+  std::string IHTowerName;
+  std::string OHTowerName;
 };
 
 #endif
@@ -0,0 +1,273 @@
+#include "SyntheticTowerMaker.h"
+
+// sPHENIX includes
+#include <calobase/RawTowerDefs.h>
+#include <calobase/RawTowerGeom.h>
+#include <calobase/RawTowerGeomContainer.h>
+#include <calobase/RawTowerGeomContainer_Cylinderv1.h>
+#include <calobase/RawTowerGeomv1.h>
+#include <calobase/TowerInfo.h>
+#include <calobase/TowerInfoContainer.h>
+#include <calobase/TowerInfoContainerv1.h>
+
+#include <globalvertex/GlobalVertex.h>
+#include <globalvertex/GlobalVertexMap.h>
+#include <globalvertex/GlobalVertexMapv1.h>
+#include <globalvertex/GlobalVertexv1.h>
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/SubsysReco.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
+#include <phool/PHNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/PHObject.h>
+#include <phool/PHRandomSeed.h>
+#include <phool/getClass.h>
+#include <phool/phool.h>
+
+#include <gsl/gsl_randist.h>
+
+// standard includes
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  // transverse profile of the embedded jets
+  const float jet_sigma = 0.1;
+  const float jet_R = 0.4;
+}  // namespace
+
+SyntheticTowerMaker::SyntheticTowerMaker(const std::string &name)
+  : SubsysReco(name)
+{
+  // initialize rng
+  const uint seed = PHRandomSeed();
+  m_rng.reset(gsl_rng_alloc(gsl_rng_mt19937));
+  gsl_rng_set(m_rng.get(), seed);
+}
+
+int SyntheticTowerMaker::InitRun(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 0)
+  {
+    std::cout << "SyntheticTowerMaker::InitRun: dET/deta = " << m_dETdeta << ", v2 = " << m_v2
+              << ", " << m_njets << " jets of pt " << m_jet_pt << std::endl;
+  }
+
+  return CreateNodes(topNode);
+}
+
+int SyntheticTowerMaker::process_event(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 1)
+  {
+    std::cout << "SyntheticTowerMaker::process_event -- entered" << std::endl;
+  }
+
+  TowerInfoContainer *towersEM = findNode::getClass<TowerInfoContainer>(topNode, m_towerNodePrefix + "_CEMC");
+  TowerInfoContainer *towersIH = findNode::getClass<TowerInfoContainer>(topNode, m_towerNodePrefix + "_HCALIN");
+  TowerInfoContainer *towersOH = findNode::getClass<TowerInfoContainer>(topNode, m_towerNodePrefix + "_HCALOUT");
+  GlobalVertexMap *vertexmap = findNode::getClass<GlobalVertexMap>(topNode, "GlobalVertexMap");
+  if (!towersEM || !towersIH || !towersOH || !vertexmap)
+  {
+    std::cout << PHWHERE << " missing output nodes, exiting" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  GlobalVertex *vertex = new GlobalVertexv1(GlobalVertex::MBD);
+  vertex->set_z(gsl_ran_gaussian(m_rng.get(), m_vertex_sigma));
+  vertexmap->insert(vertex);
+
+  float Psi2 = M_PI * (gsl_rng_uniform(m_rng.get()) - 0.5);
+
+  m_jet_eta.clear();
+  m_jet_phi.clear();
+  for (int ijet = 0; ijet < m_njets; ++ijet)
+  {
+    m_jet_eta.push_back(0.7 * (2. * gsl_rng_uniform(m_rng.get()) - 1.));
+    m_jet_phi.push_back(M_PI * (2. * gsl_rng_uniform(m_rng.get()) - 1.));
+  }
+
+  fill_layer(0, towersEM, Psi2);
+  fill_layer(1, towersIH, Psi2);
+  fill_layer(2, towersOH, Psi2);
+
+  if (Verbosity() > 1)
+  {
+    std::cout << "SyntheticTowerMaker::process_event -- exited, Psi2 = " << Psi2 << ", vertex z = " << vertex->get_z() << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void SyntheticTowerMaker::fill_layer(int layer, TowerInfoContainer *towers, float Psi2)
+{
+  const std::vector<float> &eta = m_eta[layer];
+  const std::vector<float> &phi = m_phi[layer];
+  const std::vector<float> &area = m_area[layer];
+  float fraction = m_layer_fraction[layer];
+
+  unsigned int nchannels = towers->size();
+  for (unsigned int channel = 0; channel < nchannels; channel++)
+  {
+    // underlying event, flow modulated mean ET with gamma fluctuations
+    float mean = m_dETdeta * fraction * area[channel] / (2 * M_PI) * (1 + 2 * m_v2 * std::cos(2 * (phi[channel] - Psi2)));
+    float ET = (mean > 0 ? gsl_ran_gamma(m_rng.get(), m_gamma_shape, mean / m_gamma_shape) : 0);
+
+    // embedded jets, gaussian profile normalized to the jet pt
+    for (unsigned int ijet = 0; ijet < m_jet_eta.size(); ++ijet)
+    {
+      float deta = eta[channel] - m_jet_eta[ijet];
+      float dphi = std::remainder(phi[channel] - m_jet_phi[ijet], 2 * M_PI);
+      float dR2 = deta * deta + dphi * dphi;
+      if (dR2 < jet_R * jet_R)
+      {
+        ET += m_jet_pt * fraction * area[channel] * std::exp(-dR2 / (2 * jet_sigma * jet_sigma)) / (2 * M_PI * jet_sigma * jet_sigma);
+      }
+    }
+
+    TowerInfo *tower = towers->get_tower_at_channel(channel);
+    tower->set_energy(ET * std::cosh(eta[channel]));
+    tower->set_time(0);
+    tower->set_status(0);
+  }
+}
+
+int SyntheticTowerMaker::CreateNodes(PHCompositeNode *topNode)
+{
+  PHNodeIterator iter(topNode);
+
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  PHCompositeNode *runNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "RUN"));
+  if (!dstNode || !runNode)
+  {
+    std::cout << PHWHERE << "DST or RUN Node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // vertex
+  PHCompositeNode *globalNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "GLOBAL"));
+  if (!globalNode)
+  {
+    globalNode = new PHCompositeNode("GLOBAL");
+    dstNode->addNode(globalNode);
+  }
+  GlobalVertexMap *vertexmap = findNode::getClass<GlobalVertexMap>(topNode, "GlobalVertexMap");
+  if (!vertexmap)
+  {
+    vertexmap = new GlobalVertexMapv1();
+    PHIODataNode<PHObject> *vertexNode = new PHIODataNode<PHObject>(vertexmap, "GlobalVertexMap", "PHObject");
+    globalNode->addNode(vertexNode);
+  }
+
+  // geometry and towers, the CEMC on its own 96 x 256 grid, the HCals on 24 x 64
+  const std::string detectors[3] = {"CEMC", "HCALIN", "HCALOUT"};
+  const int neta[3] = {96, 24, 24};
+  const int nphi[3] = {256, 64, 64};
+  const double radius[3] = {93.5, 115, 177.423};
+  for (int layer = 0; layer < 3; ++layer)
+  {
+    RawTowerGeomContainer *geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_" + detectors[layer]);
+    if (!geom)
+    {
+      geom = CreateGeometry(runNode, detectors[layer], neta[layer], nphi[layer], radius[layer]);
+    }
+
+    PHNodeIterator dstIter(dstNode);
+    PHCompositeNode *detNode = dynamic_cast<PHCompositeNode *>(dstIter.findFirst("PHCompositeNode", detectors[layer]));
+    if (!detNode)
+    {
+      detNode = new PHCompositeNode(detectors[layer]);
+      dstNode->addNode(detNode);
+    }
+
+    std::string towerName = m_towerNodePrefix + "_" + detectors[layer];
+    TowerInfoContainer *towers = findNode::getClass<TowerInfoContainer>(topNode, towerName);
+    if (!towers)
+    {
+      towers = new TowerInfoContainerv1(layer == 0 ? TowerInfoContainer::EMCAL : TowerInfoContainer::HCAL);
+      PHIODataNode<PHObject> *towerNode = new PHIODataNode<PHObject>(towers, towerName, "PHObject");
+      detNode->addNode(towerNode);
+    }
+
+    // tower eta, phi and area by channel
+    unsigned int nchannels = towers->size();
+    m_eta[layer].resize(nchannels);
+    m_phi[layer].resize(nchannels);
+    m_area[layer].resize(nchannels);
+    for (unsigned int channel = 0; channel < nchannels; channel++)
+    {
+      unsigned int towerkey = towers->encode_key(channel);
+      int ieta = towers->getTowerEtaBin(towerkey);
+      int iphi = towers->getTowerPhiBin(towerkey);
+      std::pair<double, double> etabounds = geom->get_etabounds(ieta);
+      std::pair<double, double> phibounds = geom->get_phibounds(iphi);
+      m_eta[layer][channel] = geom->get_etacenter(ieta);
+      m_phi[layer][channel] = geom->get_phicenter(iphi);
+      m_area[layer][channel] = (etabounds.second - etabounds.first) * (phibounds.second - phibounds.first);
+    }
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+RawTowerGeomContainer *SyntheticTowerMaker::CreateGeometry(PHCompositeNode *runNode, const std::string &detector, int neta, int nphi, double radius)
+{
+  PHNodeIterator runIter(runNode);
+  PHCompositeNode *RunDetNode = dynamic_cast<PHCompositeNode *>(runIter.findFirst("PHCompositeNode", detector));
+  if (!RunDetNode)
+  {
+    RunDetNode = new PHCompositeNode(detector);
+    runNode->addNode(RunDetNode);
+  }
+
+  const RawTowerDefs::CalorimeterId caloid = RawTowerDefs::convert_name_to_caloid(detector);
+  RawTowerGeomContainer *geom = new RawTowerGeomContainer_Cylinderv1(caloid);
+  PHIODataNode<PHObject> *newNode = new PHIODataNode<PHObject>(geom, "TOWERGEOM_" + detector, "PHObject");
+  RunDetNode->addNode(newNode);
+
+  // uniform bins in |eta| < 1.1 and -pi < phi < pi
+  geom->set_radius(radius);
+  geom->set_etabins(neta);
+  geom->set_phibins(nphi);
+  double deta = 2.2 / neta;
+  double dphi = 2 * M_PI / nphi;
+  for (int ieta = 0; ieta < neta; ieta++)
+  {
+    geom->set_etabounds(ieta, std::make_pair(-1.1 + ieta * deta, -1.1 + (ieta + 1) * deta));
+  }
+  for (int iphi = 0; iphi < nphi; iphi++)
+  {
+    geom->set_phibounds(iphi, std::make_pair(-M_PI + iphi * dphi, -M_PI + (iphi + 1) * dphi));
+  }
+
+  // tower geometry as in CaloGeomMapping
+  for (int ieta = 0; ieta < neta; ieta++)
+  {
+    for (int iphi = 0; iphi < nphi; iphi++)
+    {
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(caloid, ieta, iphi);
+      const double x(radius * cos(geom->get_phicenter(iphi)));
+      const double y(radius * sin(geom->get_phicenter(iphi)));
+      const double z(radius / tan(2 * atan(exp(-1 * geom->get_etacenter(ieta)))));
+
+      RawTowerGeom *tg = new RawTowerGeomv1(key);
+      tg->set_center_x(x);
+      tg->set_center_y(y);
+      tg->set_center_z(z);
+      geom->add_tower_geometry(tg);
+    }
+  }
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "SyntheticTowerMaker::CreateGeometry: TOWERGEOM_" << detector << " with " << neta << " x " << nphi << " towers" << std::endl;
+  }
+
+  return geom;
+}
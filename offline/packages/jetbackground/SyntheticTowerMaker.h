@@ -0,0 +1,109 @@
+#ifndef JETBACKGROUND_SYNTHETICTOWERMAKER_H
+#define JETBACKGROUND_SYNTHETICTOWERMAKER_H
+
+//===========================================================
+/// \file SyntheticTowerMaker.h
+/// \brief synthetic heavy-ion calorimeter events for benchmarking the jet background chain
+//===========================================================
+
+#include <fun4all/SubsysReco.h>
+
+#include <gsl/gsl_rng.h>
+
+// system includes
+#include <memory>  // for unique_ptr
+#include <string>
+#include <vector>
+
+// forward declarations
+class PHCompositeNode;
+class RawTowerGeomContainer;
+class TowerInfoContainer;
+
+/// \class SyntheticTowerMaker
+///
+/// \brief synthetic heavy-ion calorimeter events for benchmarking the jet background chain
+///
+/// Creates the CEMC, IHCal and OHCal tower geometry (uniform eta x phi
+/// bins, no CDB), a GlobalVertexMap and the TOWERINFO_CALIB_* containers,
+/// and fills them every event with an underlying event of a given dET/deta,
+/// modulated by 1 + 2 v2 cos(2 (phi - Psi2)) with a random Psi2, plus an
+/// optional number of embedded jets. Tower ET fluctuates with a gamma
+/// distribution around the local mean. Together with a
+/// Fun4AllDummyInputManager this runs RetowerCEMC, JetReco,
+/// DetermineTowerBackground, CopyAndSubtractJets and SubtractTowers
+/// without any input file, see macros/Fun4All_HIJetBenchmark.C.
+///
+/// The multiplicity (dET/deta) and v2 can be changed between runs to scan
+/// centrality classes.
+///
+class SyntheticTowerMaker : public SubsysReco
+{
+ public:
+  SyntheticTowerMaker(const std::string &name = "SyntheticTowerMaker");
+  ~SyntheticTowerMaker() override {}
+
+  int InitRun(PHCompositeNode *topNode) override;
+  int process_event(PHCompositeNode *topNode) override;
+
+  //! underlying event ET per unit eta, summed over the three layers
+  void set_dET_deta(float dETdeta) { m_dETdeta = dETdeta; }
+  void set_v2(float v2) { m_v2 = v2; }
+
+  //! shape of the gamma distribution of the tower ET, larger is narrower
+  void set_tower_fluctuation_shape(float k) { m_gamma_shape = k; }
+
+  //! fraction of the ET in the CEMC, IHCal and OHCal
+  void set_layer_fractions(float em, float ih, float oh)
+  {
+    m_layer_fraction[0] = em;
+    m_layer_fraction[1] = ih;
+    m_layer_fraction[2] = oh;
+  }
+
+  //! jets of pt spread over the towers within dR < 0.4, |eta| < 0.7
+  void set_n_jets(int n) { m_njets = n; }
+  void set_jet_pt(float pt) { m_jet_pt = pt; }
+
+  void set_vertex_sigma(float sigma) { m_vertex_sigma = sigma; }
+
+  void set_towerNodePrefix(const std::string &prefix)
+  {
+    m_towerNodePrefix = prefix;
+    return;
+  }
+
+ private:
+  int CreateNodes(PHCompositeNode *topNode);
+  RawTowerGeomContainer *CreateGeometry(PHCompositeNode *runNode, const std::string &detector, int neta, int nphi, double radius);
+  void fill_layer(int layer, TowerInfoContainer *towers, float Psi2);
+
+  class Deleter
+  {
+   public:
+    //! delection operation
+    void operator()(gsl_rng *rng) const { gsl_rng_free(rng); }
+  };
+  std::unique_ptr<gsl_rng, Deleter> m_rng;
+
+  float m_dETdeta{500};
+  float m_v2{0.05};
+  float m_gamma_shape{2};
+  float m_layer_fraction[3]{0.6, 0.05, 0.35};
+  int m_njets{1};
+  float m_jet_pt{30};
+  float m_vertex_sigma{10};
+
+  std::string m_towerNodePrefix{"TOWERINFO_CALIB"};
+
+  // per layer and channel: tower eta, phi and eta x phi area
+  std::vector<float> m_eta[3];
+  std::vector<float> m_phi[3];
+  std::vector<float> m_area[3];
+
+  // jets of this event
+  std::vector<float> m_jet_eta;
+  std::vector<float> m_jet_phi;
+};
+
+#endif  // JETBACKGROUND_SYNTHETICTOWERMAKER_H
@@ -16,12 +16,20 @@ class TowerBackground : public PHObject
   virtual void set_UE(int /*layer*/, const std::vector<float> &/*UE*/) {}
   virtual void set_v2(float) {}
   virtual void set_Psi2(float) {}
+  virtual void set_v3(float) {}
+  virtual void set_Psi3(float) {}
+  virtual void set_v4(float) {}
+  virtual void set_Psi4(float) {}
   virtual void set_nStripsUsedForFlow(int) {}
   virtual void set_nTowersUsedForBkg(int) {}
 
   virtual std::vector<float> get_UE(int /*layer*/) { return std::vector<float>(); };
   virtual float get_v2() { return 0; }
   virtual float get_Psi2() { return 0; }
+  virtual float get_v3() { return 0; }
+  virtual float get_Psi3() { return 0; }
+  virtual float get_v4() { return 0; }
+  virtual float get_Psi4() { return 0; }
   virtual int get_nStripsUsedForFlow() { return 0; }
   virtual int get_nTowersUsedForBkg() { return 0; }
 
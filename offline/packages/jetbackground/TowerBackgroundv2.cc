@@ -0,0 +1,28 @@
+#include "TowerBackgroundv2.h"
+
+#include <memory>
+#include <ostream>
+
+TowerBackgroundv2::TowerBackgroundv2()
+{
+  _UE.resize(3, std::vector<float>(1, 0));
+}
+
+void TowerBackgroundv2::identify(std::ostream& os) const
+{
+  os << "TowerBackground: " << std::endl;
+  for (int n = 0; n < 3; n++)
+  {
+    os << " layer " << n << " : UE in " << _UE[n].size() << " eta bins: ";
+    for (float eta : _UE[n])
+    {
+      os << eta << " ";
+    }
+    os << std::endl;
+  }
+
+  os << " v2 = " << _v2 << ", Psi2 = " << _Psi2 << ", # towers used for bkg = " << _nTowers << " , # strips used for flow = " << _nStrips << std::endl;
+  os << " v3 = " << _v3 << ", Psi3 = " << _Psi3 << ", v4 = " << _v4 << ", Psi4 = " << _Psi4 << std::endl;
+
+  return;
+}
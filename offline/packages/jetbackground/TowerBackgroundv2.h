@@ -0,0 +1,54 @@
+#ifndef JETBACKGROUND_TOWERBACKGROUNDV2_H
+#define JETBACKGROUND_TOWERBACKGROUNDV2_H
+
+#include "TowerBackground.h"
+
+#include <iostream>
+#include <vector>
+
+// as TowerBackgroundv1, with the v3 and v4 flow harmonics
+class TowerBackgroundv2 : public TowerBackground
+{
+ public:
+  TowerBackgroundv2();
+  ~TowerBackgroundv2() override {}
+
+  void identify(std::ostream &os = std::cout) const override;
+  void Reset() override {}
+  int isValid() const override { return 1; }
+
+  void set_UE(int layer, const std::vector<float> &UE) override { _UE[layer] = UE; }
+  void set_v2(float v2) override { _v2 = v2; }
+  void set_Psi2(float Psi2) override { _Psi2 = Psi2; }
+  void set_v3(float v3) override { _v3 = v3; }
+  void set_Psi3(float Psi3) override { _Psi3 = Psi3; }
+  void set_v4(float v4) override { _v4 = v4; }
+  void set_Psi4(float Psi4) override { _Psi4 = Psi4; }
+  void set_nStripsUsedForFlow(int nStrips) override { _nStrips = nStrips; }
+  void set_nTowersUsedForBkg(int nTowers) override { _nTowers = nTowers; }
+
+  std::vector<float> get_UE(int layer) override { return _UE[layer]; }
+  float get_v2() override { return _v2; }
+  float get_Psi2() override { return _Psi2; }
+  float get_v3() override { return _v3; }
+  float get_Psi3() override { return _Psi3; }
+  float get_v4() override { return _v4; }
+  float get_Psi4() override { return _Psi4; }
+  int get_nStripsUsedForFlow() override { return _nStrips; }
+  int get_nTowersUsedForBkg() override { return _nTowers; }
+
+ private:
+  std::vector<std::vector<float> > _UE;
+  float _v2{0};
+  float _Psi2{0};
+  float _v3{0};
+  float _Psi3{0};
+  float _v4{0};
+  float _Psi4{0};
+  int _nStrips{0};
+  int _nTowers{0};
+
+  ClassDefOverride(TowerBackgroundv2, 1);
+};
+
+#endif
@@ -16,7 +16,9 @@
 /// \brief PHObject to store rho and sigma for calorimeter towers on an event-by-event basis
 ///
 /// This class is a PHObject to store rho and sigma for calorimeter towers on an event-by-event basis
-/// Options for rho calculation are AREA and MULT or NONE
+/// Options for rho calculation are AREA and MULT or NONE, or GRID for the
+/// median over rectangular eta-phi patches of the tower grid (GRID_FLOW
+/// divides out the v2 modulation before taking the median)
 
 class TowerRho : public PHObject
 {
@@ -27,7 +29,9 @@ class TowerRho : public PHObject
     {
       NONE = 0,
       AREA = 1,
-      MULT = 2
+      MULT = 2,
+      GRID = 3,
+      GRID_FLOW = 4
     };
 
     ~TowerRho() override{};
@@ -41,9 +41,15 @@ std::string TowerRhov1::get_method_string(TowerRho::Method method)
   case TowerRho::Method::MULT:
     return "MULT";
     break;
+  case TowerRho::Method::GRID:
+    return "GRID";
+    break;
+  case TowerRho::Method::GRID_FLOW:
+    return "GRID_FLOW";
+    break;
   default:
     std::cout << "ERROR: rho method not recognized" << std::endl;
-    std::cout << "rho method must be 1 (area) or 2 (mult)" << std::endl;
+    std::cout << "rho method must be 1 (area), 2 (mult), 3 (grid) or 4 (grid_flow)" << std::endl;
     exit(-1);
   }
   return "NONE";
@@ -6,13 +6,17 @@
 
 #include <phool/phool.h>
 
+#include <ROOT/TSeq.hxx>
+#include <ROOT/TThreadExecutor.hxx>
 #include <TClonesArray.h>
+#include <TROOT.h>
 #include <TSystem.h>
 
 // fastjet includes
 #include <fastjet/AreaDefinition.hh>
 #include <fastjet/ClusterSequence.hh>
 #include <fastjet/ClusterSequenceArea.hh>
+#include <fastjet/config.h>  // for FASTJET_HAVE_THREAD_SAFETY, FASTJET_HAVE_LIMITED_THREAD_SAFETY
 #include <fastjet/FunctionOfPseudoJet.hh>  // for FunctionOfPse...
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
@@ -27,6 +31,7 @@
 #include <boost/format.hpp>
 
 // standard includes
+#include <algorithm>
 #include <cassert>
 #include <cmath>  // for isfinite
 #include <fstream>
@@ -54,6 +59,11 @@ FastJetAlgo::FastJetAlgo(const FastJetOptions& options)
   }
 }
 
+FastJetAlgo::~FastJetAlgo()
+{
+  delete m_executor;
+}
+
 void FastJetAlgo::identify(std::ostream& os)
 {
   os << "   FastJetAlgo: ";
@@ -203,6 +213,55 @@ FastJetAlgo::jets_to_pseudojets(std::vector<Jet*>& particles)
   return pseudojets;
 }
 
+std::vector<fastjet::PseudoJet>
+FastJetAlgo::particles_to_pseudojets(std::vector<JetInputParticle>& particles)
+{
+  std::vector<fastjet::PseudoJet> pseudojets;
+  pseudojets.reserve(particles.size());
+  for (unsigned int ipart = 0; ipart < particles.size(); ++ipart)
+  {
+    const JetInputParticle& particle = particles[ipart];
+    // same zero-energy catch as in jets_to_pseudojets
+    if (particle.e == 0.)
+    {
+      continue;
+    }
+    if (!std::isfinite(particle.px) ||
+        !std::isfinite(particle.py) ||
+        !std::isfinite(particle.pz) ||
+        !std::isfinite(particle.e))
+    {
+      std::cout << PHWHERE << " invalid particle kinematics:"
+                << " px: " << particle.px
+                << " py: " << particle.py
+                << " pz: " << particle.pz
+                << " e: " << particle.e << std::endl;
+      gSystem->Exit(1);
+    }
+    fastjet::PseudoJet pseudojet(particle.px, particle.py, particle.pz, particle.e);
+    if (m_opt.use_constituent_min_pt && pseudojet.perp() < m_opt.constituent_min_pt)
+    {
+      continue;
+    }
+    pseudojet.set_user_index(ipart);
+    pseudojets.push_back(pseudojet);
+  }
+  return pseudojets;
+}
+
+void FastJetAlgo::insert_component(Jet* jet, int user_index)
+{
+  if (m_input_particles)
+  {
+    const JetInputParticle& particle = (*m_input_particles)[user_index];
+    jet->insert_comp(particle.src, particle.index, true);
+  }
+  else
+  {
+    jet->insert_comp((*m_input_jets)[user_index]->get_comp_vec(), true);
+  }
+}
+
 void FastJetAlgo::first_call_init(JetContainer* jetcont)
 {
   m_first_cluster_call = false;
@@ -221,6 +280,43 @@ void FastJetAlgo::first_call_init(JetContainer* jetcont)
     m_mu_index = jetcont->property_index(Jet::PROPERTY::prop_mu);
   }
 
+  if (m_opt.doSoftDrop)
+  {
+    m_substructure_index.push_back(m_zg_index);
+    m_substructure_index.push_back(m_Rg_index);
+    m_substructure_index.push_back(m_mu_index);
+  }
+  if (m_opt.doNsubjettiness)
+  {
+    jetcont->add_property({Jet::PROPERTY::prop_tau1, Jet::PROPERTY::prop_tau2, Jet::PROPERTY::prop_tau3});
+    m_substructure_index.push_back(jetcont->property_index(Jet::PROPERTY::prop_tau1));
+    m_substructure_index.push_back(jetcont->property_index(Jet::PROPERTY::prop_tau2));
+    m_substructure_index.push_back(jetcont->property_index(Jet::PROPERTY::prop_tau3));
+  }
+  if (m_opt.doAngularity)
+  {
+    jetcont->add_property(Jet::PROPERTY::prop_angularity);
+    m_substructure_index.push_back(jetcont->property_index(Jet::PROPERTY::prop_angularity));
+  }
+  if (m_opt.doLund)
+  {
+    jetcont->add_property({Jet::PROPERTY::prop_LundN, Jet::PROPERTY::prop_LundLnKt, Jet::PROPERTY::prop_LundLnInvDR});
+    m_substructure_index.push_back(jetcont->property_index(Jet::PROPERTY::prop_LundN));
+    m_substructure_index.push_back(jetcont->property_index(Jet::PROPERTY::prop_LundLnKt));
+    m_substructure_index.push_back(jetcont->property_index(Jet::PROPERTY::prop_LundLnInvDR));
+  }
+  if (m_opt.do_substructure && m_opt.substructure_nthreads > 1)
+  {
+#ifdef FASTJET_HAVE_THREAD_SAFETY
+    ROOT::EnableThreadSafety();
+    m_executor = new ROOT::TThreadExecutor(m_opt.substructure_nthreads);
+#else
+    // the threads share the PseudoJets of one cluster sequence, whose
+    // reference counts are only atomic in a thread safe fastjet build
+    std::cout << "FastJetAlgo: fastjet built without --enable-thread-safety, substructure runs on 1 thread" << std::endl;
+#endif
+  }
+
   if (m_opt.calc_area)
   {
     jetcont->add_property(Jet::PROPERTY::prop_area);
@@ -273,6 +369,37 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
   // translate input jets to input fastjets
   auto pseudojets = jets_to_pseudojets(particles);
 
+  m_input_jets = &particles;
+  fill_jet_container(pseudojets, jetcont);
+  m_input_jets = nullptr;
+}
+
+void FastJetAlgo::cluster_and_fill_particles(std::vector<JetInputParticle>& particles, JetContainer* jetcont)
+{
+  if (m_first_cluster_call)
+  {
+    first_call_init(jetcont);
+  }
+
+  if (m_opt.verbosity > 1)
+  {
+    std::cout << "   Verbosity>1 FastJetAlgo::process_event -- entered" << std::endl;
+  }
+  if (m_opt.verbosity > 8)
+  {
+    std::cout << "   Verbosity>8 #input particles: " << particles.size() << std::endl;
+  }
+
+  // translate input records directly to input fastjets
+  auto pseudojets = particles_to_pseudojets(particles);
+
+  m_input_particles = &particles;
+  fill_jet_container(pseudojets, jetcont);
+  m_input_particles = nullptr;
+}
+
+void FastJetAlgo::fill_jet_container(std::vector<fastjet::PseudoJet>& pseudojets, JetContainer* jetcont)
+{
   // if using constituent subtraction, oberve maximum eta and subtract the constituents
   if (m_opt.cs_calc_constsub)
   {
@@ -331,6 +458,7 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
   {
     std::cout << "   Verbosity>8 fastjets: " << fastjets.size() << std::endl;
   }
+  unsigned int first_jet = jetcont->size();
   for (unsigned int ijet = 0; ijet < fastjets.size(); ++ijet)
   {
     auto* jet = jetcont->add_jet();  // put a new Jetv2 into the TClonesArray
@@ -345,38 +473,6 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
       jet->set_property(m_area_index, fastjets[ijet].area());
     }
 
-    // if SoftDrop enabled, and jets have > 5 GeV (do not waste time
-    // on very low-pT jets), run SD and pack output into jet properties
-    if (m_opt.doSoftDrop && fastjets[ijet].perp() > 5)
-    {
-      fastjet::contrib::SoftDrop sd(m_opt.SD_beta, m_opt.SD_zcut);
-      if (m_opt.verbosity > 5)
-      {
-        std::cout << "FastJetAlgo::get_jets : created SoftDrop groomer configuration : "
-                  << sd.description() << std::endl;
-      }
-
-      fastjet::PseudoJet sd_jet = sd(fastjets[ijet]);
-
-      if (m_opt.verbosity > 5)
-      {
-        std::cout << "original    jet: pt / eta / phi / m = " << fastjets[ijet].perp()
-                  << " / " << fastjets[ijet].eta() << " / " << fastjets[ijet].phi() << " / "
-                  << fastjets[ijet].m() << std::endl;
-        std::cout << "SoftDropped jet: pt / eta / phi / m = " << sd_jet.perp() << " / "
-                  << sd_jet.eta() << " / " << sd_jet.phi() << " / " << sd_jet.m() << std::endl;
-
-        std::cout << "  delta_R between subjets: " << sd_jet.structure_of<fastjet::contrib::SoftDrop>().delta_R() << std::endl;
-        std::cout << "  symmetry measure(z):     " << sd_jet.structure_of<fastjet::contrib::SoftDrop>().symmetry() << std::endl;
-        std::cout << "  mass drop(mu):           " << sd_jet.structure_of<fastjet::contrib::SoftDrop>().mu() << std::endl;
-      }
-
-      // attach SoftDrop quantities as jet properties
-      jet->set_property(m_zg_index, sd_jet.structure_of<fastjet::contrib::SoftDrop>().symmetry());
-      jet->set_property(m_Rg_index, sd_jet.structure_of<fastjet::contrib::SoftDrop>().delta_R());
-      jet->set_property(m_mu_index, sd_jet.structure_of<fastjet::contrib::SoftDrop>().mu());
-    }
-
     // Count clustered components. If desired, put original components into the output jet.
     int n_clustered = 0;
     std::vector<fastjet::PseudoJet> constituents = fastjets[ijet].constituents();
@@ -391,7 +487,7 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
         ++n_clustered;
         if (m_opt.save_jet_components)
         {
-          jet->insert_comp(particles[comp.user_index()]->get_comp_vec(), true);
+          insert_component(jet, comp.user_index());
         }
       }  // end loop over all constituents
     }
@@ -402,12 +498,19 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
       {
         for (auto& comp : constituents)
         {
-          jet->insert_comp(particles[comp.user_index()]->get_comp_vec(), true);
+          insert_component(jet, comp.user_index());
         }
       }
     }
     jet->set_comp_sort_flag();  // make surce comp knows it might not be sorted
   }
+
+  // softdrop and substructure, needs the cluster sequence
+  if (m_opt.do_substructure)
+  {
+    calc_substructure(fastjets, jetcont, first_jet);
+  }
+
   if (m_opt.verbosity > 1)
   {
     std::cout << "FastJetAlgo::process_event -- exited" << std::endl;
@@ -415,6 +518,191 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
   delete (m_opt.calc_area ? m_cluseqarea : m_cluseq);  // if (m_cluseq) delete m_cluseq;
 }
 
+bool FastJetAlgo::is_thread_safe() const
+{
+#ifdef FASTJET_HAVE_LIMITED_THREAD_SAFETY
+  return true;
+#else
+  // ghosts come from the static random generator of GhostedAreaSpec, and
+  // constituent subtraction and the substructure tools count warnings in
+  // static LimitedWarnings, none of which is thread safe in a default build.
+  // Called before the first event, so the options are not initialized yet
+  bool substructure = m_opt.doSoftDrop || m_opt.doNsubjettiness || m_opt.doAngularity || m_opt.doLund;
+  return !(m_opt.calc_area || m_opt.calc_jetmedbkgdens || m_opt.cs_calc_constsub || substructure);
+#endif
+}
+
+void FastJetAlgo::calc_substructure(std::vector<fastjet::PseudoJet>& fastjets, JetContainer* jetcont, unsigned int first_jet)
+{
+  unsigned int nvalues = m_substructure_index.size();
+  m_substructure.assign(fastjets.size() * nvalues, NAN);
+
+  // do not waste time on very low-pT jets
+  m_substructure_jets.clear();
+  for (unsigned int ijet = 0; ijet < fastjets.size(); ++ijet)
+  {
+    if (fastjets[ijet].perp() > m_opt.SD_jet_min_pt)
+    {
+      m_substructure_jets.push_back(ijet);
+    }
+  }
+
+  // each chunk of jets gets its own groomer
+  unsigned int nchunks = 1;
+  if (m_executor)
+  {
+    nchunks = std::min<unsigned int>(m_opt.substructure_nthreads, m_substructure_jets.size());
+  }
+  auto calc_chunk = [&](unsigned int ichunk)
+  {
+    std::unique_ptr<fastjet::contrib::SoftDrop> sd;
+    if (m_opt.doSoftDrop)
+    {
+      sd = std::make_unique<fastjet::contrib::SoftDrop>(m_opt.SD_beta, m_opt.SD_zcut);
+    }
+    for (unsigned int i = ichunk; i < m_substructure_jets.size(); i += nchunks)
+    {
+      unsigned int ijet = m_substructure_jets[i];
+      calc_jet_substructure(fastjets[ijet], sd.get(), &m_substructure[ijet * nvalues]);
+    }
+  };
+  if (nchunks > 1)
+  {
+    m_executor->Foreach(calc_chunk, ROOT::TSeqU(nchunks));
+  }
+  else if (!m_substructure_jets.empty())
+  {
+    calc_chunk(0);
+  }
+
+  // the jets are only touched serially
+  for (auto ijet : m_substructure_jets)
+  {
+    Jet* jet = jetcont->get_jet(first_jet + ijet);
+    for (unsigned int ivalue = 0; ivalue < nvalues; ++ivalue)
+    {
+      jet->set_property(m_substructure_index[ivalue], m_substructure[ijet * nvalues + ivalue]);
+    }
+    if (m_opt.verbosity > 5)
+    {
+      std::cout << "FastJetAlgo::calc_substructure : jet pt / eta / phi = " << fastjets[ijet].perp()
+                << " / " << fastjets[ijet].eta() << " / " << fastjets[ijet].phi() << ", substructure:";
+      for (unsigned int ivalue = 0; ivalue < nvalues; ++ivalue)
+      {
+        std::cout << " " << m_substructure[ijet * nvalues + ivalue];
+      }
+      std::cout << std::endl;
+    }
+  }
+}
+
+void FastJetAlgo::calc_jet_substructure(const fastjet::PseudoJet& jet, const fastjet::contrib::SoftDrop* sd, float* values) const
+{
+  if (sd)
+  {
+    fastjet::PseudoJet sd_jet = (*sd)(jet);
+    *values++ = sd_jet.structure_of<fastjet::contrib::SoftDrop>().symmetry();
+    *values++ = sd_jet.structure_of<fastjet::contrib::SoftDrop>().delta_R();
+    *values++ = sd_jet.structure_of<fastjet::contrib::SoftDrop>().mu();
+  }
+  if (!(m_opt.doNsubjettiness || m_opt.doAngularity || m_opt.doLund))
+  {
+    return;
+  }
+
+  // the remaining observables use the real constituents only
+  std::vector<fastjet::PseudoJet> constituents;
+  for (auto& comp : jet.constituents())
+  {
+    if (!comp.is_pure_ghost())
+    {
+      constituents.push_back(comp);
+    }
+  }
+  double jet_pt = jet.perp();
+  double R0 = m_opt.jet_R;
+
+  if (m_opt.doNsubjettiness)
+  {
+    // normalized N-subjettiness (beta = 1) with exclusive kt axes
+    double norm = 0;
+    for (auto& comp : constituents)
+    {
+      norm += comp.perp() * R0;
+    }
+    fastjet::ClusterSequence kt_cs(constituents, fastjet::JetDefinition(fastjet::kt_algorithm, fastjet::JetDefinition::max_allowable_R));
+    for (unsigned int naxes = 1; naxes <= 3; ++naxes)
+    {
+      if (constituents.size() <= naxes || norm <= 0)
+      {
+        *values++ = 0;
+        continue;
+      }
+      std::vector<fastjet::PseudoJet> axes = kt_cs.exclusive_jets(static_cast<int>(naxes));
+      double tau = 0;
+      for (auto& comp : constituents)
+      {
+        double min_dR = comp.delta_R(axes[0]);
+        for (unsigned int iaxis = 1; iaxis < axes.size(); ++iaxis)
+        {
+          min_dR = std::min(min_dR, comp.delta_R(axes[iaxis]));
+        }
+        tau += comp.perp() * min_dR;
+      }
+      *values++ = tau / norm;
+    }
+  }
+
+  if (m_opt.doAngularity)
+  {
+    // lambda^kappa_beta = sum z_i^kappa (Delta R_i / R)^beta
+    double lambda = 0;
+    for (auto& comp : constituents)
+    {
+      lambda += std::pow(comp.perp() / jet_pt, m_opt.angularity_kappa) * std::pow(comp.delta_R(jet) / R0, m_opt.angularity_beta);
+    }
+    *values++ = lambda;
+  }
+
+  if (m_opt.doLund)
+  {
+    // primary declusterings: recluster with C/A and follow the harder branch
+    int nsplit = 0;
+    double max_kt = 0;
+    double max_kt_dR = 0;
+    if (!constituents.empty())
+    {
+      fastjet::ClusterSequence ca_cs(constituents, fastjet::JetDefinition(fastjet::cambridge_algorithm, fastjet::JetDefinition::max_allowable_R));
+      std::vector<fastjet::PseudoJet> ca_jets = ca_cs.exclusive_jets(1);
+      fastjet::PseudoJet branch = ca_jets[0];
+      fastjet::PseudoJet harder;
+      fastjet::PseudoJet softer;
+      while (branch.has_parents(harder, softer))
+      {
+        if (harder.pt2() < softer.pt2())
+        {
+          std::swap(harder, softer);
+        }
+        double dR = harder.delta_R(softer);
+        double kt = softer.pt() * dR;
+        if (kt > m_opt.lund_kt_min)
+        {
+          ++nsplit;
+          if (kt > max_kt)
+          {
+            max_kt = kt;
+            max_kt_dR = dR;
+          }
+        }
+        branch = harder;
+      }
+    }
+    *values++ = nsplit;
+    *values++ = (nsplit > 0 ? std::log(max_kt) : NAN);
+    *values++ = (nsplit > 0 ? std::log(1. / max_kt_dR) : NAN);
+  }
+}
+
 std::vector<Jet*> FastJetAlgo::get_jets(std::vector<Jet*> particles)
 {
   // translate to fastjet
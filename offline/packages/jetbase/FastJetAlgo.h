@@ -21,16 +21,22 @@ namespace fastjet
   namespace contrib
   {
     class ConstituentSubtractor;
+    class SoftDrop;
   }
 }  // namespace fastjet
 
+namespace ROOT
+{
+  class TThreadExecutor;
+}
+
 class JetContainer;
 
 class FastJetAlgo : public JetAlgo
 {
  public:
   FastJetAlgo(const FastJetOptions& options);
-  ~FastJetAlgo() override {}
+  ~FastJetAlgo() override;
 
   void identify(std::ostream& os = std::cout) override;
   Jet::ALGO get_algo() override { return m_opt.algo; }
@@ -50,6 +56,8 @@ class FastJetAlgo : public JetAlgo
 
   std::vector<Jet*> get_jets(std::vector<Jet*> particles) override;
   void cluster_and_fill(std::vector<Jet*>& part_in, JetContainer* jets_out) override;
+  void cluster_and_fill_particles(std::vector<JetInputParticle>& part_in, JetContainer* jets_out) override;
+  bool is_thread_safe() const override;
 
  private:
   FastJetOptions m_opt{};
@@ -61,8 +69,21 @@ class FastJetAlgo : public JetAlgo
   Jet::PROPERTY m_mu_index{Jet::PROPERTY::no_property};
   Jet::PROPERTY m_area_index{Jet::PROPERTY::no_property};
 
+  // substructure values per jet, in the order softdrop (zg, Rg, mu), tau1..3,
+  // angularity, Lund (N, ln kt, ln 1/DR) for the enabled ones, and their
+  // property indices in the JetContainer
+  std::vector<Jet::PROPERTY> m_substructure_index;
+  std::vector<float> m_substructure;  // njets x nvalues, reused
+  std::vector<unsigned int> m_substructure_jets;
+  ROOT::TThreadExecutor* m_executor{nullptr};
+
   // Internal processes
   std::vector<fastjet::PseudoJet> jets_to_pseudojets(std::vector<Jet*>& particles);
+  std::vector<fastjet::PseudoJet> particles_to_pseudojets(std::vector<JetInputParticle>& particles);
+  void fill_jet_container(std::vector<fastjet::PseudoJet>& pseudojets, JetContainer* jetcont);
+  void insert_component(Jet* jet, int user_index);
+  void calc_substructure(std::vector<fastjet::PseudoJet>& fastjets, JetContainer* jetcont, unsigned int first_jet);
+  void calc_jet_substructure(const fastjet::PseudoJet& jet, const fastjet::contrib::SoftDrop* sd, float* values) const;
   std::vector<fastjet::PseudoJet> cluster_jets(std::vector<fastjet::PseudoJet>& constituents);
   std::vector<fastjet::PseudoJet> cluster_area_jets(std::vector<fastjet::PseudoJet>& constituents);
   float calc_rhomeddens(std::vector<fastjet::PseudoJet>& constituents);
@@ -75,6 +96,10 @@ class FastJetAlgo : public JetAlgo
   fastjet::GridMedianBackgroundEstimator* cs_bge_rho = nullptr;
   fastjet::Selector* cs_sel_max_pt = nullptr;
 
+  // input of the current cluster_and_fill call, one of the two is set
+  std::vector<Jet*>* m_input_jets{nullptr};
+  std::vector<JetInputParticle>* m_input_particles{nullptr};
+
   fastjet::ClusterSequence* m_cluseq{nullptr};
   fastjet::ClusterSequence* m_cluseqarea{nullptr};
 };
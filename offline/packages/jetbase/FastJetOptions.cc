@@ -61,6 +61,34 @@ FastJetOptions& FastJetOptions::update(std::vector<FastJetOptItem> input)
       {
         SD_jet_min_pt = next_val(i, input);
       }
+      else if (item.opt == DO_NSUBJETTINESS)
+      {
+        doNsubjettiness = true;
+      }
+      else if (item.opt == DO_ANGULARITY)
+      {
+        doAngularity = true;
+      }
+      else if (item.opt == ANGULARITY_KAPPA)
+      {
+        angularity_kappa = next_val(i, input);
+      }
+      else if (item.opt == ANGULARITY_BETA)
+      {
+        angularity_beta = next_val(i, input);
+      }
+      else if (item.opt == DO_LUND)
+      {
+        doLund = true;
+      }
+      else if (item.opt == LUND_KT_MIN)
+      {
+        lund_kt_min = next_val(i, input);
+      }
+      else if (item.opt == SUBSTRUCTURE_NTHREADS)
+      {
+        substructure_nthreads = static_cast<int>(next_val(i, input));
+      }
       else if (item.opt == CALC_AREA)
       {
         calc_area = true;
@@ -172,6 +200,24 @@ void FastJetOptions::print(std::ostream& os)
     os << " - do softdrop with Beta(" << SD_beta << ") and Zcut(" << SD_zcut
        << ") for jets w/pT>" << SD_jet_min_pt << std::endl;
   }
+  if (doNsubjettiness)
+  {
+    os << " - calculate N-subjettiness tau1, tau2, tau3 for jets w/pT>" << SD_jet_min_pt << std::endl;
+  }
+  if (doAngularity)
+  {
+    os << " - calculate angularity with Kappa(" << angularity_kappa << ") and Beta(" << angularity_beta
+       << ") for jets w/pT>" << SD_jet_min_pt << std::endl;
+  }
+  if (doLund)
+  {
+    os << " - calculate primary Lund declusterings with kt>" << lund_kt_min
+       << " for jets w/pT>" << SD_jet_min_pt << std::endl;
+  }
+  if (do_substructure && substructure_nthreads > 1)
+  {
+    os << " - substructure on " << substructure_nthreads << " threads" << std::endl;
+  }
   if (calc_area)
   {
     os << " - calculate jet areas (using KT jets) with ghost_area("
@@ -225,4 +271,5 @@ void FastJetOptions::initialize()
   }
 
   use_jet_selection = (use_jet_max_eta || use_jet_min_pt);
+  do_substructure = (doSoftDrop || doNsubjettiness || doAngularity || doLund);
 }
@@ -69,6 +69,21 @@ enum FastJetOptEnum
   ,
   DONT_SAVE_JET_COMPONENTS  // set save_jet_components to false
 
+  ,
+  DO_NSUBJETTINESS  // optional; off, tau1..3 with kt axes
+  ,
+  DO_ANGULARITY  // optional; off
+  ,
+  ANGULARITY_KAPPA  // defaults to 1
+  ,
+  ANGULARITY_BETA  // defaults to 1
+  ,
+  DO_LUND  // optional; off, primary Lund declusterings
+  ,
+  LUND_KT_MIN  // defaults to 1.
+  ,
+  SUBSTRUCTURE_NTHREADS  // defaults to 1; threads for softdrop and the substructure properties, needs fastjet built with --enable-thread-safety
+
   ,
   VERBOSITY  // optional
 };
@@ -125,7 +140,16 @@ struct FastJetOptions
   bool doSoftDrop = false;
   float SD_beta = 0;
   float SD_zcut = 0;
-  float SD_jet_min_pt = 5.;
+  float SD_jet_min_pt = 5.;  // also the minimum jet pt for the substructure below
+
+  // substructure
+  bool doNsubjettiness = false;
+  bool doAngularity = false;
+  float angularity_kappa = 1.;
+  float angularity_beta = 1.;
+  bool doLund = false;
+  float lund_kt_min = 1.;
+  int substructure_nthreads = 1;
 
   // calculate area
   bool calc_area = false;
@@ -150,6 +174,7 @@ struct FastJetOptions
 
   // for convenience when running FastJetAlgo
   bool use_jet_selection = false;  // set when initialized
+  bool do_substructure = false;    // set when initialized
   void initialize();               // updates run with the first call
 };
 
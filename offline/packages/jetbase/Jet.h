@@ -143,6 +143,20 @@ class Jet : public PHObject
     //! jet area
     prop_area = 11,
     no_property = 12,
+
+    //! N-subjettiness (kt axes, normalized, beta = 1)
+    prop_tau1 = 13,
+    prop_tau2 = 14,
+    prop_tau3 = 15,
+
+    //! generalized angularity lambda^kappa_beta
+    prop_angularity = 16,
+
+    //! Lund plane primary declusterings: number above the kt cut,
+    //! ln(kt) and ln(1/Delta R) of the hardest kt splitting
+    prop_LundN = 17,
+    prop_LundLnKt = 18,
+    prop_LundLnInvDR = 19,
   };
 
   Jet() {}
@@ -1,7 +1,31 @@
 #include "JetAlgo.h"
 
+#include "Jetv2.h"
+
 using PropMap = std::map<Jet::PROPERTY, unsigned int>;
 
 PropMap DummyPropMap;
 
 PropMap& JetAlgo::property_indices() { return DummyPropMap; }
+
+void JetAlgo::cluster_and_fill_particles(std::vector<JetInputParticle>& particles, JetContainer* jets)
+{
+  std::vector<Jet*> inputs;
+  inputs.reserve(particles.size());
+  for (auto& particle : particles)
+  {
+    Jet* jet = new Jetv2();
+    jet->set_px(particle.px);
+    jet->set_py(particle.py);
+    jet->set_pz(particle.pz);
+    jet->set_e(particle.e);
+    jet->insert_comp(particle.src, particle.index);
+    jet->set_id(inputs.size());
+    inputs.push_back(jet);
+  }
+  cluster_and_fill(inputs, jets);
+  for (auto& input : inputs)
+  {
+    delete input;
+  }
+}
@@ -2,8 +2,10 @@
 #define JETBASE_JETALGO_H
 
 #include "Jet.h"
+#include "JetInput.h"
 
 #include <cmath>
+#include <vector>
 
 class JetContainer;
 class JetAlgo
@@ -30,8 +32,16 @@ class JetAlgo
   {
   }
 
+  // same, from flat input records (see JetInput::get_input_particles);
+  // the default converts to temporary Jets and calls cluster_and_fill
+  virtual void cluster_and_fill_particles(std::vector<JetInputParticle>& particles, JetContainer* jets);
+
   virtual std::map<Jet::PROPERTY, unsigned int>& property_indices();
 
+  // whether cluster_and_fill can run concurrently with other algorithms
+  // (each filling its own container)
+  virtual bool is_thread_safe() const { return true; }
+
  protected:
   JetAlgo() {}
 
@@ -0,0 +1,260 @@
+#include "JetColumnView.h"
+
+#include "JetContainerv2.h"
+#include "Jetv2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void JetColumnView::identify(std::ostream& os) const
+{
+  os << "---Jet column view--------------" << std::endl;
+  os << "jet index: " << m_index << " jetid: " << get_id() << std::endl;
+  os << " (px,py,pz,e) =  (" << get_px() << ", " << get_py() << ", ";
+  os << get_pz() << ", " << get_e() << ") GeV" << std::endl;
+
+  os << " Jet Properties:";
+  for (size_t i = 0; i < size_properties(); ++i)
+  {
+    os << " " << get_property(static_cast<Jet::PROPERTY>(i));
+  }
+  os << std::endl;
+
+  os << " Jet Components: " << size_comp() << std::endl;
+  return;
+}
+
+int JetColumnView::isValid() const
+{
+  if (!m_container || m_index >= m_container->size())
+  {
+    return 0;
+  }
+  if (get_id() == 0xFFFFFFFF)
+  {
+    return 0;
+  }
+  if (std::isnan(get_px()) || std::isnan(get_py()) || std::isnan(get_pz()) || std::isnan(get_e()))
+  {
+    return 0;
+  }
+  if (size_comp() == 0)
+  {
+    return 0;
+  }
+  return 1;
+}
+
+PHObject* JetColumnView::CloneMe() const
+{
+  Jetv2* jet = new Jetv2(size_properties());
+  jet->set_id(get_id());
+  jet->set_px(get_px());
+  jet->set_py(get_py());
+  jet->set_pz(get_pz());
+  jet->set_e(get_e());
+  for (size_t i = 0; i < size_properties(); ++i)
+  {
+    jet->set_property(static_cast<Jet::PROPERTY>(i), get_property(static_cast<Jet::PROPERTY>(i)));
+  }
+  for (auto iter = m_container->comp_begin(m_index); iter != m_container->comp_end(m_index); ++iter)
+  {
+    jet->insert_comp(iter->first, iter->second);
+  }
+  return jet;
+}
+
+unsigned int JetColumnView::get_id() const { return m_container->get_jet_id(m_index); }
+void JetColumnView::set_id(unsigned int id) { m_container->set_jet_id(m_index, id); }
+
+float JetColumnView::get_px() const { return m_container->get_jet_px(m_index); }
+void JetColumnView::set_px(float px) { m_container->set_jet_px(m_index, px); }
+
+float JetColumnView::get_py() const { return m_container->get_jet_py(m_index); }
+void JetColumnView::set_py(float py) { m_container->set_jet_py(m_index, py); }
+
+float JetColumnView::get_pz() const { return m_container->get_jet_pz(m_index); }
+void JetColumnView::set_pz(float pz) { m_container->set_jet_pz(m_index, pz); }
+
+float JetColumnView::get_e() const { return m_container->get_jet_e(m_index); }
+void JetColumnView::set_e(float e) { m_container->set_jet_e(m_index, e); }
+
+float JetColumnView::get_p() const
+{
+  return std::sqrt(get_px() * get_px() + get_py() * get_py() + get_pz() * get_pz());
+}
+
+float JetColumnView::get_pt() const
+{
+  return m_container->get_jet_pt(m_index);
+}
+
+float JetColumnView::get_et() const
+{
+  return get_pt() / get_p() * get_e();
+}
+
+float JetColumnView::get_eta() const
+{
+  return m_container->get_jet_eta(m_index);
+}
+
+float JetColumnView::get_phi() const
+{
+  return m_container->get_jet_phi(m_index);
+}
+
+float JetColumnView::get_mass() const
+{
+  // follow CLHEP convention and return negative mass if E^2 - p^2 < 0
+  float mass2 = get_mass2();
+  if (mass2 < 0)
+  {
+    return -1 * std::sqrt(std::fabs(mass2));
+  }
+  return std::sqrt(mass2);
+}
+
+float JetColumnView::get_mass2() const
+{
+  float p2 = get_px() * get_px() + get_py() * get_py() + get_pz() * get_pz();
+  return get_e() * get_e() - p2;
+}
+
+std::vector<float>& JetColumnView::get_property_vec()
+{
+  m_prop_copy.resize(size_properties());
+  for (size_t i = 0; i < m_prop_copy.size(); ++i)
+  {
+    m_prop_copy[i] = get_property(static_cast<Jet::PROPERTY>(i));
+  }
+  return m_prop_copy;
+}
+
+size_t JetColumnView::size_properties() const
+{
+  return m_container->size_properties();
+}
+
+float JetColumnView::get_property(Jet::PROPERTY index) const
+{
+  return m_container->get_jet_property(m_index, index);
+}
+
+void JetColumnView::set_property(Jet::PROPERTY index, float value)
+{
+  m_container->set_jet_property(m_index, index, value);
+}
+
+size_t JetColumnView::size_comp() const
+{
+  return m_container->get_jet_ncomp(m_index);
+}
+
+void JetColumnView::clear_comp()
+{
+  m_container->clear_comp(m_index);
+}
+
+void JetColumnView::insert_comp(SRC iSRC, unsigned int compid)
+{
+  m_container->insert_comp(m_index, iSRC, compid);
+}
+
+void JetColumnView::insert_comp(SRC iSRC, unsigned int compid, bool /*skip_flag*/)
+{
+  m_container->insert_comp(m_index, iSRC, compid);
+}
+
+void JetColumnView::insert_comp(Jet::TYPE_comp_vec& added)
+{
+  m_container->insert_comp(m_index, added.begin(), added.end());
+}
+
+void JetColumnView::insert_comp(Jet::TYPE_comp_vec& added, bool /*skip_nosort_flag_set*/)
+{
+  m_container->insert_comp(m_index, added.begin(), added.end());
+}
+
+void JetColumnView::print_comp(std::ostream& os, bool single_line)
+{
+  for (auto iter = comp_begin(); iter != comp_end(); ++iter)
+  {
+    os << " (" << iter->first << "->" << static_cast<int>(iter->second) << ")";
+    if (!single_line)
+    {
+      os << std::endl;
+    }
+  }
+  if (single_line)
+  {
+    os << std::endl;
+  }
+}
+
+size_t JetColumnView::num_comp(Jet::SRC iSRC)
+{
+  if (iSRC == Jet::SRC::VOID)
+  {
+    return (comp_end() - comp_begin());
+  }
+  return (comp_end(iSRC) - comp_begin(iSRC));
+}
+
+std::vector<Jet::SRC> JetColumnView::comp_src_vec()
+{
+  std::vector<Jet::SRC> vec{};
+  auto iter = comp_begin(Jet::SRC::VOID);  // sorts the components
+  auto iter_end = comp_end();
+  while (iter != iter_end)
+  {
+    Jet::SRC src = iter->first;
+    vec.push_back(src);
+    iter = comp_end(src);
+  }
+  return vec;
+}
+
+std::map<Jet::SRC, size_t> JetColumnView::comp_src_sizemap()
+{
+  std::map<Jet::SRC, size_t> sizemap{};
+  auto iter = comp_begin(Jet::SRC::VOID);  // sorts the components
+  auto iter_end = comp_end();
+  while (iter != iter_end)
+  {
+    Jet::SRC src = iter->first;
+    auto iter_ub = comp_end(src);
+    sizemap.insert(std::make_pair(src, static_cast<size_t>(iter_ub - iter)));
+    iter = iter_ub;
+  }
+  return sizemap;
+}
+
+Jet::ITER_comp_vec JetColumnView::comp_begin()
+{
+  return m_container->comp_begin(m_index);
+}
+
+Jet::ITER_comp_vec JetColumnView::comp_end()
+{
+  return m_container->comp_end(m_index);
+}
+
+Jet::ITER_comp_vec JetColumnView::comp_begin(Jet::SRC iSRC)
+{
+  m_container->sort_comp(m_index);
+  return std::lower_bound(comp_begin(), comp_end(), iSRC, Jetv2::CompareSRC());
+}
+
+Jet::ITER_comp_vec JetColumnView::comp_end(Jet::SRC iSRC)
+{
+  m_container->sort_comp(m_index);
+  return std::upper_bound(comp_begin(), comp_end(), iSRC, Jetv2::CompareSRC());
+}
+
+Jet::TYPE_comp_vec& JetColumnView::get_comp_vec()
+{
+  m_comp_copy.assign(comp_begin(), comp_end());
+  return m_comp_copy;
+}
@@ -0,0 +1,108 @@
+#ifndef JETBASE_JETCOLUMNVIEW_H
+#define JETBASE_JETCOLUMNVIEW_H
+
+#include "Jet.h"
+
+#include <cstddef>  // for size_t
+#include <iostream>
+#include <map>
+#include <vector>
+
+class JetContainerv2;
+class PHObject;
+
+/*!
+ * \brief Jet interface to one jet stored in the columns of a JetContainerv2
+ *
+ * Holds no jet data itself, only the container and the jet index; all
+ * getters and setters go to the container columns. The views are owned
+ * by the container and are not written out. get_comp_vec() and
+ * get_property_vec() return copies (modifying them does not change the
+ * jet); CloneMe() returns a standalone Jetv2.
+ */
+class JetColumnView : public Jet
+{
+ public:
+  JetColumnView() = default;
+  ~JetColumnView() override = default;
+
+  void set_view(JetContainerv2* container, unsigned int index)
+  {
+    m_container = container;
+    m_index = index;
+  }
+
+  // PHObject virtual overloads
+
+  void identify(std::ostream& os = std::cout) const override;
+  void Reset() override {}
+  int isValid() const override;
+  PHObject* CloneMe() const override;
+
+  // jet info
+
+  unsigned int get_id() const override;
+  void set_id(unsigned int id) override;
+
+  float get_px() const override;
+  void set_px(float px) override;
+
+  float get_py() const override;
+  void set_py(float py) override;
+
+  float get_pz() const override;
+  void set_pz(float pz) override;
+
+  float get_e() const override;
+  void set_e(float e) override;
+
+  float get_p() const override;
+  float get_pt() const override;
+  float get_et() const override;
+  float get_eta() const override;
+  float get_phi() const override;
+  float get_mass() const override;
+  float get_mass2() const override;
+
+  // Jet properties, the columns are added in the container
+  void resize_properties(size_t /*size*/) override {}
+  std::vector<float>& get_property_vec() override;
+  size_t size_properties() const override;
+
+  float get_property(Jet::PROPERTY index) const override;
+  void set_property(Jet::PROPERTY index, float value) override;
+
+  // Jet components
+  size_t size_comp() const override;
+  void clear_comp() override;
+  void insert_comp(SRC iSRC, unsigned int compid) override;
+  void insert_comp(Jet::SRC, unsigned int compid, bool) override;
+  void insert_comp(TYPE_comp_vec&) override;
+  void insert_comp(TYPE_comp_vec&, bool) override;
+  void set_comp_sort_flag(bool /*f*/ = false) override {}
+
+  void print_comp(std::ostream& os = std::cout, bool single_line = false) override;
+  size_t num_comp(SRC iSRC = Jet::SRC::VOID) override;
+  std::vector<Jet::SRC> comp_src_vec() override;
+  std::map<Jet::SRC, size_t> comp_src_sizemap() override;
+
+  ITER_comp_vec comp_begin() override;
+  ITER_comp_vec comp_begin(Jet::SRC) override;
+  ITER_comp_vec comp_end() override;
+  ITER_comp_vec comp_end(Jet::SRC) override;
+  TYPE_comp_vec& get_comp_vec() override;
+
+  inline void Clear(Option_t* = nullptr) override { Reset(); }
+
+ private:
+  JetContainerv2* m_container{nullptr};  //!
+  unsigned int m_index{0};               //!
+
+  // copies returned by get_comp_vec() and get_property_vec()
+  TYPE_comp_vec m_comp_copy;       //!
+  std::vector<float> m_prop_copy;  //!
+
+  ClassDefOverride(JetColumnView, 1);
+};
+
+#endif  // JETBASE_JETCOLUMNVIEW_H
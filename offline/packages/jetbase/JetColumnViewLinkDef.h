@@ -0,0 +1,5 @@
+#ifdef __CINT__
+
+#pragma link C++ class JetColumnView + ;
+
+#endif /* __CINT__ */
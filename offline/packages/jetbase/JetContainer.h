@@ -122,6 +122,21 @@ class JetContainer : public PHObject
   virtual unsigned int get_index_single() const { return UINT_MAX; };
   virtual std::vector<unsigned int> get_index_vec() const { return {}; };
 
+  // ---------------------------------------------------------------------------------------
+  //  Read jet quantities by jet index, without going through the Jet objects.
+  //  The property index is the one returned by property_index()
+  // ---------------------------------------------------------------------------------------
+  virtual unsigned int get_jet_id(unsigned int /*ijet*/) const { return UINT_MAX; }
+  virtual float get_jet_px(unsigned int /*ijet*/) const { return NAN; }
+  virtual float get_jet_py(unsigned int /*ijet*/) const { return NAN; }
+  virtual float get_jet_pz(unsigned int /*ijet*/) const { return NAN; }
+  virtual float get_jet_e(unsigned int /*ijet*/) const { return NAN; }
+  virtual float get_jet_pt(unsigned int /*ijet*/) const { return NAN; }
+  virtual float get_jet_eta(unsigned int /*ijet*/) const { return NAN; }
+  virtual float get_jet_phi(unsigned int /*ijet*/) const { return NAN; }
+  virtual float get_jet_property(unsigned int /*ijet*/, Jet::PROPERTY /*index*/) const { return NAN; }
+  virtual size_t get_jet_ncomp(unsigned int /*ijet*/) const { return 0; }
+
   virtual void set_rho_median(float /**/){};
   virtual float get_rho_median() const { return NAN; };
 
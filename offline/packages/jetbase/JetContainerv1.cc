@@ -201,6 +201,20 @@ std::string JetContainerv1::str_Jet_PROPERTY(Jet::PROPERTY prop) const
     return "JetHadronZT";
   case Jet::PROPERTY::prop_area:
     return "area";
+  case Jet::PROPERTY::prop_tau1:
+    return "tau1";
+  case Jet::PROPERTY::prop_tau2:
+    return "tau2";
+  case Jet::PROPERTY::prop_tau3:
+    return "tau3";
+  case Jet::PROPERTY::prop_angularity:
+    return "angularity";
+  case Jet::PROPERTY::prop_LundN:
+    return "LundN";
+  case Jet::PROPERTY::prop_LundLnKt:
+    return "LundLnKt";
+  case Jet::PROPERTY::prop_LundLnInvDR:
+    return "LundLnInvDR";
   default:
     return "no_property";
   }
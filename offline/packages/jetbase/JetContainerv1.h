@@ -61,6 +61,18 @@ class JetContainerv1 : public JetContainer
   Jet::IterJetTCA end() override;
   // ---------------------------------------------------------------------------------------
 
+  // -direct-access-by-index----------------------------------------------------------------
+  unsigned int get_jet_id(unsigned int ijet) const override { return jet_at(ijet)->get_id(); }
+  float get_jet_px(unsigned int ijet) const override { return jet_at(ijet)->get_px(); }
+  float get_jet_py(unsigned int ijet) const override { return jet_at(ijet)->get_py(); }
+  float get_jet_pz(unsigned int ijet) const override { return jet_at(ijet)->get_pz(); }
+  float get_jet_e(unsigned int ijet) const override { return jet_at(ijet)->get_e(); }
+  float get_jet_pt(unsigned int ijet) const override { return jet_at(ijet)->get_pt(); }
+  float get_jet_eta(unsigned int ijet) const override { return jet_at(ijet)->get_eta(); }
+  float get_jet_phi(unsigned int ijet) const override { return jet_at(ijet)->get_phi(); }
+  float get_jet_property(unsigned int ijet, Jet::PROPERTY index) const override { return jet_at(ijet)->get_property(index); }
+  size_t get_jet_ncomp(unsigned int ijet) const override { return jet_at(ijet)->size_comp(); }
+
   // -legacy-set-parameters-----------------------------------------------------------------
   void set_algo(Jet::ALGO algo) override { m_algo = algo; };
   Jet::ALGO get_algo() const override { return m_algo; };
@@ -91,6 +103,7 @@ class JetContainerv1 : public JetContainer
 
  private:
   std::string str_Jet_PROPERTY(Jet::PROPERTY) const;
+  const Jet* jet_at(unsigned int index) const { return (const Jet*) m_clones->UncheckedAt(index); }
 
   TClonesArray* m_clones{nullptr};  // TClonesArray of Jet objects
   size_t m_njets{0};                // size of jet_array
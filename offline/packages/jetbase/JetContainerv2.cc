@@ -0,0 +1,331 @@
+#include "JetContainerv2.h"
+
+#include "JetColumnView.h"
+#include "Jetv2.h"
+
+#include <phool/phool.h>  // for PHWHERE
+
+#include <TClonesArray.h>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+JetContainerv2::JetContainerv2()
+{
+  std::fill(std::begin(m_pslot), std::end(m_pslot), -1);
+  m_views = new TClonesArray("JetColumnView", 50);
+}
+
+JetContainerv2::JetContainerv2(const JetContainerv2& rhs)
+  : JetContainer(rhs)
+  , m_id{rhs.m_id}
+  , m_px{rhs.m_px}
+  , m_py{rhs.m_py}
+  , m_pz{rhs.m_pz}
+  , m_e{rhs.m_e}
+  , m_properties{rhs.m_properties}
+  , m_comp_offset{rhs.m_comp_offset}
+  , m_comp{rhs.m_comp}
+  , m_algo{rhs.m_algo}
+  , m_jetpar_R{rhs.m_jetpar_R}
+  , m_src{rhs.m_src}
+  , m_RhoMedian{rhs.m_RhoMedian}
+{
+  std::copy(std::begin(rhs.m_pslot), std::end(rhs.m_pslot), std::begin(m_pslot));
+  m_views = new TClonesArray("JetColumnView", 50);
+}
+
+JetContainerv2::~JetContainerv2()
+{
+  delete m_views;
+}
+
+void JetContainerv2::identify(std::ostream& os) const
+{
+  os << "JetContainerv2: size = " << size() << ", components = " << m_comp.size() << std::endl
+     << "  Contains jets with the following properties:" << std::endl;
+  print_property_types(os);
+  return;
+}
+
+void JetContainerv2::Reset()
+{
+  m_id.clear();
+  m_px.clear();
+  m_py.clear();
+  m_pz.clear();
+  m_e.clear();
+  for (auto& column : m_properties)
+  {
+    column.clear();
+  }
+  m_comp_offset.assign(1, 0);
+  m_comp.clear();
+  m_views->Clear("C");
+  m_RhoMedian = NAN;
+}
+
+TClonesArray* JetContainerv2::clone_data() const
+{
+  TClonesArray* clones = new TClonesArray("Jetv2", size());
+  for (unsigned int ijet = 0; ijet < size(); ++ijet)
+  {
+    auto jet = (Jet*) clones->ConstructedAt(ijet, "C");
+    jet->resize_properties(m_properties.size());
+    jet->set_id(m_id[ijet]);
+    jet->set_px(m_px[ijet]);
+    jet->set_py(m_py[ijet]);
+    jet->set_pz(m_pz[ijet]);
+    jet->set_e(m_e[ijet]);
+    for (size_t slot = 0; slot < m_properties.size(); ++slot)
+    {
+      jet->set_property(static_cast<Jet::PROPERTY>(slot), m_properties[slot][ijet]);
+    }
+    for (unsigned int icomp = m_comp_offset[ijet]; icomp < m_comp_offset[ijet + 1]; ++icomp)
+    {
+      jet->insert_comp(m_comp[icomp].first, m_comp[icomp].second);
+    }
+  }
+  return clones;
+}
+
+Jet* JetContainerv2::add_jet()
+{
+  m_id.push_back(0xFFFFFFFF);
+  m_px.push_back(NAN);
+  m_py.push_back(NAN);
+  m_pz.push_back(NAN);
+  m_e.push_back(NAN);
+  for (auto& column : m_properties)
+  {
+    column.push_back(NAN);
+  }
+  m_comp_offset.push_back(m_comp.size());
+  return get_view(size() - 1);
+}
+
+Jet* JetContainerv2::get_jet(unsigned int ijet)
+{
+  if (ijet < size())
+  {
+    return get_view(ijet);
+  }
+  else
+  {
+    return nullptr;
+  }
+}
+
+Jet* JetContainerv2::get_UncheckedAt(unsigned int index)
+{
+  return get_view(index);
+}
+
+Jet* JetContainerv2::get_view(unsigned int index)
+{
+  // the views are not stored, (re)attach them to the columns on demand
+  auto view = (JetColumnView*) m_views->ConstructedAt(index);
+  view->set_view(this, index);
+  return view;
+}
+
+void JetContainerv2::sync_views()
+{
+  if ((size_t) m_views->GetEntriesFast() > size())
+  {
+    m_views->Clear("C");
+  }
+  for (unsigned int ijet = 0; ijet < size(); ++ijet)
+  {
+    get_view(ijet);
+  }
+}
+
+// ----------------------------------------------------------------------------------------
+//  Jet components
+// ----------------------------------------------------------------------------------------
+
+void JetContainerv2::insert_comp(unsigned int ijet, Jet::TYPE_comp_vec::const_iterator first, Jet::TYPE_comp_vec::const_iterator last)
+{
+  unsigned int nadd = last - first;
+  // normally the components are added to the last jet, which is a plain append
+  m_comp.insert(m_comp.begin() + m_comp_offset[ijet + 1], first, last);
+  for (size_t i = ijet + 1; i < m_comp_offset.size(); ++i)
+  {
+    m_comp_offset[i] += nadd;
+  }
+}
+
+void JetContainerv2::insert_comp(unsigned int ijet, Jet::SRC src, unsigned int compid)
+{
+  m_comp.insert(m_comp.begin() + m_comp_offset[ijet + 1], std::make_pair(src, compid));
+  for (size_t i = ijet + 1; i < m_comp_offset.size(); ++i)
+  {
+    ++m_comp_offset[i];
+  }
+}
+
+void JetContainerv2::clear_comp(unsigned int ijet)
+{
+  unsigned int nremove = m_comp_offset[ijet + 1] - m_comp_offset[ijet];
+  m_comp.erase(comp_begin(ijet), comp_end(ijet));
+  for (size_t i = ijet + 1; i < m_comp_offset.size(); ++i)
+  {
+    m_comp_offset[i] -= nremove;
+  }
+}
+
+void JetContainerv2::sort_comp(unsigned int ijet)
+{
+  if (!std::is_sorted(comp_begin(ijet), comp_end(ijet), Jetv2::CompareSRC()))
+  {
+    std::sort(comp_begin(ijet), comp_end(ijet), Jetv2::CompareSRC());
+  }
+}
+
+// ----------------------------------------------------------------------------------------
+//  Interface for adding, setting, and getting jet properties
+// ----------------------------------------------------------------------------------------
+
+void JetContainerv2::print_jets(std::ostream& os)
+{
+  os << " No. of jets: " << size();
+  if (!std::isnan(m_RhoMedian))
+  {
+    os << " rho median " << m_RhoMedian;
+  }
+  os << std::endl;
+
+  std::map<Jet::PROPERTY, Jet::PROPERTY> pindex = property_indices();
+  for (unsigned int ijet = 0; ijet < size(); ++ijet)
+  {
+    os << (boost::format("  jet(%2i) : pT(%6.2f)  eta(%6.2f)  phi(%6.2f)") % ijet % get_jet_pt(ijet) % get_jet_eta(ijet) % get_jet_phi(ijet)).str();
+    for (auto prop : pindex)
+    {
+      os << (boost::format("  %8s(%6.2f)") % (str_Jet_PROPERTY(prop.first)) % (get_jet_property(ijet, prop.second))).str();
+    }
+    os << std::endl;
+  }
+  os << std::endl;
+}
+
+void JetContainerv2::print_property_types(std::ostream& os) const
+{
+  os << " Jet properties in Jet columns: " << std::endl;
+  for (auto p : property_indices())
+  {
+    os << " (" << p.second << ") -> " << str_Jet_PROPERTY(p.first) << std::endl;
+  }
+  return;
+}
+
+std::map<Jet::PROPERTY, Jet::PROPERTY> JetContainerv2::property_indices() const
+{
+  std::map<Jet::PROPERTY, Jet::PROPERTY> pindex;
+  for (int prop = 0; prop < NSLOTS; ++prop)
+  {
+    if (m_pslot[prop] >= 0)
+    {
+      pindex[static_cast<Jet::PROPERTY>(prop)] = static_cast<Jet::PROPERTY>(m_pslot[prop]);
+    }
+  }
+  return pindex;
+}
+
+// Add property columns to the jets.
+size_t JetContainerv2::add_property(Jet::PROPERTY prop)
+{
+  if (prop < 0 || prop >= NSLOTS)
+  {
+    std::cout << PHWHERE << " jet property " << prop << " out of range" << std::endl;
+    return m_properties.size();
+  }
+  if (m_pslot[prop] < 0)
+  {
+    m_pslot[prop] = m_properties.size();
+    m_properties.emplace_back(size(), NAN);
+  }
+  return m_properties.size();
+}
+
+size_t JetContainerv2::add_property(std::set<Jet::PROPERTY> props)
+{
+  for (auto prop : props)
+  {
+    add_property(prop);
+  }
+  return m_properties.size();
+}
+
+// get the index for a given property
+Jet::PROPERTY JetContainerv2::property_index(Jet::PROPERTY prop)
+{
+  if (!has_property(prop))
+  {
+    add_property(prop);
+  }
+  return static_cast<Jet::PROPERTY>(m_pslot[prop]);
+}
+
+Jet::IterJetTCA JetContainerv2::begin()
+{
+  sync_views();
+  return Jet::IterJetTCA(m_views);
+}
+
+Jet::IterJetTCA JetContainerv2::end()  // dummy implementation -- don't anticipate that it will ever be checked
+{
+  sync_views();
+  auto rval = Jet::IterJetTCA(m_views);
+  rval.index = rval.size;
+  return rval;
+}
+
+std::string JetContainerv2::str_Jet_PROPERTY(Jet::PROPERTY prop) const
+{
+  switch (prop)
+  {
+  case Jet::PROPERTY::prop_JetCharge:
+    return "JetCharge";
+  case Jet::PROPERTY::prop_BFrac:
+    return "BFrac";
+  case Jet::PROPERTY::prop_SeedD:
+    return "SeedD";
+  case Jet::PROPERTY::prop_SeedItr:
+    return "SeedItr";
+  case Jet::PROPERTY::prop_zg:
+    return "zg";
+  case Jet::PROPERTY::prop_Rg:
+    return "Rg";
+  case Jet::PROPERTY::prop_mu:
+    return "mu";
+  case Jet::PROPERTY::prop_gamma:
+    return "gamma";
+  case Jet::PROPERTY::prop_JetHadronFlavor:
+    return "JetHadronFlavor";
+  case Jet::PROPERTY::prop_JetHadronZT:
+    return "JetHadronZT";
+  case Jet::PROPERTY::prop_area:
+    return "area";
+  case Jet::PROPERTY::prop_tau1:
+    return "tau1";
+  case Jet::PROPERTY::prop_tau2:
+    return "tau2";
+  case Jet::PROPERTY::prop_tau3:
+    return "tau3";
+  case Jet::PROPERTY::prop_angularity:
+    return "angularity";
+  case Jet::PROPERTY::prop_LundN:
+    return "LundN";
+  case Jet::PROPERTY::prop_LundLnKt:
+    return "LundLnKt";
+  case Jet::PROPERTY::prop_LundLnInvDR:
+    return "LundLnInvDR";
+  default:
+    return "no_property";
+  }
+  return "";
+}
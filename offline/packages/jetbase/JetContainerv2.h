@@ -0,0 +1,171 @@
+#ifndef JETBASE_JetContainerv2__h
+#define JETBASE_JetContainerv2__h
+#include "JetContainer.h"
+
+#include "Jet.h"
+
+#include <cmath>
+#include <cstddef>  // for size_t
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>  // for pair
+#include <vector>
+
+class TClonesArray;
+
+// ---------------------------------------------------------------------------------------
+// JetContainerv2 -- columnar storage of the jets of one event
+// ---------------------------------------------------------------------------------------
+// Instead of one Jetv2 object (with its own property and component vectors) per jet,
+// the kinematics, each property and the constituent ids are kept in one contiguous
+// column for the whole event:
+//   - m_px, m_py, m_pz, m_e, m_id : one entry per jet
+//   - m_properties[slot]          : one column per property, one entry per jet
+//   - m_comp, m_comp_offset       : constituents of jet i are
+//                                   m_comp[m_comp_offset[i] .. m_comp_offset[i+1])
+// Properties are looked up through a fixed array of slots indexed by Jet::PROPERTY
+// instead of a std::map.
+//
+// The Jet* interface (add_jet, get_jet, range-for) is kept: it hands out JetColumnView
+// objects, which read and write the columns of their jet. The get_jet_*(ijet) accessors
+// read the columns directly and are the fast way to loop over many jets.
+// ---------------------------------------------------------------------------------------
+class JetContainerv2 : public JetContainer
+{
+ public:
+  // Manage class creation, copy, reset, destruction
+  JetContainerv2();
+  JetContainerv2(const JetContainerv2& rhs);
+  JetContainerv2& operator=(const JetContainerv2& rhs) = delete;
+  ~JetContainerv2() override;
+  void identify(std::ostream& os = std::cout) const override;
+  void Reset() override;
+  PHObject* CloneMe() const override { return new JetContainerv2(*this); }
+  TClonesArray* clone_data() const override;  // TClonesArray of Jetv2 copies
+
+  // status of jet contents
+  bool empty() const override { return m_px.empty(); };
+  size_t size() const override { return m_px.size(); };
+
+  // adding/access jets
+  Jet* add_jet() override;                            // Add a new jet to the columns and return a view of it
+  Jet* get_jet(unsigned int index) override;          // Get get at location.
+  Jet* get_UncheckedAt(unsigned int index) override;  // Get get at location.
+
+  // convenience shortcuts of get_{jet,UncheckedAt}
+  inline Jet* operator()(int index) override { return get_jet(index); };          // synonym for get_jet()
+  inline Jet* operator[](int index) override { return get_UncheckedAt(index); };  // get jet, don't check for length
+
+  // ----------------------------------------------------------------------------------------
+  //  Interface for adding properties to jets, and getting the index to those properties
+  // ----------------------------------------------------------------------------------------
+  std::map<Jet::PROPERTY, Jet::PROPERTY> property_indices() const override;
+  bool has_property(Jet::PROPERTY prop) const override { return prop >= 0 && prop < NSLOTS && m_pslot[prop] >= 0; };
+  size_t size_properties() const override { return m_properties.size(); };
+  size_t add_property(Jet::PROPERTY) override;                             // add property column, if not already there
+  size_t add_property(std::set<Jet::PROPERTY>) override;                   // same as above, convenience for other code using ::set
+  Jet::PROPERTY property_index(Jet::PROPERTY) override;                    // get the propery index
+  void print_property_types(std::ostream& os = std::cout) const override;  // print the order of properties in jet
+
+  // ---------------------------------------------------------------------------------------
+  //  Add ability to loop over jets
+  // ---------------------------------------------------------------------------------------
+  Jet::IterJetTCA begin() override;
+  Jet::IterJetTCA end() override;
+
+  // -direct-column-access------------------------------------------------------------------
+  unsigned int get_jet_id(unsigned int ijet) const override { return m_id[ijet]; }
+  float get_jet_px(unsigned int ijet) const override { return m_px[ijet]; }
+  float get_jet_py(unsigned int ijet) const override { return m_py[ijet]; }
+  float get_jet_pz(unsigned int ijet) const override { return m_pz[ijet]; }
+  float get_jet_e(unsigned int ijet) const override { return m_e[ijet]; }
+  float get_jet_pt(unsigned int ijet) const override { return std::sqrt(m_px[ijet] * m_px[ijet] + m_py[ijet] * m_py[ijet]); }
+  float get_jet_eta(unsigned int ijet) const override { return std::asinh(m_pz[ijet] / get_jet_pt(ijet)); }
+  float get_jet_phi(unsigned int ijet) const override { return std::atan2(m_py[ijet], m_px[ijet]); }
+  float get_jet_property(unsigned int ijet, Jet::PROPERTY index) const override { return m_properties[index][ijet]; }
+  size_t get_jet_ncomp(unsigned int ijet) const override { return m_comp_offset[ijet + 1] - m_comp_offset[ijet]; }
+
+  // whole columns, index is the one returned by property_index()
+  const std::vector<float>& get_property_column(Jet::PROPERTY index) const { return m_properties[index]; }
+
+  // used by JetColumnView
+  void set_jet_id(unsigned int ijet, unsigned int id) { m_id[ijet] = id; }
+  void set_jet_px(unsigned int ijet, float px) { m_px[ijet] = px; }
+  void set_jet_py(unsigned int ijet, float py) { m_py[ijet] = py; }
+  void set_jet_pz(unsigned int ijet, float pz) { m_pz[ijet] = pz; }
+  void set_jet_e(unsigned int ijet, float e) { m_e[ijet] = e; }
+  void set_jet_property(unsigned int ijet, Jet::PROPERTY index, float value) { m_properties[index][ijet] = value; }
+
+  Jet::ITER_comp_vec comp_begin(unsigned int ijet) { return m_comp.begin() + m_comp_offset[ijet]; }
+  Jet::ITER_comp_vec comp_end(unsigned int ijet) { return m_comp.begin() + m_comp_offset[ijet + 1]; }
+  void insert_comp(unsigned int ijet, Jet::TYPE_comp_vec::const_iterator first, Jet::TYPE_comp_vec::const_iterator last);
+  void insert_comp(unsigned int ijet, Jet::SRC src, unsigned int compid);
+  void clear_comp(unsigned int ijet);
+  void sort_comp(unsigned int ijet);  // sort by source, if not already
+
+  // -legacy-set-parameters-----------------------------------------------------------------
+  void set_algo(Jet::ALGO algo) override { m_algo = algo; };
+  Jet::ALGO get_algo() const override { return m_algo; };
+
+  void set_par(float par) override { set_jetpar_R(par); }
+  float get_par() const override { return get_jetpar_R(); }
+
+  void set_jetpar_R(float par) override { m_jetpar_R = par; }
+  float get_jetpar_R() const override { return m_jetpar_R; }
+
+  // set access to source identifiers ------------------------------------------
+
+  bool empty_src() const override { return m_src.empty(); }
+  void insert_src(Jet::SRC src) override { m_src.insert(src); }
+
+  ConstSrcIter begin_src() const override { return m_src.begin(); }
+  ConstSrcIter find_src(Jet::SRC src) const override { return m_src.find(src); }
+  ConstSrcIter end_src() const override { return m_src.end(); }
+
+  SrcIter begin_src() override { return m_src.begin(); }
+  SrcIter find_src(Jet::SRC src) override { return m_src.find(src); }
+  SrcIter end_src() override { return m_src.end(); }
+
+  void print_jets(std::ostream&) override;  // print the order of properties in jet
+
+  void set_rho_median(float _) override { m_RhoMedian = _; };
+  float get_rho_median() const override { return m_RhoMedian; };
+
+ private:
+  static const int NSLOTS = Jet::PROPERTY::prop_LundLnInvDR + 1;  // one slot per Jet::PROPERTY value
+
+  std::string str_Jet_PROPERTY(Jet::PROPERTY) const;
+  Jet* get_view(unsigned int index);
+  void sync_views();
+
+  // jet columns
+  std::vector<unsigned int> m_id;
+  std::vector<float> m_px;
+  std::vector<float> m_py;
+  std::vector<float> m_pz;
+  std::vector<float> m_e;
+
+  // property columns, m_pslot[Jet::PROPERTY] is the column or -1
+  std::vector<std::vector<float> > m_properties;
+  int m_pslot[NSLOTS];
+
+  // constituents of all jets, jet by jet
+  std::vector<unsigned int> m_comp_offset{0};
+  Jet::TYPE_comp_vec m_comp;
+
+  // status
+  Jet::ALGO m_algo{Jet::NONE};
+  float m_jetpar_R{0.4};
+
+  std::set<Jet::SRC> m_src;  //< set of sources (clusters, towers, etc)
+
+  float m_RhoMedian{NAN};
+
+  TClonesArray* m_views{nullptr};  //! JetColumnView objects handed out as Jet*
+
+  ClassDefOverride(JetContainerv2, 1);
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include "JetInput.h"
+
+#include "Jet.h"
+
+#include <vector>
+
+void JetInput::get_input_particles(PHCompositeNode* topNode, std::vector<JetInputParticle>& particles)
+{
+  std::vector<Jet*> parts = get_input(topNode);
+  for (auto& part : parts)
+  {
+    JetInputParticle particle;
+    particle.px = part->get_px();
+    particle.py = part->get_py();
+    particle.pz = part->get_pz();
+    particle.e = part->get_e();
+    // inputs carry a single component pointing back to their source
+    if (part->size_comp() > 0)
+    {
+      particle.src = part->get_comp_vec().front().first;
+      particle.index = part->get_comp_vec().front().second;
+    }
+    particles.push_back(particle);
+    delete part;
+  }
+}
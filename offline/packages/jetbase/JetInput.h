@@ -8,6 +8,18 @@
 
 class PHCompositeNode;
 
+// lightweight input record (4-vector + source id) used instead of a
+// heap allocated Jet per input particle
+struct JetInputParticle
+{
+  float px{0};
+  float py{0};
+  float pz{0};
+  float e{0};
+  Jet::SRC src{Jet::VOID};
+  unsigned int index{0};
+};
+
 class JetInput
 {
  public:
@@ -24,6 +36,13 @@ class JetInput
   {
     return std::vector<Jet*>();
   }
+
+  // appends the inputs to a caller-owned vector, which can be reused
+  // event to event without reallocation. The default implementation
+  // goes through get_input(), inputs should override it to avoid the
+  // per-particle allocations
+  virtual void get_input_particles(PHCompositeNode* topNode, std::vector<JetInputParticle>& particles);
+
   virtual int Verbosity() const { return m_Verbosity; }
   virtual void Verbosity(int i) { m_Verbosity = i; }
 
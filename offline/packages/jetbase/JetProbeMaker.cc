@@ -19,22 +19,26 @@
 
 int JetProbeMaker::process_event(PHCompositeNode * /*topNode*/)
 {
-  // update the jet probe
-  float phi = M_PI * (1. - 2. * gsl_rng_uniform(m_rng.get()));
-  float eta = _eta_min + gsl_rng_uniform(m_rng.get()) * _eta_range;
-  float pt = (_pt_range == 0.
-                  ? _pt_min
-                  : _pt_min + gsl_rng_uniform(m_rng.get()) * _pt_range);
+  // update the jet probes
+  for (int iprobe = 0; iprobe < _n_probes; ++iprobe)
+  {
+    float phi = M_PI * (1. - 2. * gsl_rng_uniform(m_rng.get()));
+    float eta = _eta_min + gsl_rng_uniform(m_rng.get()) * _eta_range;
+    float pt = (_pt_range == 0.
+                    ? _pt_min
+                    : _pt_min + gsl_rng_uniform(m_rng.get()) * _pt_range);
 
-  fastjet::PseudoJet fjet{};
-  fjet.reset_PtYPhiM(pt, eta, phi);
+    fastjet::PseudoJet fjet{};
+    fjet.reset_PtYPhiM(pt, eta, phi);
 
-  Jetv2 *jet = (Jetv2 *) _jets->add_jet();
-  jet->set_px(fjet.px());
-  jet->set_py(fjet.py());
-  jet->set_pz(fjet.pz());
-  jet->set_e(fjet.e());
-  jet->insert_comp(Jet::SRC::JET_PROBE, 0, false);
+    Jetv2 *jet = (Jetv2 *) _jets->add_jet();
+    jet->set_id(iprobe);
+    jet->set_px(fjet.px());
+    jet->set_py(fjet.py());
+    jet->set_pz(fjet.pz());
+    jet->set_e(fjet.e());
+    jet->insert_comp(Jet::SRC::JET_PROBE, iprobe, false);
+  }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
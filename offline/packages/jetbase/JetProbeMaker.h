@@ -1,5 +1,6 @@
-// make a jet probe and put it onto the node tree
-// It will always be a single Jet that the JetReco can get
+// make jet probes and put them onto the node tree
+// By default it is a single Jet that the JetReco can get (through
+// JetProbeInput); several probes per event are meant for JetProbeResponse
 #ifndef G4_JETS_JETPROBEMAKER__H
 #define G4_JETS_JETPROBEMAKER__H
 
@@ -44,6 +45,9 @@ class JetProbeMaker : public SubsysReco
   void set_phi_min(float val) { _phi_min = val; }
   void set_phi_max(float val) { _phi_max = val; }
 
+  // number of probes per event, JetProbeInput only uses the first one
+  void set_n_probes(int val) { _n_probes = val; }
+
   void set_pt(float val)
   {
     _pt_max = val;
@@ -78,6 +82,7 @@ class JetProbeMaker : public SubsysReco
   float _pt_min = 30.;
   float _pt_max = 30.;
   float _pt_range = 0.;
+  int _n_probes = 1;
   JetContainer *_jets = nullptr;
 };
 
@@ -0,0 +1,279 @@
+#include "JetProbeResponse.h"
+
+#include "Jet.h"
+#include "JetContainer.h"
+#include "JetContainerv1.h"
+#include "JetInput.h"
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/SubsysReco.h>  // for SubsysReco
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
+#include <phool/PHNode.h>  // for PHNode
+#include <phool/PHNodeIterator.h>
+#include <phool/PHObject.h>  // for PHObject
+#include <phool/getClass.h>
+#include <phool/phool.h>  // for PHWHERE
+
+#include <fastjet/ClusterSequence.hh>
+#include <fastjet/JetDefinition.hh>
+#include <fastjet/PseudoJet.hh>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+JetProbeResponse::JetProbeResponse(const std::string &name)
+  : SubsysReco(name)
+{
+}
+
+JetProbeResponse::~JetProbeResponse()
+{
+  for (auto &_input : _inputs)
+  {
+    delete _input;
+  }
+  _inputs.clear();
+}
+
+int JetProbeResponse::InitRun(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 0)
+  {
+    std::cout << "======================= JetProbeResponse::InitRun() =======================" << std::endl;
+    std::cout << " Input Selections:" << std::endl;
+    for (auto &_input : _inputs)
+    {
+      _input->identify();
+    }
+    std::cout << " Algorithm " << _algo << " R = " << _jet_R << ", margin = " << _margin
+              << ", probes " << _probe_node << " -> " << _output_node << std::endl;
+    std::cout << "===========================================================================" << std::endl;
+  }
+
+  PHNodeIterator iter(topNode);
+
+  // Looking for the DST node
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  if (!dstNode)
+  {
+    std::cout << PHWHERE << "DST Node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  _jets = findNode::getClass<JetContainer>(topNode, _output_node);
+  if (!_jets)
+  {
+    _jets = new JetContainerv1();
+    PHIODataNode<PHObject> *JetContainerNode = new PHIODataNode<PHObject>(_jets, _output_node, "PHObject");
+    dstNode->addNode(JetContainerNode);
+  }
+  _jets->set_algo(_algo);
+  _jets->set_jetpar_R(_jet_R);
+  for (auto &_input : _inputs)
+  {
+    _jets->insert_src(_input->get_src());
+  }
+  _jets->insert_src(Jet::SRC::JET_PROBE);
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int JetProbeResponse::process_event(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 1)
+  {
+    std::cout << "JetProbeResponse::process_event -- entered" << std::endl;
+  }
+
+  JetContainer *probes = findNode::getClass<JetContainer>(topNode, _probe_node);
+  if (!probes)
+  {
+    std::cout << PHWHERE << _probe_node << " node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // the inputs are read once for all probes
+  _particles.clear();
+  for (auto &_input : _inputs)
+  {
+    _input->get_input_particles(topNode, _particles);
+  }
+  fill_grid();
+
+  for (unsigned int iprobe = 0; iprobe < probes->size(); ++iprobe)
+  {
+    Jet *probe = probes->get_jet(iprobe);
+    Jet *jet = _jets->add_jet();
+    jet->set_id(iprobe);
+    cluster_probe(probe, jet);
+
+    if (Verbosity() > 2)
+    {
+      std::cout << " probe " << iprobe << " pt/eta/phi " << probe->get_pt() << "/" << probe->get_eta() << "/" << probe->get_phi()
+                << " -> jet pt/eta/phi " << jet->get_pt() << "/" << jet->get_eta() << "/" << jet->get_phi()
+                << " (" << jet->size_comp() << " components)" << std::endl;
+    }
+  }
+
+  if (Verbosity() > 1)
+  {
+    std::cout << "JetProbeResponse::process_event -- exited" << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void JetProbeResponse::fill_grid()
+{
+  unsigned int nparticles = _particles.size();
+  _eta.resize(nparticles);
+  _phi.resize(nparticles);
+  _particle_cell.resize(nparticles);
+
+  float eta_min = 0;
+  float eta_max = 0;
+  for (unsigned int ipart = 0; ipart < nparticles; ++ipart)
+  {
+    const JetInputParticle &part = _particles[ipart];
+    float pt = std::sqrt(part.px * part.px + part.py * part.py);
+    if (pt <= 0)
+    {
+      _eta[ipart] = NAN;
+      _phi[ipart] = NAN;
+      continue;
+    }
+    _eta[ipart] = std::asinh(part.pz / pt);
+    _phi[ipart] = std::atan2(part.py, part.px);
+    eta_min = std::min(eta_min, _eta[ipart]);
+    eta_max = std::max(eta_max, _eta[ipart]);
+  }
+
+  // phi cells are at least _grid_size wide
+  _eta_min = eta_min;
+  _neta = static_cast<int>((eta_max - eta_min) / _grid_size) + 1;
+  _nphi = std::max(1, static_cast<int>(2 * M_PI / _grid_size));
+
+  // counting sort of the inputs into the cells
+  _cell_offset.assign(_neta * _nphi + 1, 0);
+  for (unsigned int ipart = 0; ipart < nparticles; ++ipart)
+  {
+    if (std::isnan(_eta[ipart]))
+    {
+      _particle_cell[ipart] = -1;
+      continue;
+    }
+    int ieta = std::min(_neta - 1, static_cast<int>((_eta[ipart] - _eta_min) / _grid_size));
+    int iphi = static_cast<int>((_phi[ipart] + M_PI) / (2 * M_PI) * _nphi);
+    iphi = std::clamp(iphi, 0, _nphi - 1);
+    _particle_cell[ipart] = ieta * _nphi + iphi;
+    ++_cell_offset[_particle_cell[ipart] + 1];
+  }
+  for (unsigned int icell = 1; icell < _cell_offset.size(); ++icell)
+  {
+    _cell_offset[icell] += _cell_offset[icell - 1];
+  }
+  _cell_particle.resize(_cell_offset.back());
+  std::vector<unsigned int> fill(_cell_offset.begin(), _cell_offset.end() - 1);
+  for (unsigned int ipart = 0; ipart < nparticles; ++ipart)
+  {
+    if (_particle_cell[ipart] >= 0)
+    {
+      _cell_particle[fill[_particle_cell[ipart]]++] = ipart;
+    }
+  }
+}
+
+void JetProbeResponse::cluster_probe(Jet *probe, Jet *jet)
+{
+  float probe_eta = probe->get_eta();
+  float probe_phi = probe->get_phi();
+  float dR_max = _jet_R + _margin;
+
+  std::vector<fastjet::PseudoJet> pseudojets;
+
+  // the probe itself, user index -1
+  fastjet::PseudoJet probe_pseudojet(probe->get_px(), probe->get_py(), probe->get_pz(), probe->get_e());
+  probe_pseudojet.set_user_index(-1);
+  pseudojets.push_back(probe_pseudojet);
+
+  // inputs within dR_max of the probe, from the cells around it
+  int ieta_lo = std::max(0, static_cast<int>(std::floor((probe_eta - dR_max - _eta_min) / _grid_size)));
+  int ieta_hi = std::min(_neta - 1, static_cast<int>(std::floor((probe_eta + dR_max - _eta_min) / _grid_size)));
+  int iphi_probe = std::clamp(static_cast<int>((probe_phi + M_PI) / (2 * M_PI) * _nphi), 0, _nphi - 1);
+  int nphi_side = static_cast<int>(std::ceil(dR_max / (2 * M_PI / _nphi)));
+  int iphi_lo = iphi_probe - nphi_side;
+  int iphi_hi = iphi_probe + nphi_side;
+  if (2 * nphi_side + 1 >= _nphi)
+  {
+    iphi_lo = 0;
+    iphi_hi = _nphi - 1;
+  }
+
+  for (int ieta = ieta_lo; ieta <= ieta_hi; ++ieta)
+  {
+    for (int jphi = iphi_lo; jphi <= iphi_hi; ++jphi)
+    {
+      int iphi = (jphi + _nphi) % _nphi;
+      int icell = ieta * _nphi + iphi;
+      for (unsigned int i = _cell_offset[icell]; i < _cell_offset[icell + 1]; ++i)
+      {
+        unsigned int ipart = _cell_particle[i];
+        float deta = _eta[ipart] - probe_eta;
+        float dphi = std::remainder(_phi[ipart] - probe_phi, 2 * M_PI);
+        if (deta * deta + dphi * dphi > dR_max * dR_max)
+        {
+          continue;
+        }
+        const JetInputParticle &part = _particles[ipart];
+        fastjet::PseudoJet pseudojet(part.px, part.py, part.pz, part.e);
+        pseudojet.set_user_index(ipart);
+        pseudojets.push_back(pseudojet);
+      }
+    }
+  }
+
+  fastjet::JetAlgorithm algorithm = fastjet::antikt_algorithm;
+  if (_algo == Jet::KT)
+  {
+    algorithm = fastjet::kt_algorithm;
+  }
+  else if (_algo == Jet::CAMBRIDGE)
+  {
+    algorithm = fastjet::cambridge_algorithm;
+  }
+  fastjet::ClusterSequence cs(pseudojets, fastjet::JetDefinition(algorithm, _jet_R, fastjet::E_scheme, fastjet::Best));
+
+  // the jet that contains the probe
+  for (auto &fjet : cs.inclusive_jets())
+  {
+    std::vector<fastjet::PseudoJet> comps = fjet.constituents();
+    if (std::none_of(comps.begin(), comps.end(), [](const fastjet::PseudoJet &comp)
+                     { return comp.user_index() < 0; }))
+    {
+      continue;
+    }
+    jet->set_px(fjet.px());
+    jet->set_py(fjet.py());
+    jet->set_pz(fjet.pz());
+    jet->set_e(fjet.e());
+    for (auto &comp : comps)
+    {
+      if (comp.user_index() < 0)
+      {
+        jet->insert_comp(Jet::SRC::JET_PROBE, probe->get_id(), true);
+      }
+      else
+      {
+        const JetInputParticle &part = _particles[comp.user_index()];
+        jet->insert_comp(part.src, part.index, true);
+      }
+    }
+    jet->set_comp_sort_flag();
+    break;
+  }
+}
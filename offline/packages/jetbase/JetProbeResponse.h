@@ -0,0 +1,84 @@
+// reconstruct the response to the jet probes of JetProbeMaker without
+// re-clustering the full event
+#ifndef JETBASE_JETPROBERESPONSE_H
+#define JETBASE_JETPROBERESPONSE_H
+
+#include "Jet.h"
+#include "JetInput.h"
+
+#include <fun4all/SubsysReco.h>
+
+#include <string>
+#include <vector>
+
+class JetContainer;
+class PHCompositeNode;
+
+/// \class JetProbeResponse
+///
+/// \brief clusters only the neighborhood of each jet probe
+///
+/// The inputs (same JetInput's as given to JetReco) are read once per event
+/// and sorted into a fixed eta-phi grid. For each probe in the probe
+/// container only the inputs within R + margin of the probe are clustered,
+/// together with the probe, and the jet containing the probe is written
+/// to the output JetContainer at the index of the probe (jet id = probe
+/// index, components = probe + inputs). Each probe is clustered on its own,
+/// so any number of probes can be thrown per event
+/// (JetProbeMaker::set_n_probes).
+///
+/// With anti-kt and a hard probe the jet containing the probe does not
+/// reach beyond R, the margin only protects against inputs merging
+/// at the edge of the jet.
+///
+class JetProbeResponse : public SubsysReco
+{
+ public:
+  JetProbeResponse(const std::string &name = "JetProbeResponse");
+  ~JetProbeResponse() override;
+
+  int InitRun(PHCompositeNode *topNode) override;
+  int process_event(PHCompositeNode *topNode) override;
+
+  void add_input(JetInput *input) { _inputs.push_back(input); }
+
+  void set_algo(Jet::ALGO algo) { _algo = algo; }
+  void set_jet_R(float R) { _jet_R = R; }
+  void set_margin(float margin) { _margin = margin; }
+  void set_grid_size(float size) { _grid_size = size; }
+
+  void set_probe_node(const std::string &name) { _probe_node = name; }
+  void set_output_node(const std::string &name) { _output_node = name; }
+
+ private:
+  void fill_grid();
+  void cluster_probe(Jet *probe, Jet *jet);
+
+  std::vector<JetInput *> _inputs;
+
+  Jet::ALGO _algo{Jet::ANTIKT};
+  float _jet_R{0.4};
+  float _margin{0.4};
+  float _grid_size{0.2};
+
+  std::string _probe_node{"JetProbeContainer"};
+  std::string _output_node{"JetProbeResponse"};
+
+  JetContainer *_jets{nullptr};
+
+  // inputs of the event, reused event to event
+  std::vector<JetInputParticle> _particles;
+  std::vector<float> _eta;
+  std::vector<float> _phi;
+
+  // inputs sorted by grid cell (ieta * _nphi + iphi): the inputs in
+  // cell i are _cell_particle[_cell_offset[i] .. _cell_offset[i+1])
+  float _eta_min{0};
+  int _neta{0};
+  int _nphi{0};
+  std::vector<unsigned int> _cell_offset;
+  std::vector<unsigned int> _cell_particle;
+  std::vector<int> _particle_cell;
+};
+
+#endif  // JETBASE_JETPROBERESPONSE_H
@@ -5,6 +5,7 @@
 #include "JetAlgo.h"
 #include "JetContainer.h"
 #include "JetContainerv1.h"
+#include "JetContainerv2.h"
 #include "JetInput.h"
 #include "JetMap.h"
 #include "JetMapv1.h"
@@ -22,6 +23,10 @@
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
 
+#include <ROOT/TSeq.hxx>
+#include <ROOT/TThreadExecutor.hxx>
+#include <TROOT.h>
+
 #include <boost/format.hpp>
 
 // standard includes
@@ -59,6 +64,7 @@ JetReco::~JetReco()
   }
   _algos.clear();
   _outputs.clear();
+  delete m_executor;
 }
 
 int JetReco::InitRun(PHCompositeNode *topNode)
@@ -79,6 +85,32 @@ int JetReco::InitRun(PHCompositeNode *topNode)
     std::cout << "===========================================================================" << std::endl;
   }
 
+  if (m_nthreads > 1 && !m_executor)
+  {
+    bool thread_safe = true;
+    for (auto &_algo : _algos)
+    {
+      thread_safe = thread_safe && _algo->is_thread_safe();
+    }
+    if (use_jetmap)
+    {
+      std::cout << PHWHERE << " parallel clustering only supports JetContainer output, running serially" << std::endl;
+    }
+    else if (!thread_safe)
+    {
+      // areas and constituent subtraction use static fastjet state, which
+      // is only shared safely with fastjet built with --enable-limited-thread-safety
+      std::cout << PHWHERE << " an algorithm computes areas, constituent subtraction or substructure and fastjet is not thread safe, running serially" << std::endl;
+      m_nthreads = 1;
+    }
+    else
+    {
+      // the algorithms fill TClonesArray based containers concurrently
+      ROOT::EnableThreadSafety();
+      m_executor = new ROOT::TThreadExecutor(m_nthreads);
+    }
+  }
+
   return CreateNodes(topNode);
 }
 
@@ -94,6 +126,25 @@ int JetReco::process_event(PHCompositeNode *topNode)
   // Get Objects off of the Node Tree
   //------------------------------------------------------------------
 
+  if (m_use_input_particles && !use_jetmap)
+  {
+    // flat input records, the buffer keeps its capacity between events
+    m_input_particles.clear();
+    for (auto &_input : _inputs)
+    {
+      _input->get_input_particles(topNode, m_input_particles);
+    }
+
+    FillJetContainers(topNode, nullptr, &m_input_particles);
+
+    if (Verbosity() > 1)
+    {
+      std::cout << "JetReco::process_event -- exited" << std::endl;
+    }
+
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
   std::vector<Jet *> inputs;  // owns memory
   for (auto &_input : _inputs)
   {
@@ -105,6 +156,22 @@ int JetReco::process_event(PHCompositeNode *topNode)
     }
   }
 
+  if (m_executor)
+  {
+    FillJetContainers(topNode, &inputs, nullptr);
+    for (auto &input : inputs)
+    {
+      delete input;
+    }
+
+    if (Verbosity() > 1)
+    {
+      std::cout << "JetReco::process_event -- exited" << std::endl;
+    }
+
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
   //---------------------------
   // Run the jet reconstruction
   //---------------------------
@@ -240,7 +307,14 @@ int JetReco::CreateNodes(PHCompositeNode *topNode)
       JetContainer *jetconn = findNode::getClass<JetContainer>(topNode, JC_name(_output));
       if (!jetconn)
       {
-        jetconn = new JetContainerv1();
+        if (m_columnar_jet_container)
+        {
+          jetconn = new JetContainerv2();
+        }
+        else
+        {
+          jetconn = new JetContainerv1();
+        }
         PHIODataNode<PHObject> *JetContainerNode = new PHIODataNode<PHObject>(jetconn, JC_name(_output), "PHObject");
         InputNode->addNode(JetContainerNode);
       }
@@ -307,6 +381,72 @@ void JetReco::FillJetContainer(PHCompositeNode *topNode, int ipos, std::vector<J
   return;
 }
 
+void JetReco::FillJetContainers(PHCompositeNode *topNode, std::vector<Jet *> *jets, std::vector<JetInputParticle> *particles)
+{
+  // node lookups stay on this thread, the node tree is not thread safe
+  m_jetconns.resize(_algos.size());
+  for (unsigned int ialgo = 0; ialgo < _algos.size(); ++ialgo)
+  {
+    m_jetconns[ialgo] = findNode::getClass<JetContainer>(topNode, JC_name(_outputs[ialgo]));
+    if (!m_jetconns[ialgo])
+    {
+      std::cout << PHWHERE << " ERROR: Can't find JetContainer: " << _outputs[ialgo] << std::endl;
+      exit(-1);
+    }
+    if (Verbosity() > 5)
+    {
+      std::cout << " Verbosity>5:: filling JetContainter for " << JC_name(_outputs[ialgo]) << std::endl;
+    }
+  }
+
+  // each algorithm owns its ClusterSequence and writes only into its own
+  // container, so the inputs can be shared read-only between threads. The
+  // static fastjet state (area ghosts, warning counters) is not, that is
+  // why InitRun only creates the executor if all algorithms are thread safe
+  auto cluster = [&](unsigned int ialgo)
+  {
+    if (particles)
+    {
+      _algos[ialgo]->cluster_and_fill_particles(*particles, m_jetconns[ialgo]);
+    }
+    else
+    {
+      _algos[ialgo]->cluster_and_fill(*jets, m_jetconns[ialgo]);
+    }
+  };
+
+  // the first call of an algorithm sets up its options and prints the
+  // fastjet banner through a global stream, keep that serial
+  if (m_executor && !m_first_event)
+  {
+    m_executor->Foreach(cluster, ROOT::TSeqU(_algos.size()));
+  }
+  else
+  {
+    for (unsigned int ialgo = 0; ialgo < _algos.size(); ++ialgo)
+    {
+      cluster(ialgo);
+    }
+  }
+  m_first_event = false;
+
+  // bookkeeping in algorithm order, independent of thread scheduling
+  for (unsigned int ialgo = 0; ialgo < _algos.size(); ++ialgo)
+  {
+    for (auto &_input : _inputs)
+    {
+      m_jetconns[ialgo]->insert_src(_input->get_src());
+    }
+    if (Verbosity() > 7)
+    {
+      std::cout << " Verbosity()>7:: jets in container " << _outputs[ialgo] << std::endl;
+      m_jetconns[ialgo]->print_jets();
+    }
+  }
+
+  return;
+}
+
 JetAlgo *JetReco::get_algo(unsigned int which_algo)
 {
   if (_algos.size() == 0)
@@ -7,6 +7,8 @@
 /// \author Mike McCumber
 //===========================================================
 
+#include "JetInput.h"
+
 // PHENIX includes
 #include <fun4all/SubsysReco.h>
 
@@ -17,9 +19,15 @@
 // forward declarations
 class Jet;
 class JetAlgo;
+class JetContainer;
 class JetInput;
 class PHCompositeNode;
 
+namespace ROOT
+{
+  class TThreadExecutor;
+}
+
 /// \class JetReco
 ///
 /// \brief jet reco with user def inputs and algos
@@ -56,12 +64,28 @@ class JetReco : public SubsysReco
   void set_input_node(const std::string &inputnode) { _inputnode = inputnode; }
   /* void set_fill_JetContainer(bool b) { _fill_JetContainer = b; } */
 
+  // collect inputs as flat JetInputParticle records in a buffer reused
+  // every event instead of one heap allocated Jet per input (JetContainer output only)
+  void set_use_input_particles(bool b) { m_use_input_particles = b; }
+
+  // cluster the algorithms concurrently on nthreads threads, each into
+  // its own JetContainer (JetContainer output only). The first event
+  // is always run serially to do the one-time algorithm setup. Without a
+  // thread safe fastjet, algorithms with areas, constituent subtraction or
+  // substructure make the whole module run serially
+  void set_nthreads(int nthreads) { m_nthreads = nthreads; }
+  int get_nthreads() const { return m_nthreads; }
+
+  // write the jets into columnar JetContainerv2 nodes instead of JetContainerv1
+  void set_columnar_jet_container(bool b) { m_columnar_jet_container = b; }
+
   JetAlgo *get_algo(unsigned int which_algo = 0);
 
  private:
   int CreateNodes(PHCompositeNode *topNode);
   void FillJetNode(PHCompositeNode *topNode, int ialgo, const std::vector<Jet *> &jets);
   void FillJetContainer(PHCompositeNode *topNode, int ialgo, std::vector<Jet *> &jets);
+  void FillJetContainers(PHCompositeNode *topNode, std::vector<Jet *> *jets, std::vector<JetInputParticle> *particles);
 
   std::vector<JetInput *> _inputs;
   std::vector<JetAlgo *> _algos;
@@ -69,6 +93,15 @@ class JetReco : public SubsysReco
   std::string _inputnode;
   std::vector<std::string> _outputs;
 
+  bool m_use_input_particles{false};
+  bool m_columnar_jet_container{false};
+  std::vector<JetInputParticle> m_input_particles;  // reused event to event
+
+  int m_nthreads{1};
+  bool m_first_event{true};
+  ROOT::TThreadExecutor *m_executor{nullptr};
+  std::vector<JetContainer *> m_jetconns;
+
   // transition functions, while moving from JetMap to JetContainer.
   // May be removed after transition is made, depending on state of
   // functions
@@ -59,6 +59,26 @@ void TowerJetInput::identify(std::ostream &os)
 }
 
 std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
+{
+  std::vector<JetInputParticle> particles;
+  get_input_particles(topNode, particles);
+
+  std::vector<Jet *> pseudojets;
+  pseudojets.reserve(particles.size());
+  for (auto &particle : particles)
+  {
+    Jet *jet = new Jetv2();
+    jet->set_px(particle.px);
+    jet->set_py(particle.py);
+    jet->set_pz(particle.pz);
+    jet->set_e(particle.e);
+    jet->insert_comp(particle.src, particle.index);
+    pseudojets.push_back(jet);
+  }
+  return pseudojets;
+}
+
+void TowerJetInput::get_input_particles(PHCompositeNode *topNode, std::vector<JetInputParticle> &particles)
 {
   if (Verbosity() > 0)
   {
@@ -71,13 +91,13 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     std::cout << "TowerJetInput::get_input - Fatal Error - GlobalVertexMap node is missing. Please turn on the do_global flag in the main macro in order to reconstruct the global vertex." << std::endl;
     assert(vertexmap);  // force quit
 
-    return std::vector<Jet *>();
+    return;
   }
 
   if (vertexmap->empty())
   {
     if(Verbosity() > 0) std::cout << "TowerJetInput::get_input - Fatal Error - GlobalVertexMap node is empty. Please turn on the do_bbc or tracking reco flags in the main macro in order to reconstruct the global vertex." << std::endl;
-    return std::vector<Jet *>();
+    return;
   }
   m_use_towerinfo = false;
 
@@ -113,7 +133,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_CEMC");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWERINFO)
@@ -125,7 +145,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geocaloid = RawTowerDefs::CalorimeterId::CEMC;
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWERINFO_EMBED)
@@ -137,7 +157,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geocaloid = RawTowerDefs::CalorimeterId::CEMC;
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWERINFO_SIM)
@@ -149,7 +169,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geocaloid = RawTowerDefs::CalorimeterId::CEMC;
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::EEMC_TOWER)
@@ -158,7 +178,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_EEMC");
     if ((!towers && !towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALIN_TOWER)
@@ -167,7 +187,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALIN_TOWERINFO)
@@ -179,7 +199,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALIN_TOWERINFO_EMBED)
@@ -191,7 +211,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geocaloid = RawTowerDefs::CalorimeterId::HCALIN;
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALIN_TOWERINFO_SIM)
@@ -203,7 +223,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geocaloid = RawTowerDefs::CalorimeterId::HCALIN;
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALOUT_TOWER)
@@ -212,7 +232,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALOUT_TOWERINFO)
@@ -224,7 +244,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALOUT_TOWERINFO_EMBED)
@@ -236,7 +256,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geocaloid = RawTowerDefs::CalorimeterId::HCALOUT;
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALOUT_TOWERINFO_SIM)
@@ -248,7 +268,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geocaloid = RawTowerDefs::CalorimeterId::HCALOUT;
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
 
@@ -258,7 +278,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_FEMC");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::FHCAL_TOWER)
@@ -267,7 +287,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_FHCAL");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWER_RETOWER)
@@ -276,7 +296,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWERINFO_RETOWER)
@@ -288,7 +308,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWER_SUB1)
@@ -297,7 +317,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWERINFO_SUB1)
@@ -309,7 +329,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALIN_TOWER_SUB1)
@@ -318,7 +338,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALIN_TOWERINFO_SUB1)
@@ -330,7 +350,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALOUT_TOWER_SUB1)
@@ -339,7 +359,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALOUT_TOWERINFO_SUB1)
@@ -351,7 +371,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
     if ((!towerinfos) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::CEMC_TOWER_SUB1CS)
@@ -360,7 +380,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALIN_TOWER_SUB1CS)
@@ -369,7 +389,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else if (m_input == Jet::HCALOUT_TOWER_SUB1CS)
@@ -378,12 +398,12 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
     geom = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
     if ((!towers) || !geom)
     {
-      return std::vector<Jet *>();
+      return;
     }
   }
   else
   {
-    return std::vector<Jet *>();
+    return;
   }
 
   // first grab the event vertex or bail
@@ -395,7 +415,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
   }
   else
   {
-    return std::vector<Jet *>();
+    return;
   }
 
   if (std::isnan(vtxz))
@@ -408,7 +428,7 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
       std::cout << "TowerJetInput::get_input - WARNING - vertex is NAN. Drop all tower inputs (further NAN-vertex warning will be suppressed)." << std::endl;
     }
 
-    return std::vector<Jet *>();
+    return;
   }
 
   if (std::abs(vtxz) > 1e3) //code crashes with very large z vertex, so skip these events
@@ -421,18 +441,18 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
 	  std::cout << "TowerJetInput::get_input - WARNING - vertex is "<<vtxz<<". Drop all tower inputs (further vertex warning will be suppressed)." << std::endl;
 	}
 
-      return std::vector<Jet *>();
+      return;
     }
 
-  std::vector<Jet *> pseudojets;
   if (m_use_towerinfo)
   {
     if (!towerinfos)
     {
-      return std::vector<Jet *>();
+      return;
     }
 
     unsigned int nchannels = towerinfos->size();
+    particles.reserve(particles.size() + nchannels);
     for (unsigned int channel = 0; channel < nchannels; channel++)
     {
       TowerInfo *tower = towerinfos->get_tower_at_channel(channel);
@@ -465,13 +485,14 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
       double py = pt * sin(phi);
       double pz = pt * sinh(eta);
 
-      Jet *jet = new Jetv2();
-      jet->set_px(px);
-      jet->set_py(py);
-      jet->set_pz(pz);
-      jet->set_e(e);
-      jet->insert_comp(m_input, channel);
-      pseudojets.push_back(jet);
+      JetInputParticle particle;
+      particle.px = px;
+      particle.py = py;
+      particle.pz = pz;
+      particle.e = e;
+      particle.src = m_input;
+      particle.index = channel;
+      particles.push_back(particle);
     }
   }
   else
@@ -495,18 +516,18 @@ std::vector<Jet *> TowerJetInput::get_input(PHCompositeNode *topNode)
       double py = pt * sin(phi);
       double pz = pt * sinh(eta);
 
-      Jet *jet = new Jetv2();
-      jet->set_px(px);
-      jet->set_py(py);
-      jet->set_pz(pz);
-      jet->set_e(tower->get_energy());
-      jet->insert_comp(m_input, tower->get_id());
-      pseudojets.push_back(jet);
+      JetInputParticle particle;
+      particle.px = px;
+      particle.py = py;
+      particle.pz = pz;
+      particle.e = tower->get_energy();
+      particle.src = m_input;
+      particle.index = tower->get_id();
+      particles.push_back(particle);
     }
   }
   if (Verbosity() > 0)
   {
     std::cout << "TowerJetInput::process_event -- exited" << std::endl;
   }
-  return pseudojets;
 }
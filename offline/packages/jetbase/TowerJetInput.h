@@ -22,6 +22,7 @@ class TowerJetInput : public JetInput
   Jet::SRC get_src() override { return m_input; }
 
   std::vector<Jet*> get_input(PHCompositeNode* topNode) override;
+  void get_input_particles(PHCompositeNode* topNode, std::vector<JetInputParticle>& particles) override;
 
  private:
   Jet::SRC m_input;
@@ -28,6 +28,7 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_uniform_pos
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -43,7 +44,8 @@ float ParticleFlowReco::calculate_dR( float eta1, float eta2, float phi1, float
   float dphi = phi1 - phi2;
   while ( dphi > M_PI ) dphi -= 2 * M_PI;
   while ( dphi < -M_PI ) dphi += 2 * M_PI;
-  return sqrt( pow( deta, 2 ) + pow( dphi ,2 ) );
+  // squares in double, as pow( float, 2 ) did
+  return std::sqrt( static_cast<double>( deta ) * deta + static_cast<double>( dphi ) * dphi );
 
 }
 
@@ -58,6 +60,17 @@ std::pair<float, float> ParticleFlowReco::get_expected_signature( int trk ) {
 
 }
 
+void ParticleFlowReco::find_candidates( const ParticleFlowTowerGrid &grid, const std::vector<int> &tower_cluster, float eta, float phi, double half_width ) {
+
+  _pflow_candidates.clear();
+  grid.for_each_in_box( eta, phi, half_width, [&]( unsigned int tow ) { _pflow_candidates.push_back( tower_cluster[ tow ] ); } );
+
+  // visit the clusters in the same order as a loop over all clusters would
+  std::sort( _pflow_candidates.begin(), _pflow_candidates.end() );
+  _pflow_candidates.erase( std::unique( _pflow_candidates.begin(), _pflow_candidates.end() ), _pflow_candidates.end() );
+
+}
+
 //____________________________________________________________________________..
 ParticleFlowReco::ParticleFlowReco(const std::string &name):
   SubsysReco(name),
@@ -141,6 +154,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
   _pflow_EM_phi.clear();
   _pflow_EM_tower_eta.clear();
   _pflow_EM_tower_phi.clear();
+  _pflow_EM_tower_cluster.clear();
   _pflow_EM_match_HAD.clear();
   _pflow_EM_match_TRK.clear();
   _pflow_EM_cluster.clear();
@@ -150,6 +164,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
   _pflow_HAD_phi.clear();
   _pflow_HAD_tower_eta.clear();
   _pflow_HAD_tower_phi.clear();
+  _pflow_HAD_tower_cluster.clear();
   _pflow_HAD_match_EM.clear();
   _pflow_HAD_match_TRK.clear();
   _pflow_HAD_cluster.clear();
@@ -256,8 +271,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 	if ( Verbosity() > 5 && cluster_E > 0.2 )
 	  std::cout << " EM topoCluster with E = " << cluster_E << ", eta / phi = " << cluster_eta << " / " << cluster_phi << " , nTow = " << hiter->second->getNTowers()  << std::endl;
 
-	std::vector<float> this_cluster_tower_eta;
-	std::vector<float> this_cluster_tower_phi;
+	int this_cluster = _pflow_EM_E.size() - 1;
 
 	// read in towers
 	RawCluster::TowerConstRange begin_end_towers = hiter->second->get_towers();
@@ -266,8 +280,9 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 	  if ( RawTowerDefs::decode_caloid( iter->first ) == RawTowerDefs::CalorimeterId::CEMC ) {
 	    RawTowerGeom *tower_geom = geomEM->get_tower_geometry(iter->first);
 
-	    this_cluster_tower_phi.push_back( tower_geom->get_phi() );
-	    this_cluster_tower_eta.push_back( tower_geom->get_eta() );
+	    _pflow_EM_tower_phi.push_back( tower_geom->get_phi() );
+	    _pflow_EM_tower_eta.push_back( tower_geom->get_eta() );
+	    _pflow_EM_tower_cluster.push_back( this_cluster );
 	  }
 	  else {
 	    std::cout << "ParticleFlowReco::process_event : FATAL ERROR , EM topoClusters seem to contain HCal towers" << std::endl;
@@ -275,9 +290,6 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 	  }
 	} // close tower loop
 
-	_pflow_EM_tower_eta.push_back( this_cluster_tower_eta );
-	_pflow_EM_tower_phi.push_back( this_cluster_tower_phi );
-
       } // close cluster loop
 
   } // close
@@ -310,8 +322,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 	if ( Verbosity() > 5 && cluster_E > 0.2 )
 	  std::cout << " HAD topoCluster with E = " << cluster_E << ", eta / phi = " << cluster_eta << " / " << cluster_phi << " , nTow = " << hiter->second->getNTowers()  << std::endl;
 
-	std::vector<float> this_cluster_tower_eta;
-	std::vector<float> this_cluster_tower_phi;
+	int this_cluster = _pflow_HAD_E.size() - 1;
 
 	// read in towers
 	RawCluster::TowerConstRange begin_end_towers = hiter->second->get_towers();
@@ -321,16 +332,18 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 
 	    RawTowerGeom *tower_geom = geomIH->get_tower_geometry(iter->first);
 
-	    this_cluster_tower_phi.push_back( tower_geom->get_phi() );
-	    this_cluster_tower_eta.push_back( tower_geom->get_eta() );
+	    _pflow_HAD_tower_phi.push_back( tower_geom->get_phi() );
+	    _pflow_HAD_tower_eta.push_back( tower_geom->get_eta() );
+	    _pflow_HAD_tower_cluster.push_back( this_cluster );
 	  }
 
 	  else if ( RawTowerDefs::decode_caloid( iter->first ) == RawTowerDefs::CalorimeterId::HCALOUT ) {
 
 	    RawTowerGeom *tower_geom = geomOH->get_tower_geometry(iter->first);
 
-	    this_cluster_tower_phi.push_back( tower_geom->get_phi() );
-	    this_cluster_tower_eta.push_back( tower_geom->get_eta() );
+	    _pflow_HAD_tower_phi.push_back( tower_geom->get_phi() );
+	    _pflow_HAD_tower_eta.push_back( tower_geom->get_eta() );
+	    _pflow_HAD_tower_cluster.push_back( this_cluster );
 	  } else {
 	    std::cout << "ParticleFlowReco::process_event : FATAL ERROR , HCal topoClusters seem to contain EM towers" << std::endl;
 	    return Fun4AllReturnCodes::ABORTEVENT;
@@ -339,13 +352,14 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 
 	} // close tower loop
 
-	_pflow_HAD_tower_eta.push_back( this_cluster_tower_eta );
-	_pflow_HAD_tower_phi.push_back( this_cluster_tower_phi );
-
       } // close cluster loop
 
   } // close
 
+  // index the cluster towers for the overlap boxes below
+  _pflow_EM_tower_grid.build( _pflow_EM_tower_eta, _pflow_EM_tower_phi, 0.025 * 2.5 );
+  _pflow_HAD_tower_grid.build( _pflow_HAD_tower_eta, _pflow_HAD_tower_phi, 0.1 * 1.5 );
+
   // BEGIN LINKING STEP
 
   // Link TRK -> EM (best match, but keep reserve of others), and TRK -> HAD (best match)
@@ -361,44 +375,19 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     float min_em_dR = 0.2;
     int min_em_index = -1;
 
-    for (unsigned int em = 0 ; em < _pflow_EM_E.size() ; em++) {
+    // only EMs with a tower overlapping the track projection
+    find_candidates( _pflow_EM_tower_grid, _pflow_EM_tower_cluster, _pflow_TRK_EMproj_eta[ trk ], _pflow_TRK_EMproj_phi[ trk ], 0.025 * 2.5 );
+
+    for ( int em : _pflow_candidates ) {
 
       float dR = calculate_dR( _pflow_TRK_EMproj_eta[ trk ] , _pflow_EM_eta[ em ] , _pflow_TRK_EMproj_phi[ trk ] , _pflow_EM_phi[ em ] );
 
       if ( dR > 0.2 ) continue;
 
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_EM_tower_eta.at( em ).size() ; tow++) {
-
-	float tower_eta =  _pflow_EM_tower_eta.at( em ).at( tow );
-	float tower_phi =  _pflow_EM_tower_phi.at( em ).at( tow );
-
-	float deta = tower_eta - _pflow_TRK_EMproj_eta[ trk ];
-	float dphi = tower_phi - _pflow_TRK_EMproj_phi[ trk ];
-	if ( dphi > M_PI ) dphi -= 2 * M_PI;
-	if ( dphi < -M_PI ) dphi += 2 * M_PI;
-
-	if ( fabs( deta ) < 0.025 * 2.5 && fabs( dphi ) < 0.025 * 2.5 ) {
-	  has_overlap = true;
-	  break;
-	}
-
-      }
-
-      if ( has_overlap ) {
-
-	if ( Verbosity() > 5 )
-	  std::cout << " -> possible match to EM " << em << " with dR = " << dR << std::endl;
-
-	_pflow_TRK_addtl_match_EM.at( trk ).push_back( std::pair<int,float>( em, dR ) );
-
-      } else {
-
-	if ( Verbosity() > 5 )
-	  std::cout << " -> no match to EM " << em << " (even though dR = " << dR << " )" << std::endl;
+      if ( Verbosity() > 5 )
+	std::cout << " -> possible match to EM " << em << " with dR = " << dR << std::endl;
 
-      }
+      _pflow_TRK_addtl_match_EM.at( trk ).push_back( std::pair<int,float>( em, dR ) );
 
     }
 
@@ -440,47 +429,21 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     float max_had_pt = 0;
 
     // TODO: sequential linking should better happen here -- i.e. allow EM-matched HAD's into the possible pool
-    for (unsigned int had = 0 ; had < _pflow_HAD_E.size() ; had++) {
+    find_candidates( _pflow_HAD_tower_grid, _pflow_HAD_tower_cluster, _pflow_TRK_HADproj_eta[ trk ], _pflow_TRK_HADproj_phi[ trk ], 0.1 * 1.5 );
+
+    for ( int had : _pflow_candidates ) {
 
       float dR = calculate_dR( _pflow_TRK_HADproj_eta[ trk ] , _pflow_HAD_eta[ had ] , _pflow_TRK_HADproj_phi[ trk ] , _pflow_HAD_phi[ had ] );
 
       if ( dR > 0.5 ) continue;
 
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at( had ).size() ; tow++) {
-
-	float tower_eta =  _pflow_HAD_tower_eta.at( had ).at( tow );
-	float tower_phi =  _pflow_HAD_tower_phi.at( had ).at( tow );
-
-	float deta = tower_eta - _pflow_TRK_HADproj_eta[ trk ];
-	float dphi = tower_phi - _pflow_TRK_HADproj_phi[ trk ];
-	if ( dphi > M_PI ) dphi -= 2 * M_PI;
-	if ( dphi < -M_PI ) dphi += 2 * M_PI;
-
-	if ( fabs( deta ) < 0.1 * 1.5 && fabs( dphi ) < 0.1 * 1.5 ) {
-	  has_overlap = true;
-	  break;
-	}
-
-      }
-
-      if ( has_overlap ) {
-
-	if ( Verbosity() > 5 )
-	  std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
-
-	if ( _pflow_HAD_E.at( had ) > max_had_pt ) {
-	  max_had_pt = _pflow_HAD_E.at( had );
-	  min_had_index = had;
-	  min_had_dR = dR;
-	}
-
-      } else {
-
-	if ( Verbosity() > 5 )
-	  std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
+      if ( Verbosity() > 5 )
+	std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
 
+      if ( _pflow_HAD_E.at( had ) > max_had_pt ) {
+	max_had_pt = _pflow_HAD_E.at( had );
+	min_had_index = had;
+	min_had_dR = dR;
       }
 
     }
@@ -515,46 +478,20 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     int min_had_index = -1;
     float max_had_pt = 0;
 
-    for (unsigned int had = 0 ; had < _pflow_HAD_E.size() ; had++) {
+    find_candidates( _pflow_HAD_tower_grid, _pflow_HAD_tower_cluster, _pflow_EM_eta[ em ], _pflow_EM_phi[ em ], 0.1 * 1.5 );
+
+    for ( int had : _pflow_candidates ) {
 
       float dR = calculate_dR( _pflow_EM_eta[ em ] , _pflow_HAD_eta[ had ] , _pflow_EM_phi[ em ] , _pflow_HAD_phi[ had ] );
       if ( dR > 0.5 ) continue;
 
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at( had ).size() ; tow++) {
-
-	float tower_eta =  _pflow_HAD_tower_eta.at( had ).at( tow );
-	float tower_phi =  _pflow_HAD_tower_phi.at( had ).at( tow );
-
-	float deta = tower_eta - _pflow_EM_eta[ em ];
-	float dphi = tower_phi - _pflow_EM_phi[ em ];
-	if ( dphi > M_PI ) dphi -= 2 * M_PI;
-	if ( dphi < -M_PI ) dphi += 2 * M_PI;
-
-	if ( fabs( deta ) < 0.1 * 1.5 && fabs( dphi ) < 0.1 * 1.5 ) {
-	  has_overlap = true;
-	  break;
-	}
-
-      }
-
-      if ( has_overlap ) {
-
-	if ( Verbosity() > 5 )
-	  std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
-
-	if ( _pflow_HAD_E.at( had ) > max_had_pt ) {
-	  max_had_pt = _pflow_HAD_E.at( had );
-	  min_had_index = had;
-	  min_had_dR = dR;
-	}
-
-      } else {
-
-	if ( Verbosity() > 5 )
-	  std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
+      if ( Verbosity() > 5 )
+	std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
 
+      if ( _pflow_HAD_E.at( had ) > max_had_pt ) {
+	max_had_pt = _pflow_HAD_E.at( had );
+	min_had_index = had;
+	min_had_dR = dR;
       }
 
     }
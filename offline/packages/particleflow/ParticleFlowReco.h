@@ -7,6 +7,8 @@
 /// \author Dennis V. Perepelitsa
 //===========================================================
 
+#include "ParticleFlowTowerGrid.h"
+
 #include <fun4all/SubsysReco.h>
 
 #include <gsl/gsl_rng.h>
@@ -76,8 +78,10 @@ class ParticleFlowReco : public SubsysReco
   std::vector<float> _pflow_EM_eta;
   std::vector<float> _pflow_EM_phi;
   std::vector<RawCluster*> _pflow_EM_cluster;
-  std::vector< std::vector<float> > _pflow_EM_tower_eta;
-  std::vector< std::vector<float> > _pflow_EM_tower_phi;
+  // towers of all EM clusters, flat, with the index of their cluster
+  std::vector<float> _pflow_EM_tower_eta;
+  std::vector<float> _pflow_EM_tower_phi;
+  std::vector<int> _pflow_EM_tower_cluster;
   std::vector< std::vector<int> > _pflow_EM_match_HAD;
   std::vector< std::vector<int> > _pflow_EM_match_TRK;
 
@@ -85,11 +89,19 @@ class ParticleFlowReco : public SubsysReco
   std::vector<float> _pflow_HAD_eta;
   std::vector<float> _pflow_HAD_phi;
   std::vector<RawCluster*> _pflow_HAD_cluster;
-  std::vector< std::vector<float> > _pflow_HAD_tower_eta;
-  std::vector< std::vector<float> > _pflow_HAD_tower_phi;
+  std::vector<float> _pflow_HAD_tower_eta;
+  std::vector<float> _pflow_HAD_tower_phi;
+  std::vector<int> _pflow_HAD_tower_cluster;
   std::vector< std::vector<int> > _pflow_HAD_match_EM;
   std::vector< std::vector<int> > _pflow_HAD_match_TRK;
 
+  // spatial index of the cluster towers, and the clusters with a tower
+  // in the box around a track or cluster, in increasing index order
+  ParticleFlowTowerGrid _pflow_EM_tower_grid;
+  ParticleFlowTowerGrid _pflow_HAD_tower_grid;
+  std::vector<int> _pflow_candidates;
+  void find_candidates( const ParticleFlowTowerGrid &grid, const std::vector<int> &tower_cluster, float eta, float phi, double half_width );
+
   std::string _track_map_name = "SvtxTrackMap";
 
 };
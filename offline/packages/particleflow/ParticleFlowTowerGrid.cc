@@ -0,0 +1,48 @@
+#include "ParticleFlowTowerGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+int ParticleFlowTowerGrid::phi_bin( float phi ) const
+{
+  int iphi = static_cast<int>( std::floor( ( phi + M_PI ) / ( 2 * M_PI ) * _nphi ) );
+  return std::clamp( iphi, 0, _nphi - 1 );
+}
+
+void ParticleFlowTowerGrid::build( const std::vector<float> &eta, const std::vector<float> &phi, double max_half_width )
+{
+  _eta = &eta;
+  _phi = &phi;
+  // a bit larger than the box, so rounding never puts a tower in the box two cells away
+  _cell_size = 1.01 * max_half_width;
+
+  unsigned int ntowers = eta.size();
+
+  float eta_max = 0;
+  _eta_min = 0;
+  for ( unsigned int tow = 0; tow < ntowers; tow++ ) {
+    _eta_min = std::min( _eta_min, eta[ tow ] );
+    eta_max = std::max( eta_max, eta[ tow ] );
+  }
+
+  // phi cells are at least cell_size wide
+  _neta = static_cast<int>( ( eta_max - _eta_min ) / _cell_size ) + 1;
+  _nphi = std::max( 1, static_cast<int>( 2 * M_PI / _cell_size ) );
+
+  // counting sort of the towers into the cells
+  _tower_cell.resize( ntowers );
+  _cell_offset.assign( _neta * _nphi + 1, 0 );
+  for ( unsigned int tow = 0; tow < ntowers; tow++ ) {
+    int ieta = std::min( eta_bin( eta[ tow ] ), _neta - 1 );
+    _tower_cell[ tow ] = ieta * _nphi + phi_bin( phi[ tow ] );
+    _cell_offset[ _tower_cell[ tow ] + 1 ]++;
+  }
+  for ( unsigned int icell = 1; icell < _cell_offset.size(); icell++ ) {
+    _cell_offset[ icell ] += _cell_offset[ icell - 1 ];
+  }
+  _cell_tower.resize( ntowers );
+  std::vector<unsigned int> fill( _cell_offset.begin(), _cell_offset.end() - 1 );
+  for ( unsigned int tow = 0; tow < ntowers; tow++ ) {
+    _cell_tower[ fill[ _tower_cell[ tow ] ]++ ] = tow;
+  }
+}
@@ -0,0 +1,92 @@
+#ifndef PARTICLEFLOWTOWERGRID_H
+#define PARTICLEFLOWTOWERGRID_H
+
+//===========================================================
+/// \file ParticleFlowTowerGrid.h
+/// \brief eta-phi binned index of cluster towers for particle flow linking
+//===========================================================
+
+#include <cmath>
+#include <vector>
+
+/// \class ParticleFlowTowerGrid
+///
+/// \brief eta-phi binned index of cluster towers for particle flow linking
+///
+/// The towers of all clusters of one calorimeter are sorted into eta x phi
+/// cells of a fixed size. A box query with a half width up to the cell size
+/// only has to look at the 3 x 3 cells around the query point, so linking a
+/// track or cluster costs the local tower occupancy instead of a loop over
+/// every tower of every cluster.
+///
+class ParticleFlowTowerGrid
+{
+ public:
+  ParticleFlowTowerGrid() = default;
+  ~ParticleFlowTowerGrid() = default;
+
+  //! index the towers (flat eta / phi arrays) for box queries up to max_half_width
+  void build( const std::vector<float> &eta, const std::vector<float> &phi, double max_half_width );
+
+  //! calls f( tower ) for every tower with |deta| < half_width and
+  //! |dphi| < half_width of ( eta, phi ); half_width <= max_half_width
+  template <class F>
+  void for_each_in_box( float eta, float phi, double half_width, F f ) const;
+
+ private:
+  int eta_bin( float eta ) const { return static_cast<int>( std::floor( ( eta - _eta_min ) / _cell_size ) ); }
+  int phi_bin( float phi ) const;
+
+  float _cell_size{ 1 };
+  float _eta_min{ 0 };
+  int _neta{ 0 };
+  int _nphi{ 0 };
+
+  const std::vector<float> *_eta{ nullptr };
+  const std::vector<float> *_phi{ nullptr };
+
+  // towers of cell i are _cell_tower[ _cell_offset[ i ] .. _cell_offset[ i + 1 ] )
+  std::vector<unsigned int> _cell_offset;
+  std::vector<unsigned int> _cell_tower;
+  std::vector<int> _tower_cell;
+};
+
+template <class F>
+void ParticleFlowTowerGrid::for_each_in_box( float eta, float phi, double half_width, F f ) const
+{
+  if ( _neta <= 0 ) return;
+
+  int ieta_center = eta_bin( eta );
+  int iphi_center = phi_bin( phi );
+
+  // with fewer than 3 phi cells every cell is visited once
+  int iphi_lo = ( _nphi < 3 ? 0 : iphi_center - 1 );
+  int iphi_hi = ( _nphi < 3 ? _nphi - 1 : iphi_center + 1 );
+
+  for ( int ieta = ieta_center - 1; ieta <= ieta_center + 1; ieta++ ) {
+
+    if ( ieta < 0 || ieta >= _neta ) continue;
+
+    for ( int jphi = iphi_lo; jphi <= iphi_hi; jphi++ ) {
+
+      int icell = ieta * _nphi + ( jphi + _nphi ) % _nphi;
+
+      for ( unsigned int i = _cell_offset[ icell ]; i < _cell_offset[ icell + 1 ]; i++ ) {
+
+	unsigned int tow = _cell_tower[ i ];
+
+	float deta = ( *_eta )[ tow ] - eta;
+	float dphi = ( *_phi )[ tow ] - phi;
+	if ( dphi > M_PI ) dphi -= 2 * M_PI;
+	if ( dphi < -M_PI ) dphi += 2 * M_PI;
+
+	if ( std::fabs( deta ) < half_width && std::fabs( dphi ) < half_width ) {
+	  f( tow );
+	}
+
+      }
+    }
+  }
+}
+
+#endif // PARTICLEFLOWTOWERGRID_H
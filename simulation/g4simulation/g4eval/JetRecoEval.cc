@@ -23,14 +23,19 @@
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cfloat>
 #include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 JetRecoEval::JetRecoEval(PHCompositeNode* topNode,
                          const std::string& recojetname,
@@ -65,6 +70,8 @@ void JetRecoEval::next_event(PHCompositeNode* topNode)
   _cache_get_energy_contribution_src.clear();
   _cache_all_truth_hits.clear();
 
+  _matching_filled = false;
+
   _jettrutheval.next_event(topNode);
 
   get_node_pointers(topNode);
@@ -750,6 +757,17 @@ std::set<Jet*> JetRecoEval::all_truth_jets(Jet* recojet)
     return std::set<Jet*>();
   }
 
+  int ireco = get_reco_matching_index(recojet);
+  if (ireco >= 0)
+  {
+    std::set<Jet*> truth_jets;
+    for (unsigned int i = _matching_reco_offset[ireco]; i < _matching_reco_offset[ireco + 1]; ++i)
+    {
+      truth_jets.insert(_matching_truthjets[_matching_truth[i]]);
+    }
+    return truth_jets;
+  }
+
   if (_do_cache)
   {
     std::map<Jet*, std::set<Jet*> >::iterator iter =
@@ -807,6 +825,22 @@ Jet* JetRecoEval::max_truth_jet_by_energy(Jet* recojet)
     return nullptr;
   }
 
+  int ireco = get_reco_matching_index(recojet);
+  if (ireco >= 0)
+  {
+    Jet* truthjet = nullptr;
+    float max_energy = FLT_MAX * -1.0;
+    for (unsigned int i = _matching_reco_offset[ireco]; i < _matching_reco_offset[ireco + 1]; ++i)
+    {
+      if (_matching_truth_energy[i] > max_energy)
+      {
+        truthjet = _matching_truthjets[_matching_truth[i]];
+        max_energy = _matching_truth_energy[i];
+      }
+    }
+    return truthjet;
+  }
+
   if (_do_cache)
   {
     std::map<Jet*, Jet*>::iterator iter =
@@ -861,6 +895,17 @@ std::set<Jet*> JetRecoEval::all_jets_from(Jet* truthjet)
     return std::set<Jet*>();
   }
 
+  int itruth = get_truth_matching_index(truthjet);
+  if (itruth >= 0)
+  {
+    std::set<Jet*> recojets;
+    for (unsigned int i = _matching_truth_offset[itruth]; i < _matching_truth_offset[itruth + 1]; ++i)
+    {
+      recojets.insert(_matching_recojets[_matching_reco[i]]);
+    }
+    return recojets;
+  }
+
   if (_do_cache)
   {
     std::map<Jet*, std::set<Jet*> >::iterator iter =
@@ -920,6 +965,22 @@ Jet* JetRecoEval::best_jet_from(Jet* truthjet)
     return nullptr;
   }
 
+  int itruth = get_truth_matching_index(truthjet);
+  if (itruth >= 0)
+  {
+    Jet* bestrecojet = nullptr;
+    float max_energy = FLT_MAX * -1.0;
+    for (unsigned int i = _matching_truth_offset[itruth]; i < _matching_truth_offset[itruth + 1]; ++i)
+    {
+      if (_matching_reco_energy[i] > max_energy)
+      {
+        bestrecojet = _matching_recojets[_matching_reco[i]];
+        max_energy = _matching_reco_energy[i];
+      }
+    }
+    return bestrecojet;
+  }
+
   if (_do_cache)
   {
     std::map<Jet*, Jet*>::iterator iter =
@@ -1041,6 +1102,20 @@ float JetRecoEval::get_energy_contribution(Jet* recojet, Jet* truthjet)
     return NAN;
   }
 
+  int ireco = get_reco_matching_index(recojet);
+  int itruth = get_truth_matching_index(truthjet);
+  if (ireco >= 0 && itruth >= 0)
+  {
+    for (unsigned int i = _matching_reco_offset[ireco]; i < _matching_reco_offset[ireco + 1]; ++i)
+    {
+      if (_matching_truth[i] == static_cast<unsigned int>(itruth))
+      {
+        return _matching_truth_energy[i];
+      }
+    }
+    return 0.0;
+  }
+
   if (_do_cache)
   {
     std::map<std::pair<Jet*, Jet*>, float>::iterator iter =
@@ -1882,6 +1957,331 @@ std::set<PHG4Hit*> JetRecoEval::all_truth_hits(Jet* recojet)
   return truth_hits;
 }
 
+int JetRecoEval::get_reco_matching_index(Jet* recojet)
+{
+  if (!_do_flat_matching)
+  {
+    return -1;
+  }
+
+  fill_matching();
+
+  std::unordered_map<Jet*, unsigned int>::iterator iter = _matching_reco_index.find(recojet);
+  if (iter == _matching_reco_index.end())
+  {
+    return -1;
+  }
+  return iter->second;
+}
+
+int JetRecoEval::get_truth_matching_index(Jet* truthjet)
+{
+  if (!_do_flat_matching)
+  {
+    return -1;
+  }
+
+  fill_matching();
+
+  std::unordered_map<Jet*, unsigned int>::iterator iter = _matching_truth_index.find(truthjet);
+  if (iter == _matching_truth_index.end())
+  {
+    return -1;
+  }
+  return iter->second;
+}
+
+void JetRecoEval::fill_matching()
+{
+  if (_matching_filled)
+  {
+    return;
+  }
+  _matching_filled = true;
+
+  // backtrack truth particles (by track id) to the first truth jet that
+  // contains them, same as JetTruthEval::get_truth_jet() but in one pass
+  std::unordered_map<int, Jet*> truthjet_of_particle;
+  _matching_truthjets.clear();
+  for (auto truthjet : *_truthjets)
+  {
+    _matching_truthjets.push_back(truthjet);
+    for (auto particle : get_truth_eval()->all_truth_particles(truthjet))
+    {
+      truthjet_of_particle.emplace(particle->get_track_id(), truthjet);
+    }
+  }
+
+  _matching_recojets.clear();
+  for (auto recojet : *_recojets)
+  {
+    _matching_recojets.push_back(recojet);
+  }
+
+  // the jets are indexed in address order, so that rows and columns are
+  // visited in the same order as the std::set<Jet*> of the per jet queries
+  // and ties in the energy are resolved the same way
+  std::sort(_matching_truthjets.begin(), _matching_truthjets.end(), std::less<Jet*>());
+  std::sort(_matching_recojets.begin(), _matching_recojets.end(), std::less<Jet*>());
+
+  unsigned int nreco = _matching_recojets.size();
+  unsigned int ntruth = _matching_truthjets.size();
+
+  _matching_truth_index.clear();
+  for (unsigned int itruth = 0; itruth < ntruth; ++itruth)
+  {
+    _matching_truth_index.emplace(_matching_truthjets[itruth], itruth);
+  }
+  _matching_reco_index.clear();
+  for (unsigned int ireco = 0; ireco < nreco; ++ireco)
+  {
+    _matching_reco_index.emplace(_matching_recojets[ireco], ireco);
+  }
+
+  // rows: every constituent of every reco jet is backtracked once
+  std::vector<float> row_energy(ntruth, 0);
+  std::vector<bool> in_row(ntruth, false);
+  std::vector<unsigned int> row;
+  std::vector<std::pair<PHG4Particle*, float> > contributions;
+
+  _matching_reco_offset.assign(1, 0);
+  _matching_truth.clear();
+  _matching_truth_energy.clear();
+  for (auto recojet : _matching_recojets)
+  {
+    row.clear();
+    for (const auto& jter : recojet->get_comp_vec())
+    {
+      contributions.clear();
+      get_constituent_contributions(jter.first, jter.second, contributions);
+
+      for (const auto& contribution : contributions)
+      {
+        if (_strict)
+        {
+          assert(contribution.first);
+        }
+        else if (!contribution.first)
+        {
+          ++_errors;
+          continue;
+        }
+
+        std::unordered_map<int, Jet*>::iterator iter = truthjet_of_particle.find(contribution.first->get_track_id());
+        if (iter == truthjet_of_particle.end())
+        {
+          continue;
+        }
+
+        unsigned int itruth = _matching_truth_index[iter->second];
+        if (!in_row[itruth])
+        {
+          in_row[itruth] = true;
+          row.push_back(itruth);
+        }
+        row_energy[itruth] += contribution.second;
+      }
+    }
+
+    std::sort(row.begin(), row.end());
+    for (unsigned int itruth : row)
+    {
+      _matching_truth.push_back(itruth);
+      _matching_truth_energy.push_back(row_energy[itruth]);
+      row_energy[itruth] = 0;
+      in_row[itruth] = false;
+    }
+    _matching_reco_offset.push_back(_matching_truth.size());
+  }
+
+  // columns: counting sort of the row entries by truth jet
+  _matching_truth_offset.assign(ntruth + 1, 0);
+  for (unsigned int itruth : _matching_truth)
+  {
+    ++_matching_truth_offset[itruth + 1];
+  }
+  for (unsigned int itruth = 0; itruth < ntruth; ++itruth)
+  {
+    _matching_truth_offset[itruth + 1] += _matching_truth_offset[itruth];
+  }
+
+  _matching_reco.resize(_matching_truth.size());
+  _matching_reco_energy.resize(_matching_truth.size());
+  std::vector<unsigned int> fill(_matching_truth_offset.begin(), _matching_truth_offset.end() - 1);
+  for (unsigned int ireco = 0; ireco < nreco; ++ireco)
+  {
+    for (unsigned int i = _matching_reco_offset[ireco]; i < _matching_reco_offset[ireco + 1]; ++i)
+    {
+      unsigned int k = fill[_matching_truth[i]]++;
+      _matching_reco[k] = ireco;
+      _matching_reco_energy[k] = _matching_truth_energy[i];
+    }
+  }
+
+  if (_verbosity > 1)
+  {
+    std::cout << "JetRecoEval::fill_matching() - " << nreco << " reco jets x " << ntruth
+              << " truth jets, " << _matching_truth.size() << " non-empty entries" << std::endl;
+  }
+}
+
+void JetRecoEval::get_constituent_contributions(Jet::SRC source, unsigned int index,
+                                                std::vector<std::pair<PHG4Particle*, float> >& contributions)
+{
+  if (source == Jet::TRACK)
+  {
+    if (!_trackmap)
+    {
+      std::cout << PHWHERE << "ERROR: can't find TrackMap" << std::endl;
+      exit(-1);
+    }
+
+    SvtxTrack* track = _trackmap->get(index);
+
+    if (_strict)
+    {
+      assert(track);
+    }
+    else if (!track)
+    {
+      ++_errors;
+      return;
+    }
+
+    // the track momentum goes to the truth particle with the most clusters,
+    // the other truth particles on the track contribute nothing
+    PHG4Particle* maxtruthparticle = get_svtx_eval_stack()->get_track_eval()->max_truth_particle_by_nclusters(track);
+    for (auto particle : get_svtx_eval_stack()->get_track_eval()->all_truth_particles(track))
+    {
+      float energy = 0.0;
+      if (maxtruthparticle && particle && maxtruthparticle->get_track_id() == particle->get_track_id())
+      {
+        energy = track->get_p();
+      }
+      contributions.emplace_back(particle, energy);
+    }
+    return;
+  }
+
+  RawTowerContainer* towers = nullptr;
+  RawClusterContainer* clusters = nullptr;
+  CaloEvalStack* evalstack = nullptr;
+  std::string nodename;
+  switch (source)
+  {
+  case Jet::CEMC_TOWER:
+    towers = _cemctowers;
+    evalstack = get_cemc_eval_stack();
+    nodename = "TOWER_CEMC";
+    break;
+  case Jet::CEMC_CLUSTER:
+    clusters = _cemcclusters;
+    evalstack = get_cemc_eval_stack();
+    nodename = "CLUSTER_CEMC";
+    break;
+  case Jet::EEMC_TOWER:
+    towers = _eemctowers;
+    evalstack = get_eemc_eval_stack();
+    nodename = "TOWER_EEMC";
+    break;
+  case Jet::EEMC_CLUSTER:
+    clusters = _eemcclusters;
+    evalstack = get_eemc_eval_stack();
+    nodename = "CLUSTER_EEMC";
+    break;
+  case Jet::HCALIN_TOWER:
+    towers = _hcalintowers;
+    evalstack = get_hcalin_eval_stack();
+    nodename = "TOWER_HCALIN";
+    break;
+  case Jet::HCALIN_CLUSTER:
+    clusters = _hcalinclusters;
+    evalstack = get_hcalin_eval_stack();
+    nodename = "CLUSTER_HCALIN";
+    break;
+  case Jet::HCALOUT_TOWER:
+    towers = _hcalouttowers;
+    evalstack = get_hcalout_eval_stack();
+    nodename = "TOWER_HCALOUT";
+    break;
+  case Jet::HCALOUT_CLUSTER:
+    clusters = _hcaloutclusters;
+    evalstack = get_hcalout_eval_stack();
+    nodename = "CLUSTER_HCALOUT";
+    break;
+  case Jet::FEMC_TOWER:
+    towers = _femctowers;
+    evalstack = get_femc_eval_stack();
+    nodename = "TOWER_FEMC";
+    break;
+  case Jet::FEMC_CLUSTER:
+    clusters = _femcclusters;
+    evalstack = get_femc_eval_stack();
+    nodename = "CLUSTER_FEMC";
+    break;
+  case Jet::FHCAL_TOWER:
+    towers = _fhcaltowers;
+    evalstack = get_fhcal_eval_stack();
+    nodename = "TOWER_FHCAL";
+    break;
+  case Jet::FHCAL_CLUSTER:
+    clusters = _fhcalclusters;
+    evalstack = get_fhcal_eval_stack();
+    nodename = "CLUSTER_FHCAL";
+    break;
+  default:
+    // no truth backtracking for the other sources
+    return;
+  }
+
+  if (!towers && !clusters)
+  {
+    std::cout << PHWHERE << "ERROR: can't find " << nodename << std::endl;
+    exit(-1);
+  }
+
+  if (towers)
+  {
+    RawTower* tower = towers->getTower(index);
+
+    if (_strict)
+    {
+      assert(tower);
+    }
+    else if (!tower)
+    {
+      ++_errors;
+      return;
+    }
+
+    CaloRawTowerEval* towereval = evalstack->get_rawtower_eval();
+    for (auto particle : towereval->all_truth_primary_particles(tower))
+    {
+      contributions.emplace_back(particle, towereval->get_energy_contribution(tower, particle));
+    }
+  }
+  else
+  {
+    RawCluster* cluster = clusters->getCluster(index);
+
+    if (_strict)
+    {
+      assert(cluster);
+    }
+    else if (!cluster)
+    {
+      ++_errors;
+      return;
+    }
+
+    CaloRawClusterEval* clustereval = evalstack->get_rawcluster_eval();
+    for (auto particle : clustereval->all_truth_primary_particles(cluster))
+    {
+      contributions.emplace_back(particle, clustereval->get_energy_contribution(cluster, particle));
+    }
+  }
+}
+
 void JetRecoEval::get_node_pointers(PHCompositeNode* topNode)
 {
   // need things off of the DST...
@@ -8,7 +8,9 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 class CaloEvalStack;
 
@@ -46,6 +48,12 @@ class JetRecoEval
     _jettrutheval.do_caching(do_cache);
   }
 
+  /// answer the reco <-> truth jet matching queries (all_truth_jets,
+  /// max_truth_jet_by_energy, all_jets_from, best_jet_from and
+  /// get_energy_contribution(recojet, truthjet)) from a reco jet x truth jet
+  /// energy matrix, filled once per event on the first query
+  void do_flat_matching(bool do_flat) { _do_flat_matching = do_flat; }
+
   /// strict mode will assert when an error is detected
   /// non-strict mode will notice and report at the End()
   void set_strict(bool strict)
@@ -131,6 +139,17 @@ class JetRecoEval
  private:
   void get_node_pointers(PHCompositeNode* topNode);
 
+  /// energy contributed by each truth primary to one reco jet constituent
+  void get_constituent_contributions(Jet::SRC source, unsigned int index,
+                                     std::vector<std::pair<PHG4Particle*, float> >& contributions);
+
+  /// fill the reco jet x truth jet energy matrix of this event
+  void fill_matching();
+
+  /// index of the jet in the matching matrix, -1 if not matched through it
+  int get_reco_matching_index(Jet* recojet);
+  int get_truth_matching_index(Jet* truthjet);
+
   JetTruthEval _jettrutheval;
   std::string _recojetname;
   std::string _truthjetname;
@@ -167,6 +186,24 @@ class JetRecoEval
   std::map<std::pair<Jet*, Jet::SRC>, float> _cache_get_energy_contribution_src;  /// used in get_energy_contribution (Jet* recojet, Jet::SRC src);
   std::map<Jet*, std::set<PHG4Hit*> > _cache_all_truth_hits;
   std::string m_TrackNodeName = "SvtxTrackMap";
+
+  bool _do_flat_matching = true;
+  bool _matching_filled = false;
+  std::vector<Jet*> _matching_recojets;
+  std::vector<Jet*> _matching_truthjets;
+  std::unordered_map<Jet*, unsigned int> _matching_reco_index;
+  std::unordered_map<Jet*, unsigned int> _matching_truth_index;
+  // sparse energy matrix, by row: truth jets contributing to reco jet i are
+  // _matching_truth[_matching_reco_offset[i] .. _matching_reco_offset[i+1])
+  // with energy _matching_truth_energy[...] (zero for truth jets that only
+  // backtrack to the reco jet without an energy contribution)
+  std::vector<unsigned int> _matching_reco_offset;
+  std::vector<unsigned int> _matching_truth;
+  std::vector<float> _matching_truth_energy;
+  // same matrix by column: reco jets with contributions from truth jet j
+  std::vector<unsigned int> _matching_truth_offset;
+  std::vector<unsigned int> _matching_reco;
+  std::vector<float> _matching_reco_energy;
 };
 
 #endif  // G4EVAL_JETRECOEVAL_H
@@ -1,6 +1,7 @@
 
 #include "TruthJetInput.h"
 
+#include "TruthJetParticles.h"
 
 #include <g4main/PHG4Particle.h>
 #include <g4main/PHG4TruthInfoContainer.h>
@@ -25,6 +26,11 @@ TruthJetInput::TruthJetInput(Jet::SRC input)
 
 void TruthJetInput::identify(std::ostream &os)
 {
+  if (!m_ParticleNode.empty())
+  {
+    os << "   TruthJetInput: " << m_ParticleNode << " to Jet::PARTICLE" << std::endl;
+    return;
+  }
   os << "   TruthJetInput: G4TruthInfo to Jet::PARTICLE";
   if (use_embed_stream())
   {
@@ -38,18 +44,60 @@ void TruthJetInput::identify(std::ostream &os)
 }
 
 std::vector<Jet *> TruthJetInput::get_input(PHCompositeNode *topNode)
+{
+  std::vector<JetInputParticle> particles;
+  get_input_particles(topNode, particles);
+
+  std::vector<Jet *> pseudojets;
+  pseudojets.reserve(particles.size());
+  for (auto &particle : particles)
+  {
+    Jet *jet = new Jetv2();
+    jet->set_px(particle.px);
+    jet->set_py(particle.py);
+    jet->set_pz(particle.pz);
+    jet->set_e(particle.e);
+    jet->insert_comp(particle.src, particle.index);
+    pseudojets.push_back(jet);
+  }
+  return pseudojets;
+}
+
+void TruthJetInput::get_input_particles(PHCompositeNode *topNode, std::vector<JetInputParticle> &particles)
 {
   if (Verbosity() > 0) std::cout << "TruthJetInput::process_event -- entered" << std::endl;
 
-  // Pull the reconstructed track information off the node tree...
-  PHG4TruthInfoContainer *truthinfo = findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
-  if (!truthinfo)
+  if (!m_ParticleNode.empty())
   {
-    std::cout << PHWHERE << " ERROR: Can't find G4TruthInfo" << std::endl;
-    return std::vector<Jet *>();
+    TruthJetParticles *selected = findNode::getClass<TruthJetParticles>(topNode, m_ParticleNode);
+    if (!selected)
+    {
+      std::cout << PHWHERE << " ERROR: Can't find " << m_ParticleNode << std::endl;
+      return;
+    }
+    particles.insert(particles.end(), selected->get_particles().begin(), selected->get_particles().end());
   }
+  else
+  {
+    // Pull the reconstructed track information off the node tree...
+    PHG4TruthInfoContainer *truthinfo = findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
+    if (!truthinfo)
+    {
+      std::cout << PHWHERE << " ERROR: Can't find G4TruthInfo" << std::endl;
+      return;
+    }
 
-  std::vector<Jet *> pseudojets;
+    select_particles(truthinfo, m_EmbedID, m_EtaMin, m_EtaMax, particles);
+  }
+
+  if (Verbosity() > 0) std::cout << "TruthJetInput::process_event -- exited" << std::endl;
+}
+
+void TruthJetInput::select_particles(PHG4TruthInfoContainer *truthinfo,
+                                     const std::vector<int> &embed_ids,
+                                     float eta_min, float eta_max,
+                                     std::vector<JetInputParticle> &particles)
+{
   PHG4TruthInfoContainer::ConstRange range = truthinfo->GetPrimaryParticleRange();
   for (PHG4TruthInfoContainer::ConstIterator iter = range.first;
        iter != range.second;
@@ -57,11 +105,11 @@ std::vector<Jet *> TruthJetInput::get_input(PHCompositeNode *topNode)
   {
     PHG4Particle *part = iter->second;
 
-    if (use_embed_stream())
+    if (!embed_ids.empty())
     {
       const int this_embed_id = truthinfo->isEmbeded(part->get_track_id());
 
-      if (std::find(m_EmbedID.begin(), m_EmbedID.end(), this_embed_id) == m_EmbedID.end())
+      if (std::find(embed_ids.begin(), embed_ids.end(), this_embed_id) == embed_ids.end())
       {
         continue;  // reject particle as it is not in the interested embedding stream.
       }
@@ -76,21 +124,21 @@ std::vector<Jet *> TruthJetInput::get_input(PHCompositeNode *topNode)
     if ((abs(part->get_pid()) >= 12) && (abs(part->get_pid()) <= 16)) continue;
 
     // remove acceptance... _etamin,_etamax
-    if ((part->get_px() == 0.0) && (part->get_py() == 0.0)) continue;  // avoid pt=0
-    float eta = asinh(part->get_pz() / sqrt(pow(part->get_px(), 2) + pow(part->get_py(), 2)));
-    if (eta < m_EtaMin) continue;
-    if (eta > m_EtaMax) continue;
-
-    Jet *jet = new Jetv2();
-    jet->set_px(part->get_px());
-    jet->set_py(part->get_py());
-    jet->set_pz(part->get_pz());
-    jet->set_e(part->get_e());
-    jet->insert_comp(Jet::PARTICLE, part->get_track_id());
-    pseudojets.push_back(jet);
+    double px = part->get_px();
+    double py = part->get_py();
+    double pz = part->get_pz();
+    if ((px == 0.0) && (py == 0.0)) continue;  // avoid pt=0
+    float eta = asinh(pz / sqrt(px * px + py * py));
+    if (eta < eta_min) continue;
+    if (eta > eta_max) continue;
+
+    JetInputParticle particle;
+    particle.px = px;
+    particle.py = py;
+    particle.pz = pz;
+    particle.e = part->get_e();
+    particle.src = Jet::PARTICLE;
+    particle.index = part->get_track_id();
+    particles.push_back(particle);
   }
-
-  if (Verbosity() > 0) std::cout << "TruthJetInput::process_event -- exited" << std::endl;
-
-  return pseudojets;
 }
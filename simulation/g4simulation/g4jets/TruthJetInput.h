@@ -5,9 +5,11 @@
 #include <jetbase/Jet.h>
 
 #include <iostream>  // for cout, ostream
+#include <string>
 #include <vector>
 
 class PHCompositeNode;
+class PHG4TruthInfoContainer;
 
 class TruthJetInput : public JetInput
 {
@@ -30,12 +32,25 @@ class TruthJetInput : public JetInput
 
   std::vector<Jet*> get_input(PHCompositeNode* topNode) override;
 
+  void get_input_particles(PHCompositeNode* topNode, std::vector<JetInputParticle>& particles) override;
+
   void set_eta_range(float eta_min, float eta_max)
   {
     m_EtaMin = eta_min;
     m_EtaMax = eta_max;
   }
 
+  //! read the particles selected once per event by TruthJetParticleMaker
+  //! from this node instead of G4TruthInfo. The embed stream and eta
+  //! selection of the TruthJetParticleMaker apply, not the ones set here
+  void set_particle_node(const std::string& name) { m_ParticleNode = name; }
+
+  //! the truth jet particle selection, shared with TruthJetParticleMaker
+  static void select_particles(PHG4TruthInfoContainer* truthinfo,
+                               const std::vector<int>& embed_ids,
+                               float eta_min, float eta_max,
+                               std::vector<JetInputParticle>& particles);
+
  private:
   Jet::SRC m_Input = Jet::VOID;
   float m_EtaMin = -4.;
@@ -46,6 +61,9 @@ class TruthJetInput : public JetInput
   std::vector<int> m_EmbedID;
 
   bool use_embed_stream() { return m_EmbedID.size() > 0; }
+
+  //! if non-empty: TruthJetParticles node to read the particles from
+  std::string m_ParticleNode;
 };
 
 #endif
@@ -0,0 +1,94 @@
+#include "TruthJetParticleMaker.h"
+
+#include "TruthJetInput.h"
+#include "TruthJetParticles.h"
+
+#include <g4main/PHG4TruthInfoContainer.h>
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/SubsysReco.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHDataNode.h>
+#include <phool/PHNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/getClass.h>
+#include <phool/phool.h>  // for PHWHERE
+
+// standard includes
+#include <iostream>
+
+TruthJetParticleMaker::TruthJetParticleMaker(const std::string &name)
+  : SubsysReco(name)
+{
+}
+
+int TruthJetParticleMaker::InitRun(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 0)
+  {
+    std::cout << "TruthJetParticleMaker::InitRun: " << m_EtaMin << " < eta < " << m_EtaMax;
+    if (!m_EmbedID.empty())
+    {
+      std::cout << ", embedded streams: ";
+      for (int it : m_EmbedID)
+      {
+        std::cout << it << ", ";
+      }
+    }
+    std::cout << " -> " << m_OutputNode << std::endl;
+  }
+
+  return CreateNode(topNode);
+}
+
+int TruthJetParticleMaker::process_event(PHCompositeNode *topNode)
+{
+  TruthJetParticles *particles = findNode::getClass<TruthJetParticles>(topNode, m_OutputNode);
+  if (!particles)
+  {
+    std::cout << PHWHERE << " ERROR: Can't find " << m_OutputNode << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+  particles->Reset();
+
+  PHG4TruthInfoContainer *truthinfo = findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
+  if (!truthinfo)
+  {
+    std::cout << PHWHERE << " ERROR: Can't find G4TruthInfo" << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+
+  TruthJetInput::select_particles(truthinfo, m_EmbedID, m_EtaMin, m_EtaMax, particles->get_particles());
+
+  if (Verbosity() > 1)
+  {
+    std::cout << "TruthJetParticleMaker::process_event: " << particles->get_particles().size() << " truth particles" << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int TruthJetParticleMaker::CreateNode(PHCompositeNode *topNode)
+{
+  PHNodeIterator iter(topNode);
+
+  // Looking for the DST node
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  if (!dstNode)
+  {
+    std::cout << PHWHERE << "DST Node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  TruthJetParticles *particles = findNode::getClass<TruthJetParticles>(topNode, m_OutputNode);
+  if (!particles)
+  {
+    particles = new TruthJetParticles();
+    // transient, the list is rebuilt from G4TruthInfo every event
+    PHDataNode<TruthJetParticles> *particleNode = new PHDataNode<TruthJetParticles>(particles, m_OutputNode);
+    dstNode->addNode(particleNode);
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
@@ -0,0 +1,69 @@
+#ifndef G4JET_TRUTHJETPARTICLEMAKER_H
+#define G4JET_TRUTHJETPARTICLEMAKER_H
+
+#include <fun4all/SubsysReco.h>
+
+#include <string>
+#include <vector>
+
+class PHCompositeNode;
+
+/*!
+ * \brief fills the shared TruthJetParticles node once per event
+ *
+ * Applies the TruthJetInput particle selection (embed streams, eta range,
+ * no muons, taus or neutrinos) to the G4TruthInfo primaries once and stores
+ * the result as flat 4-vectors. Truth JetReco's consume it through
+ * TruthJetInput::set_particle_node():
+ *
+ * \code{.cpp}
+
+    TruthJetParticleMaker *truthparticles = new TruthJetParticleMaker();
+    truthparticles->add_embedding_flag(1);
+    se->registerSubsystem(truthparticles);
+
+    for (float R : {0.2, 0.3, 0.4, 0.5, 0.6})
+    {
+      TruthJetInput *tji = new TruthJetInput(Jet::PARTICLE);
+      tji->set_particle_node("TruthJetParticles");
+      JetReco *truthjetreco = new JetReco();
+      truthjetreco->add_input(tji);
+      ...
+    }
+
+ * \endcode
+ */
+class TruthJetParticleMaker : public SubsysReco
+{
+ public:
+  TruthJetParticleMaker(const std::string& name = "TruthJetParticleMaker");
+  ~TruthJetParticleMaker() override {}
+
+  int InitRun(PHCompositeNode* topNode) override;
+  int process_event(PHCompositeNode* topNode) override;
+
+  //! same as TruthJetInput::add_embedding_flag()
+  void add_embedding_flag(const int embed_stream_id)
+  {
+    m_EmbedID.push_back(embed_stream_id);
+  }
+
+  void set_eta_range(float eta_min, float eta_max)
+  {
+    m_EtaMin = eta_min;
+    m_EtaMax = eta_max;
+  }
+
+  void set_output_node(const std::string& name) { m_OutputNode = name; }
+
+ private:
+  int CreateNode(PHCompositeNode* topNode);
+
+  float m_EtaMin = -4.;
+  float m_EtaMax = 4.;
+  std::vector<int> m_EmbedID;
+
+  std::string m_OutputNode = "TruthJetParticles";
+};
+
+#endif
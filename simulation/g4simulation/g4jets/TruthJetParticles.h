@@ -0,0 +1,33 @@
+#ifndef G4JET_TRUTHJETPARTICLES_H
+#define G4JET_TRUTHJETPARTICLES_H
+
+#include <jetbase/JetInput.h>
+
+#include <vector>
+
+/*!
+ * \brief transient list of the truth jet input particles of one event
+ *
+ * Filled once per event by TruthJetParticleMaker with the selected truth
+ * primaries (embed stream and eta cuts applied) and read by every
+ * TruthJetInput that is pointed to the node with set_particle_node(), so
+ * that several truth JetReco's (e.g. one per jet radius) do not each walk
+ * G4TruthInfo and allocate a Jet per particle.
+ */
+class TruthJetParticles
+{
+ public:
+  TruthJetParticles() = default;
+  ~TruthJetParticles() = default;
+
+  void Reset() { m_Particles.clear(); }
+
+  std::vector<JetInputParticle>& get_particles() { return m_Particles; }
+  const std::vector<JetInputParticle>& get_particles() const { return m_Particles; }
+
+ private:
+  //! capacity is kept event to event
+  std::vector<JetInputParticle> m_Particles;
+};
+
+#endif